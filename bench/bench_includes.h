@@ -0,0 +1,35 @@
+/****************** bench_includes.h ******************************/
+/*
+*  Include files for the kernel benchmarks
+*/
+
+/* Include files */
+#include "../include/config.h"  /* Keep this first */
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+#include "../include/complex.h"
+#include "../include/su3.h"
+#include "lattice.h"
+#include "../include/macros.h"
+#include "../include/comdefs.h"
+#include "../include/io_lat.h"
+#include "../include/generic_ks.h"
+#include "../include/generic.h"
+#include "../include/dirs.h"
+#ifdef OMP
+#include <omp.h>
+#endif
+
+/* prototypes for functions in high level code */
+int setup();
+int readin(int prompt);
+
+/* bench_kernels.c */
+void bench_dslash_fn_field(int nreps);
+void bench_hisq_links(int nreps);
+void bench_fermion_force(int nterms, int nreps);
+void bench_gauge_force(int nreps);
+void bench_gathers(int nreps);
+void bench_save_parallel(char *filename, int nreps);
@@ -0,0 +1,288 @@
+/************************* bench_kernels.c *******************************/
+/* MIMD version 7 */
+
+/* Timed loops over single kernels on the current gauge field.
+
+   Each kernel is called once to warm up and then nreps times.  The
+   time is the maximum over ranks.  Flops and bytes are counted on
+   each rank over the timed calls and summed over ranks, so the rates
+   are for the whole machine.  The byte counts are the compulsory traffic: each
+   input field read once and each output field written once, with no
+   credit for cache reuse, so GB/s is a lower bound on what the
+   memory system delivered.  For the gathers the bytes are those
+   received from other ranks; for save_parallel, those in the file.
+
+   One line per kernel is printed, beginning "BENCH:", with the rank
+   and thread counts, so runs at several counts (see Make_time) can
+   be collected into a scaling table with grep. */
+
+#include "bench_includes.h"
+
+/* Symanzik 1-loop action, as in gauge_force_imp.c */
+#define GAUGE_FORCE_FLOPS 153004
+
+static void
+report(const char *kernel, int nreps, double sec, double flops,
+       double bytes)
+{
+  int threads;
+
+#ifdef OMP
+  threads = omp_get_max_threads();
+#else
+  threads = 1;
+#endif
+
+  g_doublemax(&sec);
+  g_doublesum(&flops);
+  g_doublesum(&bytes);
+  sec /= nreps;
+  flops /= nreps;
+  bytes /= nreps;
+
+  node0_printf("BENCH: %-16s ranks %4d threads %3d sites/rank %8lu sec/call %10.3e",
+	       kernel, numnodes(), threads, (unsigned long)sites_on_node, sec);
+  if(this_node == 0){
+    if(flops > 0)printf(" GFlop/s %8.2f", flops/(1e9*sec));
+    else printf(" GFlop/s %8s", "-");
+    printf(" GB/s %8.2f\n", bytes/(1e9*sec));
+  }
+  fflush(stdout);
+}
+
+/*--------------------------------------------------------------------*/
+/* One application of the fat-Naik Dslash to even sites */
+
+void
+bench_dslash_fn_field(int nreps)
+{
+  imp_ferm_links_t *fn = get_fm_links(fn_links)[0];
+  su3_vector *src = create_v_field();
+  su3_vector *dest = create_v_field();
+  double dtime, flops, bytes;
+  int k;
+
+  grsource_plain_field(src, EVENANDODD);
+  dslash_fn_field(src, dest, EVEN, fn);
+
+  g_sync();
+  dtime = -dclock();
+  for(k = 0; k < nreps; k++)
+    dslash_fn_field(src, dest, EVEN, fn);
+  dtime += dclock();
+
+  /* 16 matrix-vector products and 15 sums per site; 16 fat and long
+     links and 16 neighbor vectors in, one vector out */
+  flops = (double)even_sites_on_node*(66*16 + 6*15);
+  bytes = (double)even_sites_on_node*(16*sizeof(su3_matrix) +
+				       17*sizeof(su3_vector));
+  report("dslash_fn_field", nreps, dtime, flops*nreps, bytes*nreps);
+
+  destroy_v_field(dest);
+  destroy_v_field(src);
+}
+
+/*--------------------------------------------------------------------*/
+/* The HISQ smearing from the gauge links to the fat and long links:
+   load_hisq_aux_links and load_hisq_fn_links as called by
+   create_hisq_links_milc, including the allocation the application
+   pays on each rebuild */
+
+void
+bench_hisq_links(int nreps)
+{
+  ks_action_paths_hisq *ap = get_action_paths_hisq(fn_links);
+  su3_matrix *links = create_G_from_site();
+  fn_links_t *fn[MAX_NAIK];
+  fn_links_t *fn_deps;
+  hisq_auxiliary_t *aux;
+  info_t info = INFO_ZERO;
+  double dtime, flops = 0, bytes;
+  int k;
+#ifdef DBLSTORE_FN
+  int want_back = 1;
+#else
+  int want_back = 0;
+#endif
+
+  create_hisq_links_milc(&info, fn, &fn_deps, &aux, ap, links, 0, want_back);
+  destroy_hisq_links_milc(ap, aux, fn, fn_deps);
+
+  g_sync();
+  dtime = -dclock();
+  for(k = 0; k < nreps; k++){
+    create_hisq_links_milc(&info, fn, &fn_deps, &aux, ap, links, 0, want_back);
+    flops += info.final_flop;
+    destroy_hisq_links_milc(ap, aux, fn, fn_deps);
+  }
+  dtime += dclock();
+
+  /* U, V, Y and W each read and written, W read for the last
+     smearing, and fat and long links written for each Naik term */
+  bytes = (double)sites_on_node*(36 + 8*ap->n_naiks)*sizeof(su3_matrix);
+  report("hisq_links", nreps, dtime, flops, bytes*nreps);
+
+  destroy_G(links);
+}
+
+/*--------------------------------------------------------------------*/
+/* The HISQ fermion force through eo_fermion_force_multi, which calls
+   fn_fermion_force_multi_hisq_mx */
+
+void
+bench_fermion_force(int nterms, int nreps)
+{
+  su3_vector **xxx;
+  Real *residues;
+  Real eps = 0.01;
+  double dtime, flops = 0, bytes;
+  int j, k;
+
+  xxx = (su3_vector **)malloc(nterms*sizeof(su3_vector *));
+  residues = (Real *)malloc(nterms*sizeof(Real));
+  if(xxx == NULL || residues == NULL){
+    printf("bench_fermion_force(%d): no room\n", this_node);
+    terminate(1);
+  }
+  for(j = 0; j < nterms; j++){
+    xxx[j] = create_v_field();
+    grsource_plain_field(xxx[j], EVENANDODD);
+    residues[j] = 1.0/(j+1);
+  }
+
+  eo_fermion_force_multi(eps, residues, xxx, nterms, MILC_PRECISION, fn_links);
+
+  g_sync();
+  dtime = -dclock();
+  for(k = 0; k < nreps; k++){
+    eo_fermion_force_multi(eps, residues, xxx, nterms, MILC_PRECISION,
+			   fn_links);
+    flops += eo_fermion_force_multi_flops();
+  }
+  dtime += dclock();
+
+  /* The sources, the U, V and W links, and the momentum read and
+     written */
+  bytes = (double)sites_on_node*(nterms*sizeof(su3_vector) +
+				 12*sizeof(su3_matrix) +
+				 8*sizeof(anti_hermitmat));
+  report("fermion_force", nreps, dtime, flops, bytes*nreps);
+
+  for(j = 0; j < nterms; j++)
+    destroy_v_field(xxx[j]);
+  free(residues);
+  free(xxx);
+}
+
+/*--------------------------------------------------------------------*/
+/* The improved gauge force */
+
+void
+bench_gauge_force(int nreps)
+{
+  Real eps = 0.01;
+  double dtime, flops, bytes;
+  int i, k;
+  site *s;
+
+  FORALLSITES(i,s){
+    memset(s->mom, 0, 4*sizeof(anti_hermitmat));
+  }
+
+  imp_gauge_force_cpu(eps, F_OFFSET(mom));
+
+  g_sync();
+  dtime = -dclock();
+  for(k = 0; k < nreps; k++)
+    imp_gauge_force_cpu(eps, F_OFFSET(mom));
+  dtime += dclock();
+
+  /* The links, and the momentum read and written */
+  flops = (double)sites_on_node*GAUGE_FORCE_FLOPS;
+  bytes = (double)sites_on_node*(4*sizeof(su3_matrix) +
+				 8*sizeof(anti_hermitmat));
+  report("gauge_force", nreps, dtime, flops*nreps, bytes*nreps);
+}
+
+/*--------------------------------------------------------------------*/
+/* The one- and three-link gathers of a color vector field in all
+   eight directions, restarted from their first msg_tags as the
+   Dslash does */
+
+void
+bench_gathers(int nreps)
+{
+  su3_vector *v = create_v_field();
+  msg_tag *tag[16];
+  double dtime, bytes;
+  char *lo = (char *)v, *hi = (char *)(v + sites_on_node);
+  int dir, i, k;
+
+  grsource_plain_field(v, EVENANDODD);
+
+  for(dir = XUP; dir < NDIRS; dir++){
+    tag[dir] = start_gather_field(v, sizeof(su3_vector), dir,
+				  EVENANDODD, gen_pt[dir]);
+    tag[dir+8] = start_gather_field(v, sizeof(su3_vector), DIR3(dir),
+				    EVENANDODD, gen_pt[dir+8]);
+  }
+  for(dir = 0; dir < 16; dir++)
+    wait_gather(tag[dir]);
+
+  /* Neighbors not in this rank's field came from another rank */
+  bytes = 0;
+  for(dir = 0; dir < 16; dir++)
+    FORALLFIELDSITES(i){
+      if(gen_pt[dir][i] < lo || gen_pt[dir][i] >= hi)
+	bytes += sizeof(su3_vector);
+    }
+
+  g_sync();
+  dtime = -dclock();
+  for(k = 0; k < nreps; k++){
+    for(dir = XUP; dir < NDIRS; dir++){
+      restart_gather_field(v, sizeof(su3_vector), dir, EVENANDODD,
+			   gen_pt[dir], tag[dir]);
+      restart_gather_field(v, sizeof(su3_vector), DIR3(dir), EVENANDODD,
+			   gen_pt[dir+8], tag[dir+8]);
+    }
+    for(dir = 0; dir < 16; dir++)
+      wait_gather(tag[dir]);
+  }
+  dtime += dclock();
+
+  report("gathers", nreps, dtime, 0, bytes*nreps);
+
+  for(dir = 0; dir < 16; dir++)
+    cleanup_gather(tag[dir]);
+  destroy_v_field(v);
+}
+
+/*--------------------------------------------------------------------*/
+/* Writing the gauge field with save_parallel */
+
+void
+bench_save_parallel(char *filename, int nreps)
+{
+  gauge_file *gf;
+  double dtime, bytes;
+  int k;
+
+  /* The file holds the links without the KS phases */
+  rephase( OFF );
+  d_plaquette(&g_ssplaq,&g_stplaq);
+  d_linktrsum(&linktrsum);
+  nersc_checksum = nersc_cksum();
+
+  g_sync();
+  dtime = -dclock();
+  for(k = 0; k < nreps; k++){
+    gf = save_parallel(filename);
+    free_output_gauge_file(gf);
+  }
+  dtime += dclock();
+  rephase( ON );
+
+  bytes = (double)sites_on_node*4*sizeof(fsu3_matrix);
+  report("save_parallel", nreps, dtime, 0, bytes*nreps);
+}
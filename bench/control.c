@@ -0,0 +1,46 @@
+/************************* control.c *******************************/
+/* MIMD version 7 */
+/* Main procedure for the kernel benchmarks with the HISQ action */
+
+/* Times the fat-Naik Dslash, the HISQ link smearing, the HISQ
+   fermion force, the improved gauge force, the one- and three-link
+   gathers and the parallel lattice writer on the starting gauge
+   field.  A "warm" start gives a random gauge field, so no input
+   lattice is needed. */
+
+#define CONTROL
+#include "bench_includes.h"	/* definitions files and prototypes */
+
+int main( int argc, char **argv ){
+  int prompt;
+  
+  initialize_machine(&argc,&argv);
+
+  /* Remap standard I/O if needed */
+  if(remap_stdio_from_args(argc, argv) == 1)terminate(1);
+  
+  g_sync();
+  /* set up */
+  prompt = setup();
+
+  /* loop over input sets */
+  while( readin(prompt) == 0){
+    
+    if(prompt == 2)continue;
+    
+    node0_printf("BEGIN\n");
+
+    bench_dslash_fn_field(nreps);
+    bench_hisq_links(nreps);
+    bench_fermion_force(nterms, nreps);
+    bench_gauge_force(nreps);
+    bench_gathers(nreps);
+    if( saveflag == SAVE_PARALLEL )
+      bench_save_parallel(savefile, nreps);
+    
+  }
+  node0_printf("RUNNING COMPLETED\n");
+
+  normal_exit(0);
+  return 0;
+}
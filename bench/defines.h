@@ -0,0 +1,8 @@
+#ifndef _DEFINES_H
+#define _DEFINES_H
+
+/* Compiler macros common to all targets in this application */
+
+#define SITERAND	/* Use site-based random number generators */
+
+#endif /* _DEFINES_H */
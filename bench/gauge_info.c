@@ -0,0 +1,50 @@
+/*********************** gauge_info.c *************************/
+/* MIMD version 7 */
+
+/* For bench */
+
+/* Application-dependent routine for writing gauge info file */
+/* This file is an ASCII companion to the gauge configuration file
+   and contains information about the action used to generate it.
+   This information is consistently written in the pattern
+
+       keyword  value
+
+   or
+
+       keyword[n] value1 value2 ... valuen
+
+   where n is an integer.
+
+   To maintain a semblance of consistency, the possible keywords are
+   listed in io_lat.h.  Add more as the need arises, but be sure
+   to notify the rest of the collaboration.
+
+   */
+
+#include "bench_includes.h"
+
+/*---------------------------------------------------------------------------*/
+/* This routine writes the ASCII info file.  It is called from one of
+   the lattice output routines in io_lat4.c.*/
+
+void write_appl_gauge_info(FILE *fp, gauge_file *gf)
+{
+  char sums[20];
+
+  /* Write generic information */
+  write_generic_gauge_info(fp, gf);
+
+  /* The rest are optional */
+  if(startlat_p != NULL)
+    {
+      /* To retain some info about the original (or previous)
+	 configuration */
+      write_gauge_info_item(fp,"gauge.previous.filename","\"%s\"",
+                             startlat_p->filename,0,0);
+      write_gauge_info_item(fp,"gauge.previous.time_stamp","\"%s\"",
+                             startlat_p->header->time_stamp,0,0);
+      sprintf(sums,"%x %x",startlat_p->check.sum29,startlat_p->check.sum31);
+      write_gauge_info_item(fp,"gauge.previous.checksums","\"%s\"",sums,0,0);
+    }
+}
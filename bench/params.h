@@ -0,0 +1,39 @@
+#ifndef _PARAMS_H
+#define _PARAMS_H
+
+#include "../include/macros.h"  /* For MAXFILENAME */
+#include "defines.h"
+#include "../include/imp_ferm_links.h"
+
+/* structure for passing simulation parameters to each node */
+typedef struct {
+  int stopflag;   /* 1 if it is time to stop */
+  /* INITIALIZATION PARAMETERS */
+  int nx,ny,nz,nt;  /* lattice dimensions */
+#ifdef FIX_NODE_GEOM
+  int node_geometry[4];  /* Specifies fixed "nsquares" (i.e. 4D
+			    hypercubes) for the compute nodes in each
+			    coordinate direction.  Must be divisors of
+			    the lattice dimension */
+#ifdef FIX_IONODE_GEOM
+  int ionode_geometry[4]; /* Specifies fixed "nsquares" for I/O
+			     partitions in each coordinate direction,
+			     one I/O node for each square.  The I/O
+			     node is at the origin of the square.
+			     Must be divisors of the node_geometry. */
+#endif
+#endif
+  int iseed;	/* for random numbers */
+  /*  REPEATING BLOCK */
+  Real u0;      /* tadpole parameter */
+  Real beta;    /* gauge coupling, scales the gauge force */
+  int nterms;   /* number of sources for the fermion force */
+  int nreps;    /* timed calls of each kernel */
+  int startflag;  /* what to do for beginning lattice */
+  int saveflag;   /* save_parallel to benchmark the writer, or forget */
+  char startfile[MAXFILENAME],savefile[MAXFILENAME];
+  /* Eigenparameters (not used) */
+  ks_eigen_param eigen_param; /* Parameters for eigensolver */
+}  params;
+
+#endif /* _PARAMS_H */
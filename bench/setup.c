@@ -0,0 +1,263 @@
+/************************ setup.c ****************************/
+/* MIMD version 7 */
+/* Setup routines for the kernel benchmarks.  Adapted from
+   ks_imp_utilities/setup.c */
+
+#define IF_OK if(status==0)
+
+#include "bench_includes.h"	/* definitions files and prototypes */
+
+/* Forward declarations */
+
+int initial_set();
+void third_neighbor(int, int, int, int, int *, int, int *, int *, int *, int *);
+void make_3n_gathers();
+
+int
+setup()
+{
+  int prompt;
+
+  /* print banner, get volume, seed */
+  prompt = initial_set();
+  if(prompt == 2)return prompt;
+  /* Initialize the layout functions, which decide where sites live */
+  setup_layout();
+  this_node = mynode();
+  /* initialize the node random number generator */
+  initialize_prn( &node_prn, iseed, volume+mynode() );
+  /* allocate space for lattice, set up coordinate fields */
+  make_lattice();
+  node0_printf("Made lattice\n"); fflush(stdout);
+  /* set up neighbor pointers and comlink structures
+     code for this routine is in com_machine.c  */
+  make_nn_gathers();
+  node0_printf("Made nn gathers\n"); fflush(stdout);
+  /* set up 3rd nearest neighbor pointers and comlink structures
+     code for this routine is below  */
+  make_3n_gathers();
+  node0_printf("Made 3nn gathers\n"); fflush(stdout);
+  /* set up K-S phase vectors, boundary conditions */
+  phaseset();
+  /* set up loop tables for the gauge force */
+  n_dyn_masses = 0;
+  make_loop_table();
+
+  node0_printf("Finished setup\n"); fflush(stdout);
+  return( prompt );
+}
+
+static int n_naiks = 1;
+static double eps_naik[MAX_NAIK];
+
+/* SETUP ROUTINES */
+int
+initial_set()
+{
+  int prompt=0,status;
+#ifdef FIX_NODE_GEOM
+  int i;
+#endif
+  /* On node zero, read lattice size, seed and send to others */
+  if(mynode()==0){
+    /* print banner */
+    printf("SU3 with improved KS action\n");
+    printf("Kernel benchmarks\n");
+    printf("MIMD version 7\n");
+    printf("Machine = %s, with %d nodes\n",machine_type(),numnodes());
+
+    status=get_prompt(stdin, &prompt);
+    IF_OK status += get_i(stdin, prompt,"nx", &param.nx );
+    IF_OK status += get_i(stdin, prompt,"ny", &param.ny );
+    IF_OK status += get_i(stdin, prompt,"nz", &param.nz );
+    IF_OK status += get_i(stdin, prompt,"nt", &param.nt );
+#ifdef FIX_NODE_GEOM
+    IF_OK status += get_vi(stdin, prompt, "node_geometry", 
+			   param.node_geometry, 4);
+#ifdef FIX_IONODE_GEOM
+    IF_OK status += get_vi(stdin, prompt, "ionode_geometry", 
+			   param.ionode_geometry, 4);
+#endif
+#endif
+    IF_OK status += get_i(stdin, prompt,"iseed", &param.iseed );
+
+    if(status>0) param.stopflag=1; else param.stopflag=0;
+  } /* end if(mynode()==0) */
+
+  /* Node 0 broadcasts parameter buffer to all other nodes */
+  broadcast_bytes((char *)&param,sizeof(param));
+
+  if( param.stopflag != 0 )
+    normal_exit(0);
+
+  if(prompt==2)return prompt;
+
+  nx=param.nx;
+  ny=param.ny;
+  nz=param.nz;
+  nt=param.nt;
+  iseed=param.iseed;
+
+#ifdef FIX_NODE_GEOM
+  for(i = 0; i < 4; i++)
+    node_geometry[i] = param.node_geometry[i];
+#ifdef FIX_IONODE_GEOM
+  for(i = 0; i < 4; i++)
+    ionode_geometry[i] = param.ionode_geometry[i];
+#endif
+#endif
+
+  number_of_nodes = numnodes();
+  volume=(size_t)nx*ny*nz*nt;
+#ifdef HISQ_SVD_COUNTER
+  hisq_svd_counter = 0;
+#endif
+      
+#ifdef HISQ_FORCE_FILTER_COUNTER
+  hisq_force_filter_counter = 0;
+#endif
+
+  return(prompt);
+}
+
+/* read in parameters and coupling constants	*/
+int
+readin(int prompt)
+{
+  /* argument "prompt" is 1 if prompts are to be given for input	*/
+
+  int status;
+
+  /* On node zero, read parameters and send to all other nodes */
+  if(this_node==0) {
+
+    printf("\n\n");
+    status=0;
+
+    /* find out what kind of starting lattice to use.  "warm" gives
+       a random gauge field */
+    IF_OK status += ask_starting_lattice(stdin,  prompt, &(param.startflag),
+					  param.startfile );
+
+    IF_OK status += get_f(stdin, prompt,"u0", &param.u0 );
+    IF_OK status += get_f(stdin, prompt,"beta", &param.beta );
+
+    /* number of sources for the fermion force */
+    IF_OK status += get_i(stdin, prompt,"number_of_force_terms", 
+			  &param.nterms );
+    IF_OK if(param.nterms < 1){
+      printf("number_of_force_terms must be positive\n");
+      status++;
+    }
+
+    /* timed calls of each kernel */
+    IF_OK status += get_i(stdin, prompt,"repeats", &param.nreps );
+    IF_OK if(param.nreps < 1){
+      printf("repeats must be positive\n");
+      status++;
+    }
+
+    /* 'save_parallel file' also times the parallel lattice writer */
+    IF_OK status += ask_ending_lattice(stdin,  prompt, &(param.saveflag),
+					param.savefile );
+    IF_OK if(param.saveflag != FORGET && param.saveflag != SAVE_PARALLEL){
+      printf("Only save_parallel or forget is benchmarked\n");
+      status++;
+    }
+
+    if( status > 0)param.stopflag=1; else param.stopflag=0;
+  } /* end if(this_node==0) */
+
+  /* Node 0 broadcasts parameter buffer to all other nodes */
+  broadcast_bytes((char *)&param,sizeof(param));
+
+  if( param.stopflag != 0 )
+    normal_exit(0);
+
+  if(prompt==2)return 0;
+
+  u0 = param.u0;
+  beta = param.beta;
+  nterms = param.nterms;
+  nreps = param.nreps;
+  startflag = param.startflag;
+  saveflag = param.saveflag;
+  strcpy(startfile,param.startfile);
+  strcpy(savefile,param.savefile);
+
+  /* A single Naik term with zero epsilon */
+  eps_naik[0] = 0.0;
+  n_order_naik_total = nterms;
+  n_orders_naik[0] = nterms;
+
+  /* Do whatever is needed to get lattice */
+  if( startflag == CONTINUE ){
+    rephase( OFF );
+  }
+  if( startflag != CONTINUE )
+    startlat_p = reload_lattice( startflag, startfile );
+
+  /* if a lattice was read in, put in KS phases and AP boundary condition */
+  phases_in = OFF;
+  rephase( ON );
+
+#ifdef DBLSTORE_FN
+  /* We want to double-store the links for optimization */
+  fermion_links_want_back(1);
+#endif
+
+  /* The fermion force needs the HISQ auxiliary links, which are kept
+     by default */
+  if(fn_links != NULL)destroy_fermion_links_hisq(fn_links);
+  fn_links = create_fermion_links_from_site(MILC_PRECISION, n_naiks, eps_naik);
+
+  return(0);
+}
+
+/* Set up comlink structures for 3rd nearest gather pattern;
+   make_lattice() and  make_nn_gathers() must be called first,
+   preferably just before calling make_3n_gathers().
+*/
+void
+make_3n_gathers()
+{
+  int i;
+
+  for(i=XUP; i<=TUP; i++) {
+    make_gather(third_neighbor, &i, WANT_INVERSE,
+		ALLOW_EVEN_ODD, SWITCH_PARITY);
+  }
+
+  /* Sort into the order we want for nearest neighbor gathers,
+     so you can use X3UP, X3DOWN, etc. as argument in calling them. */
+
+  sort_eight_gathers(X3UP);
+
+}
+
+
+/* this routine uses only fundamental directions (XUP..TDOWN) as directions */
+/* returning the coords of the 3rd nearest neighbor in that direction */
+
+void
+third_neighbor(int x, int y, int z, int t, int *dirpt, int FB,
+	       int *xp, int *yp, int *zp, int *tp)
+     /* int x,y,z,t,*dirpt,FB;  coordinates of site, direction (eg XUP), and
+	"forwards/backwards"  */
+     /* int *xp,*yp,*zp,*tp;    pointers to coordinates of neighbor */
+{
+  int dir;
+  dir = (FB==FORWARDS) ? *dirpt : OPP_DIR(*dirpt);
+  *xp = x; *yp = y; *zp = z; *tp = t;
+  switch(dir){
+  case XUP: *xp = (x+3)%nx; break;
+  case XDOWN: *xp = (x+4*nx-3)%nx; break;
+  case YUP: *yp = (y+3)%ny; break;
+  case YDOWN: *yp = (y+4*ny-3)%ny; break;
+  case ZUP: *zp = (z+3)%nz; break;
+  case ZDOWN: *zp = (z+4*nz-3)%nz; break;
+  case TUP: *tp = (t+3)%nt; break;
+  case TDOWN: *tp = (t+4*nt-3)%nt; break;
+  default: printf("third_neighb: bad direction\n"); exit(1);
+  }
+}
@@ -38,7 +38,7 @@ Real check_unitarity() {
 #else
     for(dir=XUP; dir<=TUP; dir++ ){
 #endif
-      mat = (su3_matrix *)&(s->link[dir]);
+      mat = (su3_matrix *)&(SITE_LINK(i)[dir]);
       deviation=check_su3( mat );
       if (deviation>TOLERANCE){
 	printf("Unitarity problem on node %d, site %d, dir %d, deviation=%f\n",
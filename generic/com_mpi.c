@@ -32,6 +32,7 @@
    machine_type()        returns string describing communications architecture
    mynode()              returns node number of this node.
    numnodes()            returns number of nodes
+   pes_per_node()        returns number of ranks sharing a physical node
    myjobid()             returns the jobid of this node.
    numjobs()             returns number of jobs
    g_sync()              provides a synchronization point for all nodes.
@@ -39,6 +40,8 @@
    g_vecfloatsum()       sums a vector of generic floats over all nodes 
    g_doublesum()         sums a double over all nodes.
    g_vecdoublesum()      sums a vector of doubles over all nodes.
+   start_g_vecdoublesum() starts a nonblocking sum of a vector of doubles.
+   wait_g_vecdoublesum() waits for the sum to complete.
    g_longdoublesum()     sums a long double over all nodes.
    g_veclongdoublesum()  sums a vector of long doubles over all nodes.
    g_complexsum()        sums a generic precision complex number over all nodes.
@@ -81,6 +84,7 @@
                            data has actually arrived.
    cleanup_gather()      frees all the buffers that were allocated, WHICH
                            MEANS THAT THE GATHERED DATA MAY SOON DISAPPEAR.
+                           Does nothing for a NULL tag.
    accumulate_gather()   combines gathers into single message tag
    declare_accumulate_gather_site()  does declare_gather_site() and 
                                   accumulate_gather() in single step.
@@ -134,6 +138,15 @@
 /* macro to compute the message id */
 #define GATHER_ID(x) (GATHER_BASE_ID+(x))
 
+/* The shared-memory transport for on-node gathers needs MPI-3 */
+#if defined(COM_MPI_SHM_TRANSPORT) && MPI_VERSION >= 3
+#define USE_SHM_TRANSPORT
+#ifndef COM_MPI_SHM_TRANSPORT_MBYTES
+#define COM_MPI_SHM_TRANSPORT_MBYTES 16
+#endif
+#define SHM_ALIGN 64
+#endif
+
 /* If we want to do our own checksums */
 #ifdef COM_CRC
 u_int32type crc32(u_int32type crc, const unsigned char *buf, size_t len);
@@ -224,6 +237,8 @@ typedef struct {
   char *msg_buf;        /* address of buffer malloc'd for message */
   gmem_t *gmem;         /* linked list explaining detailed usage for buffer */
   MPI_Request msg_req;  /* message handle returned by system call */
+  int shm;              /* 1 if msg_buf is in the shared-memory window */
+  MPI_Request rel_req;  /* buffer release message (shm only) */
 } msg_sr_t;
 
 /* structure to store declared gathers
@@ -240,6 +255,9 @@ struct msg_tag {
   int nsends;        /* number of messages to send in gather */
   msg_sr_t *recv_msgs;  /* array of messages to receive */
   msg_sr_t *send_msgs;  /* array of messages to send */
+  MPI_Request *reqs;    /* persistent requests, receives then sends,
+			   made by prepare_gather (gathers only) */
+  int ngathers;         /* number of times do_gather was called */
 };
 
 
@@ -258,6 +276,28 @@ static int num_gather_ids;  /* number of id offsets allowed */
 /* keep track of used ids */
 static int *id_array;
 
+#ifdef USE_SHM_TRANSPORT
+/* Shared-memory transport for gathers between ranks on the same node
+   (COM_MPI_SHM_TRANSPORT).  Each rank owns a staging segment of a
+   shared-memory window, and send buffers for on-node peers are carved
+   from it.  The sender still packs the face into its buffer; the
+   receiver's pointers then point into that buffer, so the packed data
+   skips the MPI transfer and the receive buffer.  This is not zero
+   copy: the fields themselves stay in private memory, and gen_pt
+   never points into the neighbor's field.  A zero-byte message on
+   MPI_COMM_THISJOB tells the receiver that the data is ready, and one
+   on shm_rel_comm tells the sender that the receiver is done with it. */
+typedef struct shm_block {
+  size_t off, len;          /* free range of our segment */
+  struct shm_block *next;   /* sorted by offset */
+} shm_block;
+
+static MPI_Win shm_win = MPI_WIN_NULL;
+static MPI_Comm shm_rel_comm;
+static char **shm_base = NULL;  /* segment of each rank, NULL if off node */
+static shm_block *shm_free = NULL;
+#endif
+
 /* array storing gather setup info */
 static gather_t *gather_array;
 
@@ -456,6 +496,9 @@ initialize_machine(int *argc, char ***argv)
 
 #ifdef HAVE_GRID
   required = MPI_THREAD_MULTIPLE;
+#elif defined(OMP)
+  /* Threaded site loops, MPI calls from the master thread only */
+  required = MPI_THREAD_FUNNELED;
 #else
   required = MPI_THREAD_SINGLE;
 #endif
@@ -573,18 +616,14 @@ initialize_machine(int *argc, char ***argv)
 
   /* Set error handler for this job */
 
-  /* Note: with MPI-2 MPI_Comm_create_errhandler and
-     MPI_Comm_set_errorhandler are preferred, but we keep MPI_Attr_get
-     until MPI-2 is more widely available */ 
-  flag = MPI_Errhandler_create(err_func, &errhandler);
+  /* MPI_Errhandler_create and MPI_Errhandler_set were removed in MPI-3 */
+  flag = MPI_Comm_create_errhandler(err_func, &errhandler);
   if(flag != MPI_SUCCESS) err_func(&MPI_COMM_THISJOB, &flag);
-  flag = MPI_Errhandler_set(MPI_COMM_THISJOB, errhandler);
+  flag = MPI_Comm_set_errhandler(MPI_COMM_THISJOB, errhandler);
   if(flag != MPI_SUCCESS) err_func(&MPI_COMM_THISJOB, &flag);
 
   /* get the number of message types */
-  /* Note: with MPI-2 MPI_Comm_get_attr is preferred,
-     but we keep MPI_Attr_get until MPI-2 is more widely available */ 
-  flag = MPI_Attr_get(MPI_COMM_THISJOB, MPI_TAG_UB, &tag_ub, &found);
+  flag = MPI_Comm_get_attr(MPI_COMM_THISJOB, MPI_TAG_UB, &tag_ub, &found);
   if(flag != MPI_SUCCESS) err_func(&MPI_COMM_THISJOB, &flag);
   if(found == 0){
     num_gather_ids = 1024;
@@ -628,7 +667,22 @@ normal_exit(int status)
 {
   time_stamp("exit");
   // g_sync();
+#ifdef FIELD_POOL
+  report_field_pool();
+#endif
+#ifdef MEM_ACCOUNT
+  report_mem_account();
+#endif
+#ifdef PERF_REGIONS
+  report_perf_regions();
+#endif
   MPI_Barrier( MPI_COMM_WORLD );  // wait for all lattices to finish?
+#ifdef USE_SHM_TRANSPORT
+  if(shm_win != MPI_WIN_NULL){
+    MPI_Win_unlock_all(shm_win);
+    MPI_Win_free(&shm_win);
+  }
+#endif
   MPI_Finalize();
   fflush(stdout);
   exit(status);
@@ -714,6 +768,43 @@ numnodes(void)
   return(nodes);
 }
 
+/*
+**  Return the number of ranks on each physical (shared-memory) node,
+**  provided every node holds the same number of consecutively numbered
+**  ranks.  Otherwise return 1: nothing is known about locality.
+*/
+int
+pes_per_node(void)
+{
+#if MPI_VERSION >= 3
+  static int ppn = 0;
+  MPI_Comm node_comm;
+  int nnode, node_rank, leader, me, v[3], vmin[3];
+
+  if(ppn > 0) return ppn;
+
+  me = mynode();
+  MPI_Comm_split_type(MPI_COMM_THISJOB, MPI_COMM_TYPE_SHARED, me,
+		      MPI_INFO_NULL, &node_comm);
+  MPI_Comm_size(node_comm, &nnode);
+  MPI_Comm_rank(node_comm, &node_rank);
+  MPI_Allreduce(&me, &leader, 1, MPI_INT, MPI_MIN, node_comm);
+  MPI_Comm_free(&node_comm);
+
+  /* Same size everywhere, and ranks numbered consecutively within a node */
+  v[0] = nnode;
+  v[1] = -nnode;
+  v[2] = (leader + node_rank == me && leader % nnode == 0);
+  MPI_Allreduce(v, vmin, 3, MPI_INT, MPI_MIN, MPI_COMM_THISJOB);
+  if(vmin[0] == -vmin[1] && vmin[2] == 1) ppn = nnode;
+  else ppn = 1;
+
+  return ppn;
+#else
+  return 1;
+#endif
+}
+
 /*
 ** Return the allocated dimensions (node geometry) if a grid is being used
 */
@@ -848,6 +939,48 @@ g_vecdoublesum(double *dpt, int ndoubles)
   free(work);
 }
 
+/*
+**  Start summing a vector of doubles over all nodes.  The sum is done
+**  in place and dpt must not be touched until wait_g_vecdoublesum.
+**  Other communication may proceed in the meantime.
+*/
+struct sum_tag {
+  MPI_Request req;
+};
+
+sum_tag *
+start_g_vecdoublesum(double *dpt, int ndoubles)
+{
+  sum_tag *stag = (sum_tag *)malloc(sizeof(sum_tag));
+  if(stag == NULL){
+    printf("start_g_vecdoublesum(%d): no room for sum_tag\n", mynode());
+    terminate(1);
+  }
+#if MPI_VERSION >= 3
+  MPI_Iallreduce( MPI_IN_PLACE, dpt, ndoubles, MPI_DOUBLE, MPI_SUM,
+		  MPI_COMM_THISJOB, &stag->req );
+#else
+  MPI_Allreduce( MPI_IN_PLACE, dpt, ndoubles, MPI_DOUBLE, MPI_SUM,
+		 MPI_COMM_THISJOB );
+  stag->req = MPI_REQUEST_NULL;
+#endif
+  return stag;
+}
+
+/*
+**  Wait for a sum started by start_g_vecdoublesum and free the tag
+*/
+void
+wait_g_vecdoublesum(sum_tag *stag)
+{
+  MPI_Status status;
+  int flag;
+
+  flag = MPI_Wait( &stag->req, &status );
+  if(flag != MPI_SUCCESS) err_func(&MPI_COMM_THISJOB, &flag);
+  free(stag);
+}
+
 /*
 **  Sum long double over all nodes
 */
@@ -1165,6 +1298,181 @@ neighbor_coords_special(
   }
 }
 
+#ifdef USE_SHM_TRANSPORT
+/*
+**  Allocate the staging window for the on-node shm transport
+*/
+static void
+setup_shm_transport(void)
+{
+  MPI_Comm node_comm;
+  MPI_Group job_group, node_group;
+  MPI_Info info;
+  MPI_Aint seg_size;
+  int i, nnode, disp_unit, *node_ranks, *job_ranks;
+  char *mybase;
+
+  if(shm_win != MPI_WIN_NULL) return;
+
+  MPI_Comm_split_type(MPI_COMM_THISJOB, MPI_COMM_TYPE_SHARED, mynode(),
+		      MPI_INFO_NULL, &node_comm);
+  MPI_Comm_size(node_comm, &nnode);
+
+  /* Let each segment be placed near its owner */
+  MPI_Info_create(&info);
+  MPI_Info_set(info, "alloc_shared_noncontig", "true");
+  seg_size = (MPI_Aint)COM_MPI_SHM_TRANSPORT_MBYTES*1024*1024;
+  MPI_Win_allocate_shared(seg_size, 1, info, node_comm, &mybase, &shm_win);
+  MPI_Info_free(&info);
+  MPI_Win_lock_all(MPI_MODE_NOCHECK, shm_win);
+  MPI_Comm_dup(MPI_COMM_THISJOB, &shm_rel_comm);
+
+  /* Map node ranks to job ranks and find every on-node segment */
+  shm_base = (char **)malloc(numnodes()*sizeof(char *));
+  node_ranks = (int *)malloc(2*nnode*sizeof(int));
+  if(shm_base==NULL || node_ranks==NULL) {
+    printf("NO ROOM for shm_base, node %d\n", mynode());
+    terminate(1);
+  }
+  job_ranks = node_ranks + nnode;
+  for(i=0; i<numnodes(); i++) shm_base[i] = NULL;
+  for(i=0; i<nnode; i++) node_ranks[i] = i;
+  MPI_Comm_group(node_comm, &node_group);
+  MPI_Comm_group(MPI_COMM_THISJOB, &job_group);
+  MPI_Group_translate_ranks(node_group, nnode, node_ranks, job_group, job_ranks);
+  for(i=0; i<nnode; i++)
+    MPI_Win_shared_query(shm_win, i, &seg_size, &disp_unit,
+			 &shm_base[job_ranks[i]]);
+  MPI_Group_free(&node_group);
+  MPI_Group_free(&job_group);
+  MPI_Comm_free(&node_comm);
+  free(node_ranks);
+
+  shm_free = (shm_block *)malloc(sizeof(shm_block));
+  shm_free->off = 0;
+  shm_free->len = (size_t)COM_MPI_SHM_TRANSPORT_MBYTES*1024*1024;
+  shm_free->next = NULL;
+
+  if(mynode()==0)
+    printf("com_mpi: shm transport for %d ranks on node 0, %d MB staging per rank\n",
+	   nnode, COM_MPI_SHM_TRANSPORT_MBYTES);
+}
+
+/*
+**  first-fit allocation from our segment.  Returns the offset or -1.
+*/
+static long
+shm_alloc(size_t len)
+{
+  shm_block **bp, *b;
+  size_t off;
+
+  len = (len + SHM_ALIGN - 1) & ~(size_t)(SHM_ALIGN - 1);
+  for(bp = &shm_free; *bp != NULL; bp = &(*bp)->next)
+    if((*bp)->len >= len) break;
+  if(*bp == NULL) return -1;
+
+  b = *bp;
+  off = b->off;
+  b->off += len;
+  b->len -= len;
+  if(b->len == 0) {
+    *bp = b->next;
+    free(b);
+  }
+  return (long)off;
+}
+
+/*
+**  return a range to our segment, merging it with its neighbors
+*/
+static void
+shm_release(size_t off, size_t len)
+{
+  shm_block *prev, *next, *b;
+
+  len = (len + SHM_ALIGN - 1) & ~(size_t)(SHM_ALIGN - 1);
+  for(prev = NULL, next = shm_free; next != NULL && next->off < off;
+      prev = next, next = next->next);
+
+  if(prev != NULL && prev->off + prev->len == off) {
+    b = prev;
+    b->len += len;
+  } else {
+    b = (shm_block *)malloc(sizeof(shm_block));
+    if(b == NULL) {
+      printf("NO ROOM for shm_block, node %d\n", mynode());
+      terminate(1);
+    }
+    b->off = off;
+    b->len = len;
+    b->next = next;
+    if(prev == NULL) shm_free = b;
+    else prev->next = b;
+  }
+  if(next != NULL && b->off + b->len == next->off) {
+    b->len += next->len;
+    b->next = next->next;
+    free(next);
+  }
+}
+
+/*
+**  Senders to on-node peers try to place their buffers in the window
+**  and tell the receivers where.  Messages that could not be placed
+**  go through MPI as before.
+*/
+static void
+shm_handshake(msg_tag *mtag)
+{
+  int i, n, nr = mtag->nrecvs, ns = mtag->nsends;
+  long *off;
+  MPI_Request *req;
+  msg_sr_t *mrecv = mtag->recv_msgs, *msend = mtag->send_msgs;
+
+  if(nr+ns == 0) return;
+  off = (long *)malloc((nr+ns)*sizeof(long));
+  req = (MPI_Request *)malloc((nr+ns)*sizeof(MPI_Request));
+  if(off==NULL || req==NULL) {
+    printf("NO ROOM for shm_handshake, node %d\n", mynode());
+    terminate(1);
+  }
+
+  n = 0;
+  for(i=0; i<nr; i++) {
+    mrecv[i].shm = 0;
+    off[i] = -1;
+    if(shm_base[mrecv[i].msg_node] != NULL)
+      MPI_Irecv( &off[i], 1, MPI_LONG, mrecv[i].msg_node,
+		 GATHER_ID(mtag->ids[mrecv[i].id_offset]), shm_rel_comm,
+		 &req[n++] );
+  }
+  for(i=0; i<ns; i++) {
+    msend[i].shm = 0;
+    off[nr+i] = -1;
+    if(shm_base[msend[i].msg_node] != NULL) {
+      off[nr+i] = shm_alloc( msend[i].msg_size+CRCBYTES );
+      MPI_Isend( &off[nr+i], 1, MPI_LONG, msend[i].msg_node,
+		 GATHER_ID(mtag->ids[msend[i].id_offset]), shm_rel_comm,
+		 &req[n++] );
+    }
+  }
+  MPI_Waitall( n, req, MPI_STATUSES_IGNORE );
+
+  for(i=0; i<nr; i++) if(off[i] >= 0) {
+    mrecv[i].shm = 1;
+    mrecv[i].msg_buf = shm_base[mrecv[i].msg_node] + off[i];
+  }
+  for(i=0; i<ns; i++) if(off[nr+i] >= 0) {
+    msend[i].shm = 1;
+    msend[i].msg_buf = shm_base[mynode()] + off[nr+i];
+  }
+
+  free(off);
+  free(req);
+}
+#endif /* USE_SHM_TRANSPORT */
+
 /*
 **  Set up "comlink" structures needed by nearest neighbor gather routines.
 **  make_lattice() must be called first.
@@ -1186,6 +1494,10 @@ make_nn_gathers(void)
     terminate(1);
   }
 
+#ifdef USE_SHM_TRANSPORT
+  setup_shm_transport();
+#endif
+
   if((nx&1)||(ny&1)||(nz&1)||(nt&1)) gather_parity = SCRAMBLE_PARITY;
   else gather_parity = SWITCH_PARITY;
 
@@ -1815,6 +2127,8 @@ declare_strided_gather(
 
   mtag->nids = gt->offset_increment;
   mtag->ids = NULL;
+  mtag->reqs = NULL;
+  mtag->ngathers = 0;
 
   /* allocate a buffer for the msg_sr_t's.  This is dynamically allocated
      because there may be an arbitrary number of gathers in progress
@@ -1858,6 +2172,7 @@ declare_strided_gather(
     mrecv[i].id_offset = i;
     mrecv[i].msg_size = size*compt->n_subl_connected[subl];
     mrecv[i].msg_buf = NULL;
+    mrecv[i].shm = 0;
     gmem = (gmem_t *)malloc(sizeof(gmem_t));
     mrecv[i].gmem = gmem;
     gmem->num = compt->n_subl_connected[subl];
@@ -1877,6 +2192,7 @@ declare_strided_gather(
     msend[i].id_offset = idl->id_offset;
     msend[i].msg_size = size*compt->n_subl_connected[subl];
     msend[i].msg_buf = NULL;
+    msend[i].shm = 0;
     gmem = (gmem_t *)malloc(sizeof(gmem_t));
     msend[i].gmem = gmem;
     gmem->num = compt->n_subl_connected[subl];
@@ -1925,6 +2241,10 @@ prepare_gather(msg_tag *mtag)
     id_offset = j;
   }
 
+#ifdef USE_SHM_TRANSPORT
+  shm_handshake(mtag);
+#endif
+
   mrecv = mtag->recv_msgs;
   /* for each node which has neighbors of my sites */
   for(i=0; i<mtag->nrecvs; ++i) {
@@ -1932,7 +2252,8 @@ prepare_gather(msg_tag *mtag)
       if(mynode()==0)printf("error: unexpected zero msg_size\n");
       terminate(1);
     }
-    mrecv[i].msg_buf = tpt = (char *)malloc( mrecv[i].msg_size+CRCBYTES );
+    if(mrecv[i].shm) tpt = mrecv[i].msg_buf;
+    else mrecv[i].msg_buf = tpt = (char *)field_alloc_tag( mrecv[i].msg_size+CRCBYTES, MEM_GATHERS );
     if(tpt==NULL) {
       printf("NO ROOM for msg_buf, node %d\n", mynode());
       terminate(1);
@@ -1949,18 +2270,115 @@ prepare_gather(msg_tag *mtag)
       for(j=0; j<gmem->num; ++j) {
         ((char **)gmem->mem)[gmem->sitelist[j]] = tpt + j*gmem->size;
       }
+      tpt += gmem->num*gmem->size;  /* next field in this message */
     } while((gmem=gmem->next)!=NULL);
   }
 
   msend = mtag->send_msgs;
   /* for each node whose neighbors I have */
   for(i=0; i<mtag->nsends; ++i) {
-    msend[i].msg_buf = (char *)malloc( msend[i].msg_size+CRCBYTES );
+    if(msend[i].shm) continue;
+    msend[i].msg_buf = (char *)field_alloc_tag( msend[i].msg_size+CRCBYTES, MEM_GATHERS );
     if(msend[i].msg_buf==NULL) {
       printf("NO ROOM for msg_buf, node %d\n",mynode());
       terminate(1);
     }
   }
+
+  /* The buffers, peers and ids are now fixed for the life of the tag,
+     so set up persistent requests once.  do_gather then only starts
+     them. */
+  if(mtag->nrecvs+mtag->nsends > 0) {
+    mtag->reqs = (MPI_Request *)
+      malloc((mtag->nrecvs+mtag->nsends)*sizeof(MPI_Request));
+    if(mtag->reqs==NULL) {
+      printf("NO ROOM for reqs, node %d\n",mynode());
+      terminate(1);
+    }
+    for(i=0; i<mtag->nrecvs; ++i) {
+#ifdef USE_SHM_TRANSPORT
+      if(mrecv[i].shm) {
+	/* zero-byte "ready" from the sender, "release" back to it */
+	MPI_Recv_init( NULL, 0, MPI_BYTE, mrecv[i].msg_node,
+		       GATHER_ID(mtag->ids[mrecv[i].id_offset]),
+		       MPI_COMM_THISJOB, &mtag->reqs[i] );
+	MPI_Send_init( NULL, 0, MPI_BYTE, mrecv[i].msg_node,
+		       GATHER_ID(mtag->ids[mrecv[i].id_offset]),
+		       shm_rel_comm, &mrecv[i].rel_req );
+	continue;
+      }
+#endif
+      MPI_Recv_init( mrecv[i].msg_buf, mrecv[i].msg_size+CRCBYTES, MPI_BYTE,
+		     MPI_ANY_SOURCE, GATHER_ID(mtag->ids[mrecv[i].id_offset]),
+		     MPI_COMM_THISJOB, &mtag->reqs[i] );
+    }
+    for(i=0; i<mtag->nsends; ++i) {
+#ifdef USE_SHM_TRANSPORT
+      if(msend[i].shm) {
+	MPI_Send_init( NULL, 0, MPI_BYTE, msend[i].msg_node,
+		       GATHER_ID(mtag->ids[msend[i].id_offset]),
+		       MPI_COMM_THISJOB, &mtag->reqs[mtag->nrecvs+i] );
+	MPI_Recv_init( NULL, 0, MPI_BYTE, msend[i].msg_node,
+		       GATHER_ID(mtag->ids[msend[i].id_offset]),
+		       shm_rel_comm, &msend[i].rel_req );
+	continue;
+      }
+#endif
+      MPI_Send_init( msend[i].msg_buf, msend[i].msg_size+CRCBYTES, MPI_BYTE,
+		     msend[i].msg_node, GATHER_ID(mtag->ids[msend[i].id_offset]),
+		     MPI_COMM_THISJOB, &mtag->reqs[mtag->nrecvs+i] );
+    }
+  }
+}
+
+/*
+**  copy the sites listed in gmem into a send buffer
+*/
+
+/* With a constant size the compiler replaces memcpy by inline (vector)
+   moves, which matters for small elements like the 24-byte su3_vector.
+   The source sites are prefetched a few iterations ahead. */
+#define PACK_PREFETCH 4
+#if defined(__GNUC__)
+#define PACK_PREFETCH_SITE(j) \
+  if((j)+PACK_PREFETCH < num) \
+    __builtin_prefetch(mem + sitelist[(j)+PACK_PREFETCH]*stride, 0, 0)
+#else
+#define PACK_PREFETCH_SITE(j)
+#endif
+
+#ifdef OMP
+#define PACK_SITES(sz) \
+_Pragma("omp parallel for") \
+  for(j=0; j<num; ++j) { \
+    PACK_PREFETCH_SITE(j); \
+    memcpy(tpt + j*(sz), mem + sitelist[j]*stride, (sz)); \
+  }
+#else
+#define PACK_SITES(sz) \
+  for(j=0; j<num; ++j) { \
+    PACK_PREFETCH_SITE(j); \
+    memcpy(tpt + j*(sz), mem + sitelist[j]*stride, (sz)); \
+  }
+#endif
+
+static void
+pack_gmem(char *tpt, gmem_t *gmem)
+{
+  int j;
+  int num = gmem->num;
+  int *sitelist = gmem->sitelist;
+  char *mem = gmem->mem;
+  size_t stride = gmem->stride;
+
+  switch(gmem->size){
+  case 24:  PACK_SITES(24);  break; /* fsu3_vector */
+  case 48:  PACK_SITES(48);  break; /* dsu3_vector, fhalf_wilson_vector */
+  case 72:  PACK_SITES(72);  break; /* fsu3_matrix */
+  case 96:  PACK_SITES(96);  break; /* dhalf_wilson_vector */
+  case 144: PACK_SITES(144); break; /* dsu3_matrix */
+  default:  PACK_SITES(gmem->size);
+  }
 }
 
 /*
@@ -1973,35 +2391,44 @@ do_gather(msg_tag *mtag)  /* previously returned by start_gather_site */
   register char *tpt;	/* scratch pointer in buffers */
   msg_sr_t *mbuf;
   gmem_t *gmem;
+#ifdef USE_SHM_TRANSPORT
+  int nshm = 0;
+#endif
 
   if((mtag->ids==NULL)&&(mtag->nids!=0)) prepare_gather(mtag);
 
-  mbuf = mtag->recv_msgs;
-  /* for each node which has neighbors of my sites */
-  for(i=0; i<mtag->nrecvs; i++) {
-    /* post receive */
-    MPI_Irecv( mbuf[i].msg_buf, mbuf[i].msg_size+CRCBYTES, MPI_BYTE, MPI_ANY_SOURCE,
-	       GATHER_ID(mtag->ids[mbuf[i].id_offset]), MPI_COMM_THISJOB,
-	       &mbuf[i].msg_req );
+#ifdef USE_SHM_TRANSPORT
+  /* We are done with the data of the previous gather.  Tell the
+     on-node senders they may overwrite it. */
+  if(mtag->ngathers>0) {
+    mbuf = mtag->recv_msgs;
+    for(i=0; i<mtag->nrecvs; i++) if(mbuf[i].shm) {
+      if(nshm++==0) MPI_Win_sync(shm_win);
+      MPI_Start( &mbuf[i].rel_req );
+    }
   }
+#endif
+
+  /* post receives from each node which has neighbors of my sites */
+  if(mtag->nrecvs>0) MPI_Startall( mtag->nrecvs, mtag->reqs );
 
   mbuf = mtag->send_msgs;
   /* for each node whose neighbors I have */
   for(i=0; i<mtag->nsends; ++i) {
-    /* gather data into the buffer */
+#ifdef USE_SHM_TRANSPORT
+    /* the on-node receiver must release our previous data first */
+    if(mbuf[i].shm && mtag->ngathers>0)
+      MPI_Wait( &mbuf[i].rel_req, MPI_STATUS_IGNORE );
+#endif
+    /* gather data into the buffer.  Accumulated gathers put several
+       fields into one message, one after the other. */
     tpt = mbuf[i].msg_buf;
     gmem = mbuf[i].gmem;
     do {
-#ifdef OMP
-#pragma omp parallel for private(j)
-#endif
-      for(j=0; j<gmem->num; ++j) {
-	memcpy( tpt+j*gmem->size, 
-		gmem->mem + gmem->sitelist[j]*gmem->stride, gmem->size );
-      }
+      pack_gmem(tpt, gmem);
+      tpt += gmem->num*gmem->size;
     } while((gmem=gmem->next)!=NULL);
 
-    /* start the send */
 #ifdef COM_CRC
     {
       size_t msg_size;
@@ -2027,10 +2454,24 @@ do_gather(msg_tag *mtag)  /* previously returned by start_gather_site */
 #endif      
     }
 #endif
-    MPI_Isend( mbuf[i].msg_buf, mbuf[i].msg_size+CRCBYTES, MPI_BYTE, mbuf[i].msg_node,
-	       GATHER_ID(mtag->ids[mbuf[i].id_offset]), MPI_COMM_THISJOB,
-	       &mbuf[i].msg_req );
   }
+
+#ifdef USE_SHM_TRANSPORT
+  /* make the packed data visible to on-node receivers */
+  for(i=0; i<mtag->nsends; ++i) if(mbuf[i].shm) {
+    MPI_Win_sync(shm_win);
+    break;
+  }
+#endif
+
+  /* start the sends */
+  if(mtag->nsends>0) MPI_Startall( mtag->nsends, mtag->reqs + mtag->nrecvs );
+
+#ifdef USE_SHM_TRANSPORT
+  for(i=0; i<mtag->nsends; ++i)
+    if(mbuf[i].shm) MPI_Start( &mbuf[i].rel_req );
+  mtag->ngathers++;
+#endif
 }
 
 /*
@@ -2039,21 +2480,32 @@ do_gather(msg_tag *mtag)  /* previously returned by start_gather_site */
 void
 wait_gather(msg_tag *mtag)
 {
-  MPI_Status status;
   int i;
 #ifdef COM_CRC
   int fail = 0, work = 0;
 #endif
+#ifdef PERF_REGIONS
+  double recv_bytes = 0;
+  for(i=0; i<mtag->nrecvs; i++) recv_bytes += mtag->recv_msgs[i].msg_size;
+#endif
 
-  /* wait for all receive messages */
-  for(i=0; i<mtag->nrecvs; i++) {
-    MPI_Wait( &mtag->recv_msgs[i].msg_req, &status );
-  }
+  PERF_BEGIN("wait_gather");
+  /* wait for all receive and send messages.  The persistent requests
+     become inactive and can be started again. */
+  if(mtag->nrecvs+mtag->nsends > 0)
+    MPI_Waitall( mtag->nrecvs+mtag->nsends, mtag->reqs, MPI_STATUSES_IGNORE );
 
-  /* wait for all send messages */
-  for(i=0; i<mtag->nsends; i++) {
-    MPI_Wait( &mtag->send_msgs[i].msg_req, &status );
+#ifdef USE_SHM_TRANSPORT
+  /* complete our release messages and see the on-node senders' data */
+  for(i=0; i<mtag->nrecvs; i++) if(mtag->recv_msgs[i].shm) {
+    MPI_Wait( &mtag->recv_msgs[i].rel_req, MPI_STATUS_IGNORE );
   }
+  for(i=0; i<mtag->nrecvs; i++) if(mtag->recv_msgs[i].shm) {
+    MPI_Win_sync(shm_win);
+    break;
+  }
+#endif
+  PERF_END("wait_gather", 0, recv_bytes);
 #if COM_CRC
   /* Verify the checksums received */
   for(i=0; i<mtag->nrecvs; i++) {
@@ -2107,12 +2559,41 @@ cleanup_gather(msg_tag *mtag)
   int i;
   gmem_t *gmem, *next;
 
+  if(mtag==NULL) return;  /* e.g. a gather merged into another tag */
+
   if(mtag->ids!=NULL)
     for(i=0; i<mtag->nids; ++i) id_array[mtag->ids[i]] = 0;
 
+#ifdef USE_SHM_TRANSPORT
+  /* Release the last data to the on-node senders, and don't free our
+     shared buffers until the receivers have released them */
+  if(mtag->ngathers>0) {
+    for(i=0; i<mtag->nrecvs; i++) if(mtag->recv_msgs[i].shm)
+      MPI_Start( &mtag->recv_msgs[i].rel_req );
+    for(i=0; i<mtag->nsends; i++) if(mtag->send_msgs[i].shm)
+      MPI_Wait( &mtag->send_msgs[i].rel_req, MPI_STATUS_IGNORE );
+    for(i=0; i<mtag->nrecvs; i++) if(mtag->recv_msgs[i].shm)
+      MPI_Wait( &mtag->recv_msgs[i].rel_req, MPI_STATUS_IGNORE );
+  }
+  if(mtag->reqs!=NULL) {
+    for(i=0; i<mtag->nrecvs; i++) if(mtag->recv_msgs[i].shm)
+      MPI_Request_free( &mtag->recv_msgs[i].rel_req );
+    for(i=0; i<mtag->nsends; i++) if(mtag->send_msgs[i].shm)
+      MPI_Request_free( &mtag->send_msgs[i].rel_req );
+  }
+#endif
+
+  if(mtag->reqs!=NULL) {
+    for(i=0; i<mtag->nrecvs+mtag->nsends; ++i) MPI_Request_free( &mtag->reqs[i] );
+    free(mtag->reqs);
+  }
+
   /* free all receive buffers */
   for(i=0; i<mtag->nrecvs; i++) {
-    free( mtag->recv_msgs[i].msg_buf );
+#ifdef USE_SHM_TRANSPORT
+    if(mtag->recv_msgs[i].shm) mtag->recv_msgs[i].msg_buf = NULL;
+#endif
+    field_free( mtag->recv_msgs[i].msg_buf );
     gmem = mtag->recv_msgs[i].gmem;
     do {
       next = gmem->next;
@@ -2122,7 +2603,14 @@ cleanup_gather(msg_tag *mtag)
   }
   /*  free all send buffers */
   for(i=0; i<mtag->nsends; i++) {
-    free( mtag->send_msgs[i].msg_buf );
+#ifdef USE_SHM_TRANSPORT
+    if(mtag->send_msgs[i].shm) {
+      shm_release( mtag->send_msgs[i].msg_buf - shm_base[mynode()],
+		   mtag->send_msgs[i].msg_size+CRCBYTES );
+      mtag->send_msgs[i].msg_buf = NULL;
+    }
+#endif
+    field_free( mtag->send_msgs[i].msg_buf );
     gmem = mtag->send_msgs[i].gmem;
     do {
       next = gmem->next;
@@ -2403,7 +2891,7 @@ copy_gmem(gmem_t **dest, gmem_t *src)
 static void
 add_msgt(msg_sr_t **dest, int *ndest, msg_sr_t *src, int nsrc, int nids)
 {
-  int i, j, n;
+  int i, j, k, n;
 
   n = 0;
   for(i=0; i<nsrc; ++i) {
@@ -2422,6 +2910,8 @@ add_msgt(msg_sr_t **dest, int *ndest, msg_sr_t *src, int nsrc, int nids)
       printf("error add_msgt malloc node:%i\n",mynode());
       terminate(1);
     }
+    /* new messages go after the existing ones */
+    k = *ndest;
     for(i=0; i<nsrc; ++i) {
       for(j=0; j<*ndest; ++j) {
 	if((*dest)[j].msg_node==src[i].msg_node) break;
@@ -2430,12 +2920,14 @@ add_msgt(msg_sr_t **dest, int *ndest, msg_sr_t *src, int nsrc, int nids)
 	(*dest)[j].msg_size += src[i].msg_size;
 	copy_gmem(&((*dest)[j].gmem), src[i].gmem);
       } else {
-	(*dest)[*ndest+i].msg_node = src[i].msg_node;
-	(*dest)[*ndest+i].id_offset = nids + src[i].id_offset;
-	(*dest)[*ndest+i].msg_size = src[i].msg_size;
-	(*dest)[*ndest+i].msg_buf = NULL;
-	(*dest)[*ndest+i].gmem = NULL;
-	copy_gmem(&((*dest)[*ndest+i].gmem), src[i].gmem);
+	(*dest)[k].msg_node = src[i].msg_node;
+	(*dest)[k].id_offset = nids + src[i].id_offset;
+	(*dest)[k].msg_size = src[i].msg_size;
+	(*dest)[k].msg_buf = NULL;
+	(*dest)[k].shm = 0;
+	(*dest)[k].gmem = NULL;
+	copy_gmem(&((*dest)[k].gmem), src[i].gmem);
+	k++;
       }
     }
   }
@@ -2462,6 +2954,8 @@ accumulate_gather(msg_tag **mmtag, msg_tag *mtag)
     amtag->recv_msgs = NULL;
     amtag->nsends = 0;
     amtag->send_msgs = NULL;
+    amtag->reqs = NULL;
+    amtag->ngathers = 0;
     *mmtag = amtag;
   } else {
     amtag = *mmtag;
@@ -2735,7 +3229,7 @@ start_general_strided_gather(
     nsites = from_nodes[i].count;
     mrecv[i].msg_node = from_nodes[i].node;
     mrecv[i].msg_size = nsites*tsize;
-    mrecv[i].msg_buf = (char *)malloc( nsites*tsize );
+    mrecv[i].msg_buf = (char *)field_alloc_tag( nsites*tsize, MEM_GATHERS );
     if(mrecv[i].msg_buf==NULL){
       printf("NO ROOM for msg_buf, node %d\n",mynode());
       terminate(1);
@@ -2749,7 +3243,7 @@ start_general_strided_gather(
   /* for each node whose neighbors I have */
   for(i=0; i<n_send_msgs; i++) {
     /* Allocate buffer to gather data. */
-    tpt=(char *)malloc( to_nodes[i].count*tsize );
+    tpt=(char *)field_alloc_tag( to_nodes[i].count*tsize, MEM_GATHERS );
     if(tpt==NULL) {
       printf("NO ROOM for tpt, node %d\n",mynode());
       terminate(1);
@@ -3041,7 +3535,7 @@ start_general_strided_gather(
     nsites = from_nodes[i].count;
     mrecv[i].msg_node = from_nodes[i].node;
     mrecv[i].msg_size = nsites*tsize;
-    mrecv[i].msg_buf = (char *)malloc( nsites*tsize );
+    mrecv[i].msg_buf = (char *)field_alloc_tag( nsites*tsize, MEM_GATHERS );
     if(mrecv[i].msg_buf==NULL){
       printf("NO ROOM for msg_buf, node %d\n",mynode());
       terminate(1);
@@ -3183,12 +3677,12 @@ cleanup_general_gather(msg_tag *mtag)
 
   /* free all receive buffers */
   for(i=0; i<mtag->nrecvs; i++) {
-    free( mtag->recv_msgs[i].msg_buf );
+    field_free( mtag->recv_msgs[i].msg_buf );
   }
   /* wait for all send messages, free all send buffers */
   for(i=0; i<mtag->nsends; i++) {
     MPI_Wait( &mtag->send_msgs[i].msg_req, &status );
-    free( mtag->send_msgs[i].msg_buf );
+    field_free( mtag->send_msgs[i].msg_buf );
   }
   /* free the msg_tag buffer */
   free(mtag->recv_msgs);
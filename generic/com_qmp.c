@@ -32,12 +32,15 @@
    machine_type()        returns string describing communications architecture
    mynode()              returns node number of this node.
    numnodes()            returns number of nodes
+   pes_per_node()        returns number of ranks sharing a physical node
    g_sync()              provides a synchronization point for all nodes.
    g_floatsum()          sums a floating point number over all nodes.
    g_intsum()            sums an integer over all nodes
    g_vecfloatsum()       sums a vector of floats over all nodes 
    g_doublesum()         sums a double over all nodes.
    g_vecdoublesum()      sums a vector of doubles over all nodes.
+   start_g_vecdoublesum() starts a nonblocking sum of a vector of doubles.
+   wait_g_vecdoublesum() waits for the sum to complete.
    g_longdoublesum()     sums a long double over all nodes.
    g_veclongdoublesum()  sums a vector of long doubles over all nodes.
    g_complexsum()        sums a single precision complex number over all nodes.
@@ -80,6 +83,7 @@
                            data has actually arrived.
    cleanup_gather()      frees all the buffers that were allocated, WHICH
                            MEANS THAT THE GATHERED DATA MAY SOON DISAPPEAR.
+                           Does nothing for a NULL tag.
    accumulate_gather()   combines gathers into single message tag
    declare_accumulate_gather_site()  does declare_gather() and accumulate_gather()
                                   in single step.
@@ -460,6 +464,15 @@ void
 normal_exit(int status)
 {
   time_stamp("exit");
+#ifdef FIELD_POOL
+  report_field_pool();
+#endif
+#ifdef MEM_ACCOUNT
+  report_mem_account();
+#endif
+#ifdef PERF_REGIONS
+  report_perf_regions();
+#endif
   fflush(stdout);
   g_sync();
 
@@ -551,6 +564,15 @@ numnodes(void)
   return QMP_get_number_of_nodes();
 }
 
+/*
+**  Return number of ranks per physical node.  QMP does not tell us.
+*/
+int
+pes_per_node(void)
+{
+  return 1;
+}
+
 /*
 **  Return my jobid
 */
@@ -648,6 +670,22 @@ g_vecdoublesum(double *dpt, int ndoubles)
   QMP_sum_double_array(dpt, ndoubles);
 }
 
+/*
+**  Nonblocking sum of a vector of doubles over all nodes.
+**  QMP has no nonblocking reduction, so the sum is done here.
+*/
+sum_tag *
+start_g_vecdoublesum(double *dpt, int ndoubles)
+{
+  QMP_sum_double_array(dpt, ndoubles);
+  return NULL;
+}
+
+void
+wait_g_vecdoublesum(sum_tag *stag)
+{
+}
+
 /*
 **  Sum long double over all nodes
 */
@@ -1863,6 +1901,7 @@ prepare_gather(msg_tag *mtag)
       for(j=0; j<gmem->num; ++j) {
 	((char **)gmem->mem)[gmem->sitelist[j]] = tpt + j*gmem->size;
       }
+      tpt += gmem->num*gmem->size;  /* next field in this message */
     } while((gmem=gmem->next)!=NULL);
   }
 
@@ -1939,6 +1978,7 @@ do_gather(msg_tag *mtag)  /* previously returned by start_gather_site */
 	memcpy( tpt+j*gmem->size, 
 		gmem->mem + gmem->sitelist[j]*gmem->stride, gmem->size );
       }
+      tpt += gmem->num*gmem->size;  /* next field in this message */
     } while((gmem=gmem->next)!=NULL);
 
     /* start the send */
@@ -2052,6 +2092,8 @@ cleanup_gather(msg_tag *mtag)
   int i;
   gmem_t *gmem, *next;
 
+  if(mtag==NULL) return;  /* e.g. a gather merged into another tag */
+
 #if 0
   if(mtag->ids!=NULL)
     for(i=0; i<mtag->nids; ++i) id_array[mtag->ids[i]] = 0;
@@ -2364,7 +2406,7 @@ copy_gmem(gmem_t **dest, gmem_t *src)
 static void
 add_msgt(msg_sr_t **dest, int *ndest, msg_sr_t *src, int nsrc/*, int nids*/)
 {
-  int i, j, n;
+  int i, j, k, n;
 
   n = 0;
   for(i=0; i<nsrc; ++i) {
@@ -2382,6 +2424,8 @@ add_msgt(msg_sr_t **dest, int *ndest, msg_sr_t *src, int nsrc/*, int nids*/)
     printf("error add_msgt malloc node:%i\n",mynode());
     terminate(1);
   }
+  /* new messages go after the existing ones */
+  k = *ndest;
   for(i=0; i<nsrc; ++i) {
     for(j=0; j<*ndest; ++j) {
       if((*dest)[j].msg_node==src[i].msg_node) break;
@@ -2390,12 +2434,13 @@ add_msgt(msg_sr_t **dest, int *ndest, msg_sr_t *src, int nsrc/*, int nids*/)
       (*dest)[j].msg_size += src[i].msg_size;
       copy_gmem(&((*dest)[j].gmem), src[i].gmem);
     } else {
-      (*dest)[*ndest+i].msg_node = src[i].msg_node;
-      //(*dest)[*ndest+i].id_offset = nids + src[i].id_offset;
-      (*dest)[*ndest+i].msg_size = src[i].msg_size;
-      (*dest)[*ndest+i].msg_buf = NULL;
-      (*dest)[*ndest+i].gmem = NULL;
-      copy_gmem(&((*dest)[*ndest+i].gmem), src[i].gmem);
+      (*dest)[k].msg_node = src[i].msg_node;
+      //(*dest)[k].id_offset = nids + src[i].id_offset;
+      (*dest)[k].msg_size = src[i].msg_size;
+      (*dest)[k].msg_buf = NULL;
+      (*dest)[k].gmem = NULL;
+      copy_gmem(&((*dest)[k].gmem), src[i].gmem);
+      k++;
     }
   }
   *ndest = n;
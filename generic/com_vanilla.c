@@ -31,11 +31,14 @@
    machine_type()        returns string describing communications architecture
    mynode()              returns node number of this node.
    numnodes()            returns number of nodes
+   pes_per_node()        returns number of ranks sharing a physical node
    g_sync()              provides a synchronization point for all nodes.
    g_floatsum()          sums a Realing point number over all nodes.
    g_vecfloatsum()       sums a vector of Reals over all nodes 
    g_doublesum()         sums a double over all nodes.
    g_vecdoublesum()      sums a vector of doubles over all nodes.
+   start_g_vecdoublesum() starts a nonblocking sum of a vector of doubles.
+   wait_g_vecdoublesum() waits for the sum to complete.
    g_longdoublesum()     sums a long double over all nodes.
    g_veclongdoublesum()  sums a vector of long doubles over all nodes.
    g_complexsum()        sums a single precision complex number over all nodes.
@@ -196,6 +199,15 @@ void
 normal_exit(int status)
 {
   time_stamp("exit");
+#ifdef FIELD_POOL
+  report_field_pool();
+#endif
+#ifdef MEM_ACCOUNT
+  report_mem_account();
+#endif
+#ifdef PERF_REGIONS
+  report_perf_regions();
+#endif
   fflush(stdout);
   exit(status);
 }
@@ -249,6 +261,15 @@ numnodes(void)
   return(1);
 }
 
+/*
+**  Return number of ranks per physical node
+*/
+int
+pes_per_node(void)
+{
+  return(1);
+}
+
 /*
 **  Return my jobid
 */
@@ -353,6 +374,20 @@ g_vecdoublesum(double *dpt, int ndoubles)
 {
 }
 
+/*
+**  Nonblocking sum of a vector of doubles over all nodes
+*/
+sum_tag *
+start_g_vecdoublesum(double *dpt, int ndoubles)
+{
+  return NULL;
+}
+
+void
+wait_g_vecdoublesum(sum_tag *stag)
+{
+}
+
 /*
 **  Sum long double over all nodes
 */
@@ -32,14 +32,12 @@ msg_tag *mtag0,*mtag1;
     for(dir1=YUP;dir1<=TUP;dir1++){
 	for(dir2=XUP;dir2<dir1;dir2++){
 
-	    mtag0 = start_gather_site( F_OFFSET(link[dir2]), sizeof(su3_matrix),
-		dir1, EVENANDODD, gen_pt[0] );
-	    mtag1 = start_gather_site( F_OFFSET(link[dir1]), sizeof(su3_matrix),
-		dir2, EVENANDODD, gen_pt[1] );
+	    mtag0 = start_gather_link( dir2, dir1, EVENANDODD, gen_pt[0] );
+	    mtag1 = start_gather_link( dir1, dir2, EVENANDODD, gen_pt[1] );
 
 	    FORALLSITES_OMP(i,s,private(m1,m4)){
-		m1 = &(s->link[dir1]);
-		m4 = &(s->link[dir2]);
+		m1 = &(SITE_LINK(i)[dir1]);
+		m4 = &(SITE_LINK(i)[dir2]);
 		mult_su3_an(m4,m1,&su3mat[i]);
 	    } END_LOOP_OMP
 
@@ -39,7 +39,7 @@ void shift_gauge(int rshift[]){
 
   FORALLUPDIR(dir){
     FORALLSITES(i,s){
-      su3mat_copy( &s->link[dir], old_link+i);
+      su3mat_copy( &SITE_LINK(i)[dir], old_link+i);
     }
 
     tag = start_general_gather_field( old_link, sizeof(su3_matrix), 
@@ -47,7 +47,7 @@ void shift_gauge(int rshift[]){
     wait_general_gather(tag);
 
     FORALLSITES(i,s){
-      su3mat_copy((su3_matrix *)gen_pt[0][i], &s->link[dir]);
+      su3mat_copy((su3_matrix *)gen_pt[0][i], &SITE_LINK(i)[dir]);
     }
 
     cleanup_general_gather(tag);
@@ -96,7 +96,7 @@ void shift_complex(complex *src, int rshift[]){
   }
 
   cleanup_general_gather(tag);
-  free(tmp);
+  destroy_c_field(tmp);
 
 }
 
@@ -134,7 +134,7 @@ void shift_su3_vector(su3_vector *src, int rshift[]){
     su3vec_copy((su3_vector *)(gen_pt[0][i]), src+i);
   }
   cleanup_general_gather(tag);
-  free(tmp);
+  destroy_v_field(tmp);
 
 }
 
@@ -172,7 +172,7 @@ void shift_wilson_vector(wilson_vector *src, int rshift[]){
     copy_wvec((wilson_vector *)(gen_pt[0][i]), src+i);
   }
   cleanup_general_gather(tag);
-  free(tmp);
+  destroy_wv_field(tmp);
 
 }
 
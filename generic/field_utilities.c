@@ -4,6 +4,10 @@
 /* A collection of utilities for creating and copying fields */
 /* (Plus a timing utility) */
 
+#ifdef FIELD_POOL
+#define _POSIX_C_SOURCE 200112L // for posix_memalign
+#define _DEFAULT_SOURCE         // for madvise
+#endif
 #include "generic_includes.h"
 #include "../include/openmp_defs.h"
 
@@ -30,15 +34,392 @@ void print_timing(double dtime, char *str){
 }
 
 /*--------------------------------------------------------------------*/
+/* Field memory.  With -DFIELD_POOL, the storage for fields made by
+   the create_*_field routines below is kept in a pool when the field
+   is destroyed and handed out again for the next field of the same
+   size, instead of being returned to the system.  Long MD runs then
+   stop paying for page faults and fragmentation on every force and
+   solver call.  Blocks are 64-byte aligned, and blocks of at least
+   2 MB are aligned to huge pages and marked for transparent huge
+   pages where the system supports it.
+
+   With -DMEM_ACCOUNT, every block is charged to a subsystem tag
+   (MEM_LINKS, MEM_EIGEN, ... in generic.h), and the current and peak
+   bytes per tag are kept on each rank.  Storage that does not come
+   from field_alloc (the lattice, the gather buffers) is charged with
+   mem_account().  report_mem_account() prints the table at exit.
+   Unlike CHECK_MALLOC this prints nothing per call and is cheap
+   enough for production runs.
+
+   field_alloc(bytes)   returns storage for a field, charged to the
+                        current tag (see set_mem_tag)
+   field_alloc_tag(bytes, tag)  the same, charged to tag
+   field_free(p)        returns it.  Storage that did not come from
+                        field_alloc is passed to free().
+   report_field_pool()  prints the high-water mark and pool usage
+   free_field_pool()    returns the pooled storage to the system
+
+   Storage from field_alloc or a create_*_field routine must be
+   released with field_free or the matching destroy_*_field, never
+   with free().  A raw free() leaves the block in the table below, and
+   when malloc hands the address out again a later field_free of it
+   would put a block of the wrong size into the pool.
+
+   Neither the pool nor the accounting is thread safe.  Fields are
+   created and destroyed outside parallel regions. */
+
+#if defined(FIELD_POOL) || defined(MEM_ACCOUNT)
+#define FIELD_BLOCK_TABLE
+#endif
+
+/*--------------------------------------------------------------------*/
+/* Accounting by subsystem */
+
+static int mem_tag = MEM_FIELDS;
+
+/* Sets the tag for subsequent field_alloc calls and returns the old one */
+int set_mem_tag(int tag){
+  int old = mem_tag;
+  mem_tag = tag;
+  return old;
+}
+
+#ifdef MEM_ACCOUNT
+
+static char *mem_tag_name[MEM_NTAGS] =
+  { "fields", "lattice", "links", "eigenvectors", "propagators", "gathers" };
+static double mem_now[MEM_NTAGS], mem_peak[MEM_NTAGS];
+static double mem_now_total = 0, mem_peak_total = 0;
+static double mem_nstale = 0, mem_stale_bytes = 0;
+
+void mem_account(int tag, double bytes){
+  if(tag < 0 || tag >= MEM_NTAGS)tag = MEM_FIELDS;
+  mem_now[tag] += bytes;
+  if(mem_now[tag] > mem_peak[tag])mem_peak[tag] = mem_now[tag];
+  mem_now_total += bytes;
+  if(mem_now_total > mem_peak_total)mem_peak_total = mem_now_total;
+}
+
+/* Collective: all ranks must call it */
+void report_mem_account(void){
+  int tag;
+  double peak_max;
+
+  node0_printf("MEM_ACCOUNT: %-14s %12s %12s %16s\n", "subsystem",
+	       "now MB", "peak MB", "max peak MB");
+  for(tag = 0; tag < MEM_NTAGS; tag++){
+    peak_max = mem_peak[tag];
+    g_doublemax(&peak_max);
+    node0_printf("MEM_ACCOUNT: %-14s %12.1f %12.1f %16.1f\n", mem_tag_name[tag],
+		 mem_now[tag]/1e6, mem_peak[tag]/1e6, peak_max/1e6);
+  }
+  peak_max = mem_peak_total;
+  g_doublemax(&peak_max);
+  node0_printf("MEM_ACCOUNT: %-14s %12.1f %12.1f %16.1f\n", "total",
+	       mem_now_total/1e6, mem_peak_total/1e6, peak_max/1e6);
+  node0_printf("MEM_ACCOUNT: peaks are per rank; the total peak is the peak of the sum\n");
+  report_site_fields();
+  if(mem_nstale > 0)
+    printf("MEM_ACCOUNT(%d): %.0f blocks (%.1f MB) were released with free() instead of field_free\n",
+	   this_node, mem_nstale, mem_stale_bytes/1e6);
+}
+
+#endif
+
+#ifdef FIELD_BLOCK_TABLE
+
+#include <stdint.h>
+#if defined(FIELD_POOL) && defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+#define FIELD_ALIGN 64
+#define FIELD_HUGE_PAGE (2*1024*1024)
+
+typedef struct {
+  void *p;            /* block handed out, NULL for an empty slot */
+  size_t bytes;
+  int tag;            /* subsystem charged for it */
+} field_block;
+
+static field_block *live = NULL;    /* hash table of blocks in use */
+static size_t nlive_slots = 0;
+static size_t nlive = 0;
+
+static size_t live_hash(void *p, size_t nslots){
+  return (size_t)(((uintptr_t)p/FIELD_ALIGN) * 2654435761u) % nslots;
+}
+
+static void live_insert(field_block *table, size_t nslots, field_block b){
+  size_t k = live_hash(b.p, nslots);
+  while(table[k].p != NULL && table[k].p != b.p)k = (k + 1) % nslots;
+  table[k] = b;
+}
+
+/* Keep the table at most half full */
+static void live_grow(void){
+  size_t k, n = nlive_slots == 0 ? 1024 : 2*nlive_slots;
+  field_block *table = (field_block *)calloc(n, sizeof(field_block));
+
+  if(table == NULL){
+    printf("field_alloc(%d): no room for the block table\n", this_node);
+    terminate(1);
+  }
+  for(k = 0; k < nlive_slots; k++)
+    if(live[k].p != NULL)live_insert(table, n, live[k]);
+  free(live);
+  live = table;
+  nlive_slots = n;
+}
+
+static void live_add(void *p, size_t bytes, int tag){
+  field_block b;
+
+  if(2*(nlive + 1) > nlive_slots)live_grow();
+  b.p = p;
+  b.bytes = bytes;
+  b.tag = tag;
+  live_insert(live, nlive_slots, b);
+  nlive++;
+}
+
+/* Remove p from the table and return its entry, with bytes = 0 if it
+   is not there */
+static field_block live_remove(void *p){
+  size_t k, j;
+  field_block b;
+
+  b.p = p;
+  b.bytes = 0;
+  b.tag = MEM_FIELDS;
+  if(nlive_slots == 0)return b;
+  k = live_hash(p, nlive_slots);
+  while(live[k].p != p){
+    if(live[k].p == NULL)return b;
+    k = (k + 1) % nlive_slots;
+  }
+  b = live[k];
+  live[k].p = NULL;
+  nlive--;
+
+  /* Reinsert the rest of the cluster so lookups still find it */
+  for(j = (k + 1) % nlive_slots; live[j].p != NULL; j = (j + 1) % nlive_slots){
+    field_block c = live[j];
+    live[j].p = NULL;
+    live_insert(live, nlive_slots, c);
+  }
+  return b;
+}
+
+#endif /* FIELD_BLOCK_TABLE */
+
+#ifdef FIELD_POOL
+
+typedef struct {
+  size_t bytes;       /* block size of this bucket */
+  int nfree;          /* number of blocks waiting in the pool */
+  int maxfree;        /* room in the free list */
+  void **free_list;
+} field_bucket;
+
+static field_bucket *buckets = NULL;
+static int nbuckets = 0;
+
+static size_t bytes_in_use = 0, bytes_in_use_max = 0;
+static size_t bytes_pooled = 0;
+static double nallocs = 0, nreused = 0;
+
+static size_t block_bytes(size_t bytes){
+  return ((bytes + FIELD_ALIGN - 1)/FIELD_ALIGN)*FIELD_ALIGN;
+}
+
+static field_bucket *find_bucket(size_t bytes){
+  int b;
+
+  for(b = 0; b < nbuckets; b++)
+    if(buckets[b].bytes == bytes)return &buckets[b];
+  buckets = (field_bucket *)realloc(buckets, (nbuckets+1)*sizeof(field_bucket));
+  if(buckets == NULL){
+    printf("field_alloc(%d): no room for the bucket table\n", this_node);
+    terminate(1);
+  }
+  buckets[nbuckets].bytes = bytes;
+  buckets[nbuckets].nfree = 0;
+  buckets[nbuckets].maxfree = 0;
+  buckets[nbuckets].free_list = NULL;
+  return &buckets[nbuckets++];
+}
+
+static void *pool_alloc(size_t bytes){
+  field_bucket *bk = find_bucket(bytes);
+  void *p = NULL;
+
+  nallocs++;
+  if(bk->nfree > 0){
+    p = bk->free_list[--bk->nfree];
+    bytes_pooled -= bytes;
+    nreused++;
+  } else {
+    size_t align = bytes >= FIELD_HUGE_PAGE ? FIELD_HUGE_PAGE : FIELD_ALIGN;
+    if(posix_memalign(&p, align, bytes) != 0)return NULL;
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    if(align == FIELD_HUGE_PAGE)
+      madvise(p, bytes, MADV_HUGEPAGE);
+#endif
+  }
+
+  bytes_in_use += bytes;
+  if(bytes_in_use > bytes_in_use_max)bytes_in_use_max = bytes_in_use;
+  return p;
+}
+
+static void pool_free(void *p, size_t bytes){
+  field_bucket *bk = find_bucket(bytes);
+
+  bytes_in_use -= bytes;
+  if(bk->nfree == bk->maxfree){
+    bk->maxfree = bk->maxfree == 0 ? 8 : 2*bk->maxfree;
+    bk->free_list = (void **)realloc(bk->free_list, bk->maxfree*sizeof(void *));
+    if(bk->free_list == NULL){
+      printf("field_free(%d): no room for the free list\n", this_node);
+      terminate(1);
+    }
+  }
+  bk->free_list[bk->nfree++] = p;
+  bytes_pooled += bytes;
+}
+
+void free_field_pool(void){
+  int b, k;
+
+  for(b = 0; b < nbuckets; b++){
+    for(k = 0; k < buckets[b].nfree; k++)
+      free(buckets[b].free_list[k]);
+    free(buckets[b].free_list);
+  }
+  free(buckets);
+  buckets = NULL;
+  nbuckets = 0;
+  bytes_pooled = 0;
+}
+
+/* Collective: all ranks must call it */
+void report_field_pool(void){
+  double peak = bytes_in_use_max, pooled = bytes_pooled;
+  double peak_max = peak, pooled_max = pooled;
+
+  g_doublemax(&peak_max);
+  g_doublemax(&pooled_max);
+  node0_printf("FIELD_POOL: peak in use %.1f MB (max over ranks %.1f MB), now pooled %.1f MB (max %.1f MB)\n",
+	       peak/1e6, peak_max/1e6, pooled/1e6, pooled_max/1e6);
+  node0_printf("FIELD_POOL: %.0f allocations, %.0f served from the pool, %d block sizes\n",
+	       nallocs, nreused, nbuckets);
+}
+
+#else
+
+void free_field_pool(void){}
+
+void report_field_pool(void){}
+
+#endif /* FIELD_POOL */
+
+#ifdef FIELD_BLOCK_TABLE
+/* A new block can only be in the table already if the block that had
+   that address was released with free() instead of field_free.  Drop
+   the stale entry and take back what it was charged. */
+static void drop_stale(void *p){
+  field_block b = live_remove(p);
+
+  if(b.bytes == 0)return;
+  mem_account(b.tag, -(double)b.bytes);
+#ifdef FIELD_POOL
+  bytes_in_use -= b.bytes;
+#endif
+#ifdef MEM_ACCOUNT
+  mem_nstale++;
+  mem_stale_bytes += b.bytes;
+#endif
+}
+#endif
+
+void *field_alloc_tag(size_t bytes, int tag){
+#ifdef FIELD_BLOCK_TABLE
+  void *p;
+
+#ifdef FIELD_POOL
+  bytes = block_bytes(bytes);
+  p = pool_alloc(bytes);
+#else
+  if(bytes == 0)bytes = 1;
+  p = malloc(bytes);
+#endif
+  if(p == NULL)return NULL;
+  drop_stale(p);
+  live_add(p, bytes, tag);
+  mem_account(tag, (double)bytes);
+  return p;
+#else
+  return malloc(bytes);
+#endif
+}
+
+void *field_alloc(size_t bytes){
+  return field_alloc_tag(bytes, mem_tag);
+}
+
+void field_free(void *p){
+#ifdef FIELD_BLOCK_TABLE
+  field_block b;
+
+  if(p == NULL)return;
+  b = live_remove(p);
+  if(b.bytes == 0){
+    free(p);
+    return;
+  }
+  mem_account(b.tag, -(double)b.bytes);
+#ifdef FIELD_POOL
+  pool_free(p, b.bytes);
+#else
+  free(p);
+#endif
+#else
+  free(p);
+#endif
+}
+
+/*--------------------------------------------------------------------*/
+/* With OpenMP, fields are cleared and copied site by site by all
+   threads.  A page is placed in the NUMA domain of the thread that
+   first touches it, so clearing a newly created field this way ("first
+   touch") puts each thread's sites in its local memory.  The solvers
+   mostly loop over one parity at a time (FORSOMEFIELDPARITY_OMP), so
+   the clear uses the same static partition: even sites, then odd
+   sites, each split separately among the threads. */
+
+#ifdef OMP
+#define make_clear_field(ABBREV, T) \
+void clear_##ABBREV##_field(T *x){ \
+  int i; \
+  FORSOMEFIELDPARITY_OMP(i,EVEN,schedule(static)){ \
+    memset(x+i,'\0',sizeof(T)); \
+  } END_LOOP_OMP; \
+  FORSOMEFIELDPARITY_OMP(i,ODD,schedule(static)){ \
+    memset(x+i,'\0',sizeof(T)); \
+  } END_LOOP_OMP; \
+}
+#else
 #define make_clear_field(ABBREV, T) \
 void clear_##ABBREV##_field(T *x){ \
   memset(x,'\0',sites_on_node*sizeof(T)); \
 }
+#endif
 
 #define make_create_field(ABBREV, T) \
 T* create_##ABBREV##_field(void){ \
   T *x; \
-  x = (T *)malloc(sites_on_node*sizeof(T)); \
+  x = (T *)field_alloc(sites_on_node*sizeof(T)); \
   if(x == NULL){ \
     printf("create_field: no room\n"); \
     terminate(1); \
@@ -47,14 +428,24 @@ T* create_##ABBREV##_field(void){ \
   return x; \
 }
 
+#ifdef OMP
+#define make_copy_field(ABBREV, T) \
+void copy_##ABBREV##_field(T *dst, T *src){ \
+  int i; \
+  FORALLFIELDSITES_OMP(i,schedule(static)){ \
+    memcpy(dst+i, src+i, sizeof(T)); \
+  } END_LOOP_OMP; \
+}
+#else
 #define make_copy_field(ABBREV, T) \
 void copy_##ABBREV##_field(T *dst, T *src){ \
   memcpy(dst, src, sites_on_node*sizeof(T)); \
 }
+#endif
 
 #define make_destroy_field(ABBREV, T) \
 void destroy_##ABBREV##_field(T *x){ \
-  if(x != NULL) free(x); \
+  if(x != NULL) field_free(x); \
 }
 
 #define make_all_field(ABBREV, T) \
@@ -66,15 +457,28 @@ void destroy_##ABBREV##_field(T *x){ \
 /*--------------------------------------------------------------------*/
 /* Array versions of the above.  Each site has n copies of the type */
 
+#ifdef OMP
+#define make_clear_array_field(ABBREV, T) \
+void clear_##ABBREV##_array_field(T *x, int n){	 \
+  int i; \
+  FORSOMEFIELDPARITY_OMP(i,EVEN,schedule(static)){ \
+    memset(x+i*n,'\0',sizeof(T)*n); \
+  } END_LOOP_OMP; \
+  FORSOMEFIELDPARITY_OMP(i,ODD,schedule(static)){ \
+    memset(x+i*n,'\0',sizeof(T)*n); \
+  } END_LOOP_OMP; \
+}
+#else
 #define make_clear_array_field(ABBREV, T) \
 void clear_##ABBREV##_array_field(T *x, int n){	 \
   memset(x,'\0',sites_on_node*sizeof(T)*n); \
 }
+#endif
 
 #define make_create_array_field(ABBREV, T) \
 T* create_##ABBREV##_array_field(int n){ \
   T *x; \
-  x = (T *)malloc(sites_on_node*sizeof(T)*n); \
+  x = (T *)field_alloc(sites_on_node*sizeof(T)*n); \
   if(x == NULL){ \
     printf("create_array_field: no room\n"); \
     terminate(1); \
@@ -83,14 +487,24 @@ T* create_##ABBREV##_array_field(int n){ \
   return x; \
 }
 
+#ifdef OMP
+#define make_copy_array_field(ABBREV, T) \
+void copy_##ABBREV##_array_field(T *dst, T *src, int n){	\
+  int i; \
+  FORALLFIELDSITES_OMP(i,schedule(static)){ \
+    memcpy(dst+i*n, src+i*n, sizeof(T)*n); \
+  } END_LOOP_OMP; \
+}
+#else
 #define make_copy_array_field(ABBREV, T) \
 void copy_##ABBREV##_array_field(T *dst, T *src, int n){	\
   memcpy(dst, src, sites_on_node*sizeof(T)*n); \
 }
+#endif
 
 #define make_destroy_array_field(ABBREV, T) \
 void destroy_##ABBREV##_array_field(T *x, int n){	\
-  if(x != NULL) free(x); \
+  if(x != NULL) field_free(x); \
 }
 
 #define make_all_array_field(ABBREV, T) \
@@ -118,6 +532,104 @@ make_all_array_field(v, su3_vector)
 make_all_array_field(m, su3_matrix)
 make_all_array_field(wv, wilson_vector)
 make_all_array_field(swv, spin_wilson_vector)
+make_all_array_field(ah, anti_hermitmat)
+
+/*------------------------------------------------------------------*/
+/* Site fields.  A site field holds a member that an application keeps
+   outside its site structure: a fixed number of bytes per site, in
+   site order.  It replaces the member and its F_OFFSET.  Generic code
+   reaches it through the SITE_* accessors in include/macros.h, and
+   gathers it with start_gather_strided().  Each site field is
+   registered by name, so code that does not know the application's
+   globals can look it up, and report_site_fields() (called from
+   report_mem_account) lists them. */
+
+#define MAX_SITE_FIELDS 8
+
+typedef struct {
+  char *name;
+  char *field;        /* NULL for an empty slot */
+  size_t bytes;       /* per site */
+} site_field_entry;
+
+static site_field_entry site_fields[MAX_SITE_FIELDS];
+
+void *create_site_field(char *name, size_t bytes, int tag){
+  int k, i;
+  char *x;
+
+  for(k = 0; k < MAX_SITE_FIELDS; k++)
+    if(site_fields[k].field == NULL)break;
+  if(k == MAX_SITE_FIELDS){
+    printf("create_site_field(%d): no slot for %s\n", this_node, name);
+    terminate(1);
+  }
+
+  x = (char *)field_alloc_tag(sites_on_node*bytes, tag);
+  if(x == NULL){
+    printf("create_site_field(%d): no room for %s\n", this_node, name);
+    terminate(1);
+  }
+  /* First touch in the partition the site loops use (see above) */
+  FORSOMEFIELDPARITY_OMP(i,EVEN,schedule(static)){
+    memset(x+i*bytes,'\0',bytes);
+  } END_LOOP_OMP;
+  FORSOMEFIELDPARITY_OMP(i,ODD,schedule(static)){
+    memset(x+i*bytes,'\0',bytes);
+  } END_LOOP_OMP;
+
+  site_fields[k].name = name;
+  site_fields[k].field = x;
+  site_fields[k].bytes = bytes;
+  return x;
+}
+
+void destroy_site_field(void *field){
+  int k;
+
+  if(field == NULL)return;
+  for(k = 0; k < MAX_SITE_FIELDS; k++)
+    if(site_fields[k].field == field){
+      site_fields[k].field = NULL;
+      break;
+    }
+  field_free(field);
+}
+
+/* The site field registered under name, or NULL if the member is
+   still in the site structure */
+void *find_site_field(char *name){
+  int k;
+
+  for(k = 0; k < MAX_SITE_FIELDS; k++)
+    if(site_fields[k].field != NULL && strcmp(site_fields[k].name, name) == 0)
+      return site_fields[k].field;
+  return NULL;
+}
+
+void report_site_fields(void){
+  int k;
+
+  for(k = 0; k < MAX_SITE_FIELDS; k++)
+    if(site_fields[k].field != NULL)
+      node0_printf("Site field %s: %lu bytes per site, %.1f MB per node\n",
+		   site_fields[k].name, (unsigned long)site_fields[k].bytes,
+		   sites_on_node*site_fields[k].bytes/1e6);
+}
+
+/* Gather one member, wherever it is kept.  Element i of the source is
+   at field + i*stride bytes.  For a site member, field is the member
+   of lattice[0] and stride is sizeof(site). */
+msg_tag *start_gather_strided(void *field, size_t stride, size_t size,
+			      int index, int parity, char **dest){
+  msg_tag *mt;
+
+  mt = declare_strided_gather(field, stride, size, index, parity, dest);
+  prepare_gather(mt);
+  do_gather(mt);
+
+  return mt;
+}
 
 /*------------------------------------------------------------------*/
 /* Linear operations on fields                                      */
@@ -178,7 +690,7 @@ su3_matrix **gauge_field_copy_site_to_field(field_offset src){
 
   dest = (su3_matrix **)malloc(4*sizeof(su3_matrix *));
   FORALLUPDIR(dir){
-    dest[dir] = (su3_matrix *)malloc(sites_on_node*sizeof(su3_matrix));
+    dest[dir] = (su3_matrix *)field_alloc(sites_on_node*sizeof(su3_matrix));
     if(dest[dir] == NULL){
       printf("gauge_field_copy_site_to_field: No room\n");
       return NULL;
@@ -223,7 +735,7 @@ void destroy_gauge_field(su3_matrix **f){
   if(f != NULL){
     FORALLUPDIR(dir){
       if(f[dir] != NULL)
-	free(f[dir]);
+	field_free(f[dir]);
     }
     free(f);
   }
@@ -281,7 +793,7 @@ void insert_v_from_c(su3_vector *v, complex *c, int color){
 /*--------------------------------------------------------------------*/
 ks_prop_field *create_ksp_field(int nc){
   ks_prop_field *ksp;
-  int color;
+  int color, tag;
   
   ksp = (ks_prop_field *)malloc(sizeof(ks_prop_field));
   if(ksp == NULL){
@@ -298,8 +810,10 @@ ks_prop_field *create_ksp_field(int nc){
     terminate(1);
   }
 
+  tag = set_mem_tag(MEM_PROPS);
   for(color= 0; color < nc; color++)
     ksp->v[color] = create_v_field();
+  set_mem_tag(tag);
   
   return ksp;
 }
@@ -414,7 +928,7 @@ spin_wilson_vector *extract_swv_from_wp(wilson_prop_field *wp, int color){
 /* Reallocates space for the spin wilson vectors */
 void rebuild_wp_field(wilson_prop_field *wp){
 
-  int color;
+  int color, tag;
 
   if(wp->nc <= 0){
     node0_printf("rebuild_wp_field: Illegal %d colors\n", wp->nc);
@@ -426,8 +940,10 @@ void rebuild_wp_field(wilson_prop_field *wp){
     terminate(1);
   }
 
+  tag = set_mem_tag(MEM_PROPS);
   for(color= 0; color < wp->nc; color++)
     wp->swv[color] = create_swv_field();
+  set_mem_tag(tag);
 }
 
 /*--------------------------------------------------------------------*/
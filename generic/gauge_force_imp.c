@@ -33,8 +33,9 @@ void printpath( int *path, int length );
 #define special_free free
 #endif
 
-/* update the momenta with the gauge force */
-void imp_gauge_force_cpu( Real eps, field_offset mom_off ){
+/* update the momenta with the gauge force.  The four momenta of site i
+   start at mom + i*stride bytes */
+static void gauge_force_cpu( Real eps, char *mom, size_t stride ){
     register int i,dir;
     register site *st;
     su3_matrix tmat1,tmat2;
@@ -59,8 +60,8 @@ void imp_gauge_force_cpu( Real eps, field_offset mom_off ){
     int nloop = get_nloop();
     int nreps = get_nreps();
 
-#ifdef GFTIME
     int nflop = 153004;  /* For Symanzik1 action */
+#ifdef GFTIME
     double dtime;
 #endif
     int j,k;
@@ -77,6 +78,7 @@ void imp_gauge_force_cpu( Real eps, field_offset mom_off ){
 #ifdef GFTIME
     dtime=-dclock();
 #endif
+    PERF_BEGIN("gauge_force");
 
     dirs = (int *)malloc(max_length*sizeof(int));
     if(dirs == NULL){
@@ -176,7 +178,7 @@ void imp_gauge_force_cpu( Real eps, field_offset mom_off ){
 			if(nreps > 1){
 node0_printf("WARNING: THIS CODE IS NOT TESTED\n"); exit(0);
 			    act2=1.0;
-			    action = 3.0 - realtrace_su3(&(st->link[dir]),
+			    action = 3.0 - realtrace_su3(&(SITE_LINK(i)[dir]),
 				&tmat1 ); 
 
 			    for(j=1;j<nreps;j++){
@@ -199,8 +201,8 @@ node0_printf("WARNING: THIS CODE IS NOT TESTED\n"); exit(0);
 
 	/* Now multiply the staple sum by the link, then update momentum */
 	FORALLSITES_OMP(i,st, private(tmat1,tmat2,momentum) ){
-	    mult_su3_na( &(st->link[dir]), &(staple[i]), &tmat1 );
-	    momentum = (anti_hermitmat *)F_PT(st,mom_off);
+	    mult_su3_na( &(SITE_LINK(i)[dir]), &(staple[i]), &tmat1 );
+	    momentum = (anti_hermitmat *)(mom + i*stride);
 	    uncompress_anti_hermitian( &momentum[dir], &tmat2 );
 	    scalar_mult_sub_su3_matrix( &tmat2, &tmat1,
 		eb3, &(staple[i]) );
@@ -212,12 +214,23 @@ dtime+=dclock();
 node0_printf("GFTIME:   time = %e (Symanzik1) mflops = %e\n",dtime,
 	     nflop*(double)volume/(1e6*dtime*numnodes()) );
 #endif
+ PERF_END("gauge_force", nflop*(double)sites_on_node, 0);
  free(path_dir);
  free(dirs);
  destroy_G(links);
  special_free(staple); 
  special_free(tempmat1); 
-} /* imp_gauge_force_cpu.c */
+} /* gauge_force_cpu */
+
+/* momenta in the site structure */
+void imp_gauge_force_cpu( Real eps, field_offset mom_off ){
+  gauge_force_cpu(eps, F_PT(lattice, mom_off), sizeof(site));
+}
+
+/* momenta in a field, four per site */
+void imp_gauge_force_cpu_field( Real eps, anti_hermitmat *mom ){
+  gauge_force_cpu(eps, (char *)mom, 4*sizeof(anti_hermitmat));
+}
 
 /* Wrapper for backward compatibility */
 void imp_gauge_force( Real eps, field_offset mom_off ){
@@ -33,12 +33,35 @@ su3_matrix * create_G_from_site(void){
 
   FORALLUPDIR(dir){
     FORALLSITES_OMP(i,s,){
-      t_links[4*i+dir] = lattice[i].link[dir];
+      t_links[4*i+dir] = SITE_LINK(i)[dir];
     } END_LOOP_OMP;
   }
   return t_links;
 }
 
+/*--------------------------------------------------------------------*/
+/* Copy the gauge links into a G field and back */
+
+void copy_site_to_G(su3_matrix *t_links){
+  int i, dir;
+
+  FORALLFIELDSITES_OMP(i,private(dir)){
+    FORALLUPDIR(dir){
+      t_links[4*i+dir] = SITE_LINK(i)[dir];
+    }
+  } END_LOOP_OMP;
+}
+
+void copy_G_to_site(su3_matrix *t_links){
+  int i, dir;
+
+  FORALLFIELDSITES_OMP(i,private(dir)){
+    FORALLUPDIR(dir){
+      SITE_LINK(i)[dir] = t_links[4*i+dir];
+    }
+  } END_LOOP_OMP;
+}
+
 #endif
 
 /*--------------------------------------------------------------------*/
@@ -80,7 +103,7 @@ su3_matrix * create_G2_from_site(void){
 
   FORALLUPDIR(dir){
     FORALLSITES_OMP(i,s,){
-      t_links[i+dir*sites_on_node] = lattice[i].link[dir];
+      t_links[i+dir*sites_on_node] = SITE_LINK(i)[dir];
     } END_LOOP_OMP;
   }
   return t_links;
@@ -115,7 +115,7 @@ void accum_gauge_hit(int gauge_dir,int parity)
     FORALLUPDIRBUT(gauge_dir,dir)
       {
 	/* Upward link matrix */
-	m1 = &(s->link[dir]);
+	m1 = &(SITE_LINK(i)[dir]);
 	sub_su3_matrix( &diffmatp[i], m1, &diffmatp[i]); 
 	for(j=0;j<3;j++)CSUM( sumvecp[i].c[j],m1->e[j][j]);
       }
@@ -206,7 +206,7 @@ void do_hit(int gauge_dir, int parity, int p, int q, Real relax_boost,
     /* Do SU(2) hit on all upward links */
     
     FORALLUPDIR(dir)
-      left_su2_hit_n(&u,p,q,&(s->link[dir]));
+      left_su2_hit_n(&u,p,q,&(SITE_LINK(i)[dir]));
     
     /* Do SU(2) hit on all downward links */
     
@@ -264,7 +264,7 @@ double get_gauge_fix_action(int gauge_dir,int parity)
   FORSOMEPARITY_OMP(i,s,parity,private(dir,m1,m2) reduction(+:gauge_fix_action)){
     FORALLUPDIRBUT(gauge_dir,dir)
       {
-	m1 = &(s->link[dir]);
+	m1 = &(SITE_LINK(i)[dir]);
 	m2 = (su3_matrix *)gen_pt[dir][i];
 	
 	//trace = trace_su3(m1);
@@ -313,8 +313,7 @@ void gaugefixstep(int gauge_dir,double *av_gauge_fix_action,Real relax_boost,
       
       FORALLUPDIR(dir)
 	{
-	  mtag[dir] = start_gather_site( F_OFFSET(link[dir]), sizeof(su3_matrix),
-			   OPP_DIR(dir), parity, gen_pt[dir] );
+	  mtag[dir] = start_gather_link( dir, OPP_DIR(dir), parity, gen_pt[dir] );
 	}
       
       /* Wait for gathers */
@@ -378,7 +377,7 @@ void gaugefixstep(int gauge_dir,double *av_gauge_fix_action,Real relax_boost,
 	  
 	  /* Copy modified matrices into proper location */
 	  FORSOMEPARITY_OMP(i,s,OPP_PAR(parity),){
-	    su3mat_copy((su3_matrix *)(gen_pt[dir][i]),&(s->link[dir]));
+	    su3mat_copy((su3_matrix *)(gen_pt[dir][i]),&(SITE_LINK(i)[dir]));
 	  } END_LOOP_OMP;
 
 	  cleanup_gather(mtag[dir]);
@@ -28,6 +28,7 @@ gauge_file *save_lattice( int flag, char *filename, char *stringLFN){
 #endif
 
     dtime = -dclock();
+    PERF_BEGIN("save_lattice");
     switch( flag ){
         case FORGET:
             gf = NULL;
@@ -119,6 +120,8 @@ gauge_file *save_lattice( int flag, char *filename, char *stringLFN){
 	    terminate(1);
     }
     dtime += dclock();
+    PERF_END("save_lattice", 0, flag == FORGET ? 0 :
+	     4.*sites_on_node*sizeof(su3_matrix));
     if(flag != FORGET)
       node0_printf("Time to save = %e\n",dtime);
 #if (MILC_PRECISION==1)
@@ -151,6 +154,7 @@ gauge_file *reload_lattice( int flag, char *filename){
 #endif
 
     dtime = -dclock();
+    PERF_BEGIN("reload_lattice");
     switch(flag){
 	case CONTINUE:	/* return NULL.  We lose information if we do this  */
  	    node0_printf("reload_lattice: WARNING: gaugefile struct set to NULL\n");
@@ -178,6 +182,9 @@ gauge_file *reload_lattice( int flag, char *filename){
 	    terminate(1);
     }
     dtime += dclock();
+    PERF_END("reload_lattice", 0,
+	     flag == FRESH || flag == WARM || flag == CONTINUE ? 0 :
+	     4.*sites_on_node*sizeof(su3_matrix));
     if(flag != FRESH && flag != WARM && flag != CONTINUE)
       node0_printf("Time to reload gauge configuration = %e\n",dtime);
 #ifdef SCHROED_FUN
@@ -537,10 +544,10 @@ void coldlat(void){
 	    for(j=0; j<3; j++)  {
 		for(k=0; k<3; k++)  {
 		    if (j != k)  {
-		       sit->link[dir].e[j][k] = cmplx(0.0,0.0);
+		       SITE_LINK(i)[dir].e[j][k] = cmplx(0.0,0.0);
 		    }
 		    else  {
-		       sit->link[dir].e[j][k] = cmplx(1.0,0.0);
+		       SITE_LINK(i)[dir].e[j][k] = cmplx(1.0,0.0);
 		    }
 		}
 	    }
@@ -562,14 +569,14 @@ void warmlat(void)
 	  Real x = 0.7*gaussian_rand_no(&(sit->site_prn));
 	  Real y = 0.7*gaussian_rand_no(&(sit->site_prn));
 	  if (j != k)  {
-	    sit->link[dir].e[j][k] = cmplx(x,y);
+	    SITE_LINK(i)[dir].e[j][k] = cmplx(x,y);
 	  }
 	  else  {
-	    sit->link[dir].e[j][k] = cmplx(1.0+x,y);
+	    SITE_LINK(i)[dir].e[j][k] = cmplx(1.0+x,y);
 	  }
 	}
       }
-      reunit_su3((su3_matrix *)&(sit->link[dir]));
+      reunit_su3((su3_matrix *)&(SITE_LINK(i)[dir]));
     }
   }
   node0_printf("warm gauge configuration loaded\n");
@@ -584,15 +591,15 @@ void funnylat(void)  {
 	for(dir=XUP;dir<=TUP;dir++){
 	    for(j=0; j<3; ++j)  {
 		for(k=0; k<3; ++k)  {
-		    sit->link[dir].e[j][k] = cmplx(0.0,0.0);
+		    SITE_LINK(i)[dir].e[j][k] = cmplx(0.0,0.0);
 		}
 	    }
-	    sit->link[dir].e[0][0].real = dir;
-	    sit->link[dir].e[1][1].real = 10*sit->x;
-	    sit->link[dir].e[2][2].real = 100*sit->y;
-	    sit->link[dir].e[0][0].imag = dir;
-	    sit->link[dir].e[1][1].imag = 10*sit->z;
-	    sit->link[dir].e[2][2].imag = 100*sit->t;
+	    SITE_LINK(i)[dir].e[0][0].real = dir;
+	    SITE_LINK(i)[dir].e[1][1].real = 10*sit->x;
+	    SITE_LINK(i)[dir].e[2][2].real = 100*sit->y;
+	    SITE_LINK(i)[dir].e[0][0].imag = dir;
+	    SITE_LINK(i)[dir].e[1][1].imag = 10*sit->z;
+	    SITE_LINK(i)[dir].e[2][2].imag = 100*sit->t;
 	}
     }
 }
@@ -235,7 +235,7 @@ static void w_serial_old(gauge_file *gf)
 	  if(currentnode==0)
 	    {
 	      i=node_index(x,y,z,t);
-	      d2f_4mat(&lattice[i].link[0],tbuf);
+	      d2f_4mat(&SITE_LINK(i)[0],tbuf);
 	    }
 	  else
 	    {
@@ -282,7 +282,7 @@ static void w_serial_old(gauge_file *gf)
 	    i=node_index(x,y,z,t);
 	    /* Convert 4 matrices from generic to single precision in
 	       tbuf and send */
-	    d2f_4mat(&lattice[i].link[0],tbuf);
+	    d2f_4mat(&SITE_LINK(i)[0],tbuf);
 	    send_field((char *)tbuf,4*sizeof(fsu3_matrix),0);
 	  }
 	}
@@ -491,7 +491,7 @@ static void w_serial(gauge_file *gf)
       if(this_node == currentnode)
 	{
 	  i=node_index(x,y,z,t);
-	  d2f_4mat(&lattice[i].link[0],&tbuf[4*tbuf_length]);
+	  d2f_4mat(&SITE_LINK(i)[0],&tbuf[4*tbuf_length]);
 	}
 
       if(this_node == currentnode || this_node == 0)tbuf_length++;
@@ -708,7 +708,7 @@ static void r_serial(gauge_file *gf)
 	    }
 	  /* Copy 4 matrices to lattice[idest], converting to generic
 	     precision */
-	  f2d_4mat(tmpsu3,&lattice[idest].link[0]);
+	  f2d_4mat(tmpsu3,&SITE_LINK(idest)[0]);
 	}
       else
 	{
@@ -906,7 +906,7 @@ static void r_serial_arch(gauge_file *gf)
 	  i = node_index(x,y,z,t);
      /*   printf("lattice node_index = %d, mu = %d\n", i, mu); */
 	  /* Copy from tmpsu3 to site structure */
-	  memcpy((void *)lattice[i].link,(void *)tmpsu3,4*sizeof(su3_matrix));
+	  memcpy((void *)SITE_LINK(i),(void *)tmpsu3,4*sizeof(su3_matrix));
 	} else {		
 	  /* send to correct node */
 	  send_field((char *)tmpsu3, 4*sizeof(su3_matrix),destnode);
@@ -919,7 +919,7 @@ static void r_serial_arch(gauge_file *gf)
 	  i = node_index(x,y,z,t);
 	  get_field((char *)tmpsu3,4*sizeof(su3_matrix),0);
 	  /* Store in site structure, converting to generic precision */
-	  memcpy((void *)lattice[i].link,(void *)tmpsu3,4*sizeof(su3_matrix));
+	  memcpy((void *)SITE_LINK(i),(void *)tmpsu3,4*sizeof(su3_matrix));
 	}
       }
 
@@ -1069,7 +1069,7 @@ static void w_parallel(gauge_file *gf)
 	      i = node_index(x,y,z,t);
 	      /* Copy 4 matrices and convert to single precision msg
 		 structure */
-	      d2f_4mat(&lattice[i].link[0],&msg.link[0]);
+	      d2f_4mat(&SITE_LINK(i)[0],&msg.link[0]);
 
 	      send_field((char *)&msg,sizeof(msg),destnode);
 	    }
@@ -1079,7 +1079,7 @@ static void w_parallel(gauge_file *gf)
 		/* just copy links to write buffer */
 		i = node_index(x,y,z,t);
 		where_in_buf = buf_length;
-		d2f_4mat(&lattice[i].link[0],&lbuf[4*where_in_buf]);
+		d2f_4mat(&SITE_LINK(i)[0],&lbuf[4*where_in_buf]);
 		rank29 = rank31 = 
 		  4*sizeof(fsu3_matrix)/sizeof(int32type)*rcv_rank;
 	      }
@@ -1209,7 +1209,7 @@ static void w_checkpoint(gauge_file *gf)
         
     /* load the gauge configuration into the buffer */
     /* convert (copy) generic to single precision */
-    d2f_4mat(&lattice[i].link[0],&lbuf[4*buf_length]);
+    d2f_4mat(&SITE_LINK(i)[0],&lbuf[4*buf_length]);
 
     /* Accumulate checksums - contribution from next site moved into buffer*/
     for(k = 0, val = (u_int32type *)&lbuf[4*buf_length]; 
@@ -1502,7 +1502,7 @@ static void r_parallel(gauge_file *gf)
 	      /* just copy links, converting to generic precision */
 	      i = node_index(x,y,z,t);
 	      f2d_4mat((fsu3_matrix *)&lbuf[4*where_in_buf],
-		       &lattice[i].link[0]);
+		       &SITE_LINK(i)[0]);
 	    }
 	    else {		
 	      /* send to correct node */
@@ -1528,7 +1528,7 @@ static void r_parallel(gauge_file *gf)
 		}
 	      /* Store in the proper location, converting to generic
 		 precision */
-	      f2d_4mat(&msg.link[0],&lattice[i].link[0]);
+	      f2d_4mat(&msg.link[0],&SITE_LINK(i)[0]);
 	    }
 	  }
 	} /** end over the lattice sites in block on all nodes ***/
@@ -1688,7 +1688,7 @@ gauge_file *restore_ascii(char *filename) {
       }
       if(destnode==0){	/* just copy links */
 	i = node_index(x,y,z,t);
-	f2d_4mat(lbuf, lattice[i].link);
+	f2d_4mat(lbuf, SITE_LINK(i));
       }
       else {		/* send to correct node */
 	send_field((char *)lbuf,4*sizeof(fsu3_matrix),destnode);
@@ -1700,7 +1700,7 @@ gauge_file *restore_ascii(char *filename) {
       if(this_node==destnode){
 	get_field((char *)lbuf,4*sizeof(fsu3_matrix),0);
 	i = node_index(x,y,z,t);
-	f2d_4mat(lbuf, lattice[i].link);
+	f2d_4mat(lbuf, SITE_LINK(i));
       }
     }
   }
@@ -1779,7 +1779,7 @@ gauge_file *save_ascii(char *filename) {
     if(this_node==0){
       if(currentnode==0){
 	i=node_index(x,y,z,t);
-	d2f_4mat(lattice[i].link, lbuf);
+	d2f_4mat(SITE_LINK(i), lbuf);
       }
       else{
 	get_field((char *)lbuf,4*sizeof(fsu3_matrix),currentnode);
@@ -1796,7 +1796,7 @@ gauge_file *save_ascii(char *filename) {
     else {	/* for nodes other than 0 */
       if(this_node==currentnode){
 	i=node_index(x,y,z,t);
-	d2f_4mat(lattice[i].link, lbuf);
+	d2f_4mat(SITE_LINK(i), lbuf);
 	send_field((char *)lbuf,4*sizeof(fsu3_matrix),0);
       }
     }
@@ -1945,7 +1945,6 @@ gauge_file *save_serial_archive(char *filename) {
   gauge_header *gh;
 
   FILE *outfile = NULL;
-  site *s;
   u_int32type chksum;
   char sums[30];
   OUTPUT_TYPE *uout = NULL;
@@ -2034,14 +2033,14 @@ gauge_file *save_serial_archive(char *filename) {
 
       if(this_node==0){
 	if(currentnode==0){
-	  s = &lattice[node_index(x,y,z,tslice)];
+	  i = node_index(x,y,z,tslice);
 	  for(mu=0; mu<4; ++mu) {
 	    for(a=0; a<2; ++a) {
 	      for(b=0; b<3; ++b) {
 		uout[2*(b+3*a)+12*mu+48*j] 
-		    = (OUTPUT_TYPE) s->link[mu].e[a][b].real;
+		    = (OUTPUT_TYPE) SITE_LINK(i)[mu].e[a][b].real;
 		uout[1+2*(b+3*a)+12*mu+48*j] 
-		    = (OUTPUT_TYPE) s->link[mu].e[a][b].imag;
+		    = (OUTPUT_TYPE) SITE_LINK(i)[mu].e[a][b].imag;
 	      }
 	    }
 	  }
@@ -2064,7 +2063,7 @@ gauge_file *save_serial_archive(char *filename) {
       else {	/* for nodes other than 0 */
 	if(this_node==currentnode){
 	  i=node_index(x,y,z,tslice);
-	  for(dir=XUP;dir<=TUP;dir++)lbuf[dir]=lattice[i].link[dir];
+	  for(dir=XUP;dir<=TUP;dir++)lbuf[dir]=SITE_LINK(i)[dir];
 	  send_field((char *)lbuf,4*sizeof(su3_matrix),0);
 	}
       }
@@ -196,7 +196,9 @@ gauge_file *save_scidac(char *filename, int volfmt, int serpar, int ildgstyle,
   QIO_Filesystem fs;
   QIO_Writer *outfile;
   int status;
+#ifndef LINK_FIELD
   field_offset src = F_OFFSET(link[0]);
+#endif
   gauge_file *gf;
   char *info;
   QIO_String *filexml;
@@ -231,7 +233,11 @@ gauge_file *save_scidac(char *filename, int volfmt, int serpar, int ildgstyle,
   QIO_string_set(recxml, info);
 
   /* Write the lattice field */
+#ifdef LINK_FIELD
+  status = write_F3_M_from_field(outfile, recxml, link_field, LATDIM);
+#else
   status = write_F3_M_from_site(outfile, recxml, src, LATDIM);
+#endif
   if(status)terminate(1);
 
   /* Discard for now */
@@ -370,7 +376,9 @@ static gauge_file *restore_scidac(char *filename, int serpar){
   QIO_String *recxml;
   int status;
   int typesize;
+#ifndef LINK_FIELD
   field_offset dest = F_OFFSET(link[0]);
+#endif
   gauge_file *gf;
 
   QIO_verbose(QIO_VERB_OFF);
@@ -400,10 +408,17 @@ static gauge_file *restore_scidac(char *filename, int serpar){
 
   /* Read the lattice field as single or double precision according to
      the type size (bytes in a single SU(3) matrix) */
+#ifdef LINK_FIELD
+  if(typesize == 72)
+    status = read_F3_M_to_field(infile, recxml, link_field, LATDIM);
+  else if (typesize == 144)
+    status = read_D3_M_to_field(infile, recxml, link_field, LATDIM);
+#else
   if(typesize == 72)
     status = read_F3_M_to_site(infile, recxml, dest, LATDIM);
   else if (typesize == 144)
     status = read_D3_M_to_site(infile, recxml, dest, LATDIM);
+#endif
   else
     {
       node0_printf("restore_scidac: Bad typesize %d\n",typesize);
@@ -56,6 +56,19 @@
    even_sites_on_node  Number of even sites on this PE
    odd_sites_on_node   Number of odd sites on this PE
 
+   With -DHYPER_NODE_LOCAL (plain MPI only, not QMP or Grid) the PE
+   ranks sharing a physical node, as reported by pes_per_node(), are
+   given a rectangular block of the PE grid instead of a lexicographic
+   run of it.  The block shape is chosen to minimize the halo that
+   leaves the node.  Ranks are then numbered block by block, and
+   lexicographically within each block.
+
+   With -DHYPER_MORTON the sites within each PE are ordered along a
+   Morton curve instead of lexicographically, still with the even
+   sites first.  Neighbors on the lattice are then mostly close in
+   memory as well.  The neighbor tables and gathers are built from
+   node_index() and get_coords(), so they follow automatically.
+
 */
 
 #include "generic_includes.h"
@@ -77,6 +90,17 @@ static int pes_per_iopartition[4];    /* dimensions (number of MPI PEs) in one
 				      I/O partition. Must be a divisor of nsquares */
 static int *ionodegeomvals = NULL; /* number of I/O partitions in each direction */
 
+#if defined(HYPER_NODE_LOCAL) && !defined(HAVE_QMP) && !defined(HAVE_GRID)
+#define NODE_LOCAL_LAYOUT
+static int node_block[4] = {1, 1, 1, 1}; /* PE grid dimensions of one
+					    physical node */
+static int nblocks[4];		   /* number of node blocks in each direction */
+#endif
+
+#if defined(HYPER_MORTON) && defined(HAVE_QUDA)
+#error "HYPER_MORTON is not supported with QUDA, which expects the lexicographic site order"
+#endif
+
 int prime[] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47, 53};
 # define MAXPRIMES ( sizeof(prime) / sizeof(int) )
 
@@ -115,6 +139,221 @@ static size_t lex_rank(const int coords[], int dim, int size[])
   return rank;
 }
 
+#ifdef NODE_LOCAL_LAYOUT
+
+/*------------------------------------------------------------------*/
+/* Convert PE rank to PE grid coordinates, node block by node block */
+
+static void pe_coords(int mc[], const size_t rank)
+{
+  int d, bc[4], ic[4];
+  size_t ppn = node_block[0]*node_block[1]*node_block[2]*node_block[3];
+
+  lex_coords(bc, 4, nblocks, rank/ppn);
+  lex_coords(ic, 4, node_block, rank%ppn);
+  for(d = 0; d < 4; d++)
+    mc[d] = bc[d]*node_block[d] + ic[d];
+}
+
+/*------------------------------------------------------------------*/
+/* Convert PE grid coordinates to PE rank (inverse of pe_coords) */
+
+static size_t pe_rank(const int mc[])
+{
+  int d, bc[4], ic[4];
+  size_t ppn = node_block[0]*node_block[1]*node_block[2]*node_block[3];
+
+  for(d = 0; d < 4; d++){
+    bc[d] = mc[d]/node_block[d];
+    ic[d] = mc[d]%node_block[d];
+  }
+  return lex_rank(bc, 4, nblocks)*ppn + lex_rank(ic, 4, node_block);
+}
+
+/*------------------------------------------------------------------*/
+/* Fraction of the halo sites of all PEs whose neighbor PE is on the
+   same physical node, assuming ppn consecutive ranks per node.  If
+   lex is set, use the plain lexicographic rank order for comparison. */
+
+static double on_node_halo_fraction(int ppn, int lex)
+{
+  int d, s, mc[4];
+  size_t rank, nbr;
+  double face, on = 0., all = 0.;
+  int sites = squaresize[0]*squaresize[1]*squaresize[2]*squaresize[3];
+
+  for(rank = 0; rank < (size_t)numnodes(); rank++){
+    for(d = 0; d < 4; d++){
+      if(nsquares[d] == 1)continue;
+      face = (double)sites/squaresize[d];
+      for(s = -1; s <= 1; s += 2){
+	if(lex) lex_coords(mc, 4, nsquares, rank);
+	else pe_coords(mc, rank);
+	mc[d] = (mc[d] + s + nsquares[d]) % nsquares[d];
+	nbr = lex ? lex_rank(mc, 4, nsquares) : pe_rank(mc);
+	all += face;
+	if(nbr/ppn == rank/ppn) on += face;
+      }
+    }
+  }
+  return all > 0. ? on/all : 1.;
+}
+
+/*------------------------------------------------------------------*/
+/* Choose the PE block that goes on one physical node.  Among the
+   divisors of nsquares whose volume is pes_per_node(), take the one
+   with the least halo surface leaving the node.  A direction that is
+   not split across nodes has no such surface. */
+
+static void setup_node_block(){
+  int d, e, r[4];
+  int ppn = pes_per_node();
+  double surf, face, best = -1.;
+
+  for(d = 0; d < 4; d++){
+    node_block[d] = 1;
+    nblocks[d] = nsquares[d];
+  }
+
+  if(ppn > 1 && numnodes() % ppn == 0){
+    for(r[3] = 1; r[3] <= nsquares[3]; r[3]++)
+    for(r[2] = 1; r[2] <= nsquares[2]; r[2]++)
+    for(r[1] = 1; r[1] <= nsquares[1]; r[1]++)
+    for(r[0] = 1; r[0] <= nsquares[0]; r[0]++){
+      if(r[0]*r[1]*r[2]*r[3] != ppn)continue;
+      if(nsquares[0]%r[0] || nsquares[1]%r[1] ||
+	 nsquares[2]%r[2] || nsquares[3]%r[3])continue;
+      surf = 0.;
+      for(d = 0; d < 4; d++){
+	if(nsquares[d] == r[d])continue;
+	face = 1.;
+	for(e = 0; e < 4; e++)
+	  if(e != d)face *= (double)r[e]*squaresize[e];
+	surf += face;
+      }
+      if(best < 0. || surf < best){
+	best = surf;
+	for(d = 0; d < 4; d++)node_block[d] = r[d];
+      }
+    }
+  }
+
+  for(d = 0; d < 4; d++)
+    nblocks[d] = nsquares[d]/node_block[d];
+
+  if(mynode()==0){
+    printf("NODE LOCAL LAYOUT: %d PEs per node as %d x %d x %d x %d\n", ppn,
+	   node_block[XUP], node_block[YUP], node_block[ZUP], node_block[TUP]);
+    if(ppn > 1){
+      double f = on_node_halo_fraction(ppn, 0);
+      printf("NODE LOCAL LAYOUT: halo sites on-node %.1f%% off-node %.1f%%",
+	     100.*f, 100.*(1.-f));
+      printf(" (lexicographic order %.1f%% on-node)\n",
+	     100.*on_node_halo_fraction(ppn, 1));
+    }
+  }
+}
+#endif
+
+#ifdef HYPER_MORTON
+
+/*------------------------------------------------------------------*/
+/* Site order within a PE rank along a Morton (Z-order) curve.  Each
+   sublattice dimension is factored into primes, smallest first.  The
+   curve position takes one digit per factor, interleaving the four
+   directions level by level, so the order sweeps 2^4 tiles, then 4^4
+   tiles made of them, and so on.  For power-of-two dimensions this
+   is the usual bit-interleaved Morton order.  Even sites still come
+   first, each parity in curve order. */
+
+#define MAXLEVELS 32
+static int nlevels;			 /* number of digit levels */
+static int level_factor[MAXLEVELS][4];	 /* radix of each level and
+					    direction (1 if used up) */
+static int *morton_rank = NULL;		 /* position among the sites of
+					    the same sublattice parity, by
+					    sublattice lexicographic index */
+static int *morton_site[2] = {NULL, NULL}; /* sublattice lexicographic
+					      index, by sublattice parity
+					      and position */
+
+/*------------------------------------------------------------------*/
+/* Sublattice coordinates of the site at a given curve position */
+
+static void morton_coords(int c[], size_t key){
+  int d, k, digit, scale[4] = {1, 1, 1, 1};
+
+  for(d = 0; d < 4; d++)c[d] = 0;
+  for(k = 0; k < nlevels; k++)
+    for(d = 0; d < 4; d++){
+      digit = key % level_factor[k][d];
+      key /= level_factor[k][d];
+      c[d] += digit*scale[d];
+      scale[d] *= level_factor[k][d];
+    }
+}
+
+/*------------------------------------------------------------------*/
+static void setup_morton(){
+  int d, i, k, m, p, c[4];
+  int n[2] = {0, 0};
+  size_t key, lex;
+
+  /* Prime factors of each dimension, smallest first */
+  for(k = 0; k < MAXLEVELS; k++)
+    for(d = 0; d < 4; d++)
+      level_factor[k][d] = 1;
+  nlevels = 0;
+  for(d = 0; d < 4; d++){
+    m = squaresize[d];
+    for(i = 0, k = 0; m > 1; ){
+      if(i >= MAXPRIMES || k >= MAXLEVELS){
+	node0_printf("setup_morton: can't factor sublattice dimension %d\n",
+		     squaresize[d]);
+	terminate(1);
+      }
+      if(m % prime[i] == 0){
+	level_factor[k++][d] = prime[i];
+	m /= prime[i];
+      }
+      else i++;
+    }
+    if(k > nlevels)nlevels = k;
+  }
+
+  morton_rank = (int *)malloc(sites_on_node*sizeof(int));
+  morton_site[0] = (int *)malloc(((sites_on_node+1)/2)*sizeof(int));
+  morton_site[1] = (int *)malloc(((sites_on_node+1)/2)*sizeof(int));
+  if(morton_rank == NULL || morton_site[0] == NULL || morton_site[1] == NULL){
+    printf("setup_morton(%d): no room for the site order tables\n", mynode());
+    terminate(1);
+  }
+
+  /* Walk the curve, numbering the sites of each parity in turn */
+  for(key = 0; key < sites_on_node; key++){
+    morton_coords(c, key);
+    lex = lex_rank(c, 4, squaresize);
+    p = coord_parity(c);
+    morton_rank[lex] = n[p];
+    morton_site[p][n[p]++] = lex;
+  }
+
+  if(mynode() == 0)
+    printf("Morton site order within each rank, %d levels\n", nlevels);
+}
+
+/*------------------------------------------------------------------*/
+/* Parity of the sublattice origin of the PE with coordinates mc.
+   The sites of this parity in the sublattice are the even ones. */
+
+static int origin_parity(const int mc[]){
+  int d, p = 0;
+  for(d = 0; d < 4; d++)p += mc[d]*squaresize[d];
+  return p % 2;
+}
+
+#endif
+
 #ifdef HAVE_QMP
 
 /*--------------------------------------------------------------------*/
@@ -432,6 +671,10 @@ void setup_layout(){
 
   set_topology();
 
+#ifdef NODE_LOCAL_LAYOUT
+  setup_node_block();
+#endif
+
 #ifdef HAVE_GRID
 
   /* Initlalize Grid */
@@ -457,6 +700,8 @@ void setup_layout(){
   /* Compute machine coordinates for this node */
 #ifdef HAVE_GRID
   grid_coor_from_processor_rank(machine_coordinates, mynode());
+#elif defined(NODE_LOCAL_LAYOUT)
+  pe_coords(machine_coordinates, mynode());
 #else
   lex_coords(machine_coordinates, 4, nsquares, mynode());
 #endif
@@ -480,6 +725,10 @@ void setup_layout(){
 
   odd_sites_on_node = sites_on_node - even_sites_on_node;
 
+#ifdef HYPER_MORTON
+  setup_morton();
+#endif
+
 }
 
 /*------------------------------------------------------------------*/
@@ -495,6 +744,9 @@ int node_number(int x, int y, int z, int t) {
 #ifdef HAVE_QMP
   int proc_coords[4] = {x, y, z, t};
   i = QMP_get_node_number_from(proc_coords);
+#elif defined(NODE_LOCAL_LAYOUT)
+  int mc[4] = {x, y, z, t};
+  i = pe_rank(mc);
 #else
   i = x + nsquares[XUP]*( y + nsquares[YUP]*( z + nsquares[ZUP]*( t )));
 #endif
@@ -511,6 +763,18 @@ size_t node_index(int x, int y, int z, int t) {
     xr = x%squaresize[XUP]; yr = y%squaresize[YUP];
     zr = z%squaresize[ZUP]; tr = t%squaresize[TUP];
     i = xr + squaresize[XUP]*( yr + squaresize[YUP]*( zr + squaresize[ZUP]*tr));
+#ifdef HYPER_MORTON
+    /* op = the parity of the sublattice origin.  Odd sites follow
+       the even ones, of which there are one more if op is even and
+       the sublattice volume is odd. */
+    if( (x+y+z+t)%2==0 ){	/* even site */
+	return( morton_rank[i] );
+    }
+    else {
+	size_t op = (xr+yr+zr+tr+x+y+z+t)%2;
+	return( (sites_on_node + 1 - op)/2 + morton_rank[i] );
+    }
+#endif
     if( (x+y+z+t)%2==0 ){	/* even site */
 	return( i/2 );
     }
@@ -543,7 +807,7 @@ const int *get_logical_coordinate(){
 void get_coords(int coords[], int node, size_t index){
   int mc[4];
   size_t ir;
-  size_t meo, neven, xeo;
+  size_t meo, neven;
   int k = node;
 
   /* mc = the machine coordinates for node k */
@@ -552,17 +816,38 @@ void get_coords(int coords[], int node, size_t index){
 #else
 #ifdef HAVE_QMP
   QMP_comm_get_logical_coordinates_from2(QMP_comm_get_default(), mc, k);
+#elif defined(NODE_LOCAL_LAYOUT)
+  pe_coords(mc, k);
 #else
   lex_coords(mc, 4, nsquares, k);
 #endif
 #endif
 
+#ifdef HYPER_MORTON
+  /* meo = the parity of the sublattice origin */
+  meo = origin_parity(mc);
+#else
   /* meo = the parity of the machine coordinate */
   meo = coord_parity(mc);
+#endif
 
   /* neven = the number of even sites on node k */
   neven = (sites_on_node + 1 - meo)/2;
   
+#ifdef HYPER_MORTON
+  /* Sites of sublattice parity meo are the even ones */
+  if(index < neven)
+    ir = morton_site[meo][index];
+  else
+    ir = morton_site[1-meo][index - neven];
+  lex_coords(coords, 4, squaresize, ir);
+  coords[XUP] += mc[XUP]*squaresize[XUP];
+  coords[YUP] += mc[YUP]*squaresize[YUP];
+  coords[ZUP] += mc[ZUP]*squaresize[ZUP];
+  coords[TUP] += mc[TUP]*squaresize[TUP];
+#else
+  size_t xeo;
+
   /* ir = the even part of the lexicographic index within the
      sublattice on node k */
   if(index < neven){
@@ -598,6 +883,7 @@ void get_coords(int coords[], int node, size_t index){
       }
     }
   }
+#endif
 
   /* Consistency checks for debugging */
   if((k = node_number(coords[0], coords[1], coords[2], coords[3])) 
@@ -635,6 +921,8 @@ int io_node(const int node){
   /* Get the PE coordinates for the specified PE rank */
 #ifdef HAVE_GRID
   grid_coor_from_processor_rank(io_node_coords, node);
+#elif defined(NODE_LOCAL_LAYOUT)
+  pe_coords(io_node_coords, node);
 #else
   lex_coords(io_node_coords, 4, nsquares, node);
 #endif
@@ -648,6 +936,8 @@ int io_node(const int node){
 #ifdef HAVE_GRID
   return grid_rank_from_processor_coor(io_node_coords[0], 
 	     io_node_coords[1], io_node_coords[2], io_node_coords[3]);
+#elif defined(NODE_LOCAL_LAYOUT)
+  return (int)pe_rank(io_node_coords);
 #else
   return (int)lex_rank(io_node_coords, 4, nsquares);
 #endif
@@ -32,6 +32,7 @@ void make_lattice(){
     printf("NODE %d: no room for lattice\n",this_node);
     terminate(1);
   }
+  mem_account(MEM_LATTICE, (double)sites_on_node * sizeof(site));
 
   /* Allocate address vectors */
   for(i=0;i<N_POINTERS;i++){
@@ -41,6 +42,26 @@ void make_lattice(){
       terminate(1);
     }
   }
+  mem_account(MEM_LATTICE, (double)N_POINTERS * sites_on_node * sizeof(char *));
+
+#ifdef OMP
+  /* First touch by the threads that will work on these sites, so the
+     pages land in their NUMA domains.  Even and odd sites are split
+     among the threads separately, as in the parity loops */
+  {
+    int j;
+#pragma omp parallel for private(j) schedule(static)
+    for(i=0;i<even_sites_on_node;i++){
+      memset(&lattice[i], 0, sizeof(site));
+      for(j=0;j<N_POINTERS;j++)gen_pt[j][i] = NULL;
+    }
+#pragma omp parallel for private(j) schedule(static)
+    for(i=even_sites_on_node;i<sites_on_node;i++){
+      memset(&lattice[i], 0, sizeof(site));
+      for(j=0;j<N_POINTERS;j++)gen_pt[j][i] = NULL;
+    }
+  }
+#endif
   
   for(t=0;t<nt;t++)for(z=0;z<nz;z++)for(y=0;y<ny;y++)for(x=0;x<nx;x++){
     if(node_number(x,y,z,t)==mynode()){
@@ -69,4 +90,6 @@ void free_lattice()
 #else
   free(lattice);
 #endif
+  mem_account(MEM_LATTICE, -(double)sites_on_node *
+	      (sizeof(site) + N_POINTERS * sizeof(char *)));
 }
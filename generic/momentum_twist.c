@@ -56,10 +56,10 @@ momentum_twist_site(Real bdry_phase[4], int sign) {
 	       sign*bdry_phase[2], sign*bdry_phase[3]);
   
   FORALLSITES(i,s){
-    phase_mult_su3_matrix(&(s->link[XUP]), cphase[XUP]);
-    phase_mult_su3_matrix(&(s->link[YUP]), cphase[YUP]);
-    phase_mult_su3_matrix(&(s->link[ZUP]), cphase[ZUP]);
-    phase_mult_su3_matrix(&(s->link[TUP]), cphase[TUP]);
+    phase_mult_su3_matrix(&(SITE_LINK(i)[XUP]), cphase[XUP]);
+    phase_mult_su3_matrix(&(SITE_LINK(i)[YUP]), cphase[YUP]);
+    phase_mult_su3_matrix(&(SITE_LINK(i)[ZUP]), cphase[ZUP]);
+    phase_mult_su3_matrix(&(SITE_LINK(i)[TUP]), cphase[TUP]);
   }
   
 } /* momentum_twist_site */
@@ -141,13 +141,13 @@ boundary_twist_site(Real bdry_phase[4], int r0[4], int sign) {
 
   FORALLSITES_OMP(i,s,){
     if( s->x == bc_coord[XUP])
-      phase_mult_su3_matrix(&s->link[XUP], cphase[XUP]);
+      phase_mult_su3_matrix(&SITE_LINK(i)[XUP], cphase[XUP]);
     if( s->y == bc_coord[YUP])
-      phase_mult_su3_matrix(&s->link[YUP], cphase[YUP]);
+      phase_mult_su3_matrix(&SITE_LINK(i)[YUP], cphase[YUP]);
     if( s->z == bc_coord[ZUP])
-      phase_mult_su3_matrix(&s->link[ZUP], cphase[ZUP]);
+      phase_mult_su3_matrix(&SITE_LINK(i)[ZUP], cphase[ZUP]);
     if( s->t == bc_coord[TUP])
-      phase_mult_su3_matrix(&s->link[TUP], cphase[TUP]);
+      phase_mult_su3_matrix(&SITE_LINK(i)[TUP], cphase[TUP]);
   } END_LOOP_OMP;
 
   FORALLUPDIR(dir){
@@ -39,10 +39,10 @@ nersc_cksum( void ) {
   FORALLSITES(i,s) {
     for(mu=0; mu<4; ++mu) {
       for(a=0; a<2; a++) for(b=0; b<3; b++) {
-	tmp.flt = s->link[mu].e[a][b].real;
+	tmp.flt = SITE_LINK(i)[mu].e[a][b].real;
 	p32 = tmp.p32;
 	chksum += p32;
-	tmp.flt = s->link[mu].e[a][b].imag;
+	tmp.flt = SITE_LINK(i)[mu].e[a][b].imag;
 	p32 = tmp.p32;
 	chksum += p32;
       }
@@ -65,7 +65,7 @@ void d_linktrsum(double_complex *linktrsum) {
 
   FORALLSITES(i,s){
     FORALLUPDIR(dir){
-      a = &s->link[dir];
+      a = &SITE_LINK(i)[dir];
       CSUM(*linktrsum,a->e[0][0]);
       CSUM(*linktrsum,a->e[1][1]);
       CSUM(*linktrsum,a->e[2][2]);
@@ -0,0 +1,291 @@
+/************************ perf_regions.c ****************************/
+/* MIMD version 7 */
+
+/* Nested timing regions with flop and byte counts.
+
+   Compiled with -DPERF_REGIONS.  Code brackets its work with
+
+     PERF_BEGIN("name");
+     ...
+     PERF_END("name", flops, bytes);
+
+   where flops and bytes are this rank's counts for the call.  Regions
+   nest: a region begun inside another is a child of it, so the same
+   name may appear under several parents (wait_gather under the
+   dslash and under the gauge force, for example).  Names are string
+   constants without '/'.  Without -DPERF_REGIONS the macros vanish.
+
+   report_perf_regions(), called from normal_exit, prints for each
+   region the calls per rank, the minimum, average and maximum time
+   over ranks, the imbalance max/avg, and the aggregate GFlop/s and
+   GB/s (total over ranks divided by the maximum time).  The regions
+   listed are those seen on node 0.
+
+   If the environment variable MILC_PERF_JSON names a file, node 0
+   also writes the table there in JSON.  If MILC_PERF_TRACE is set,
+   each rank keeps its first PERF_MAX_EVENTS region instances and
+   writes them to $MILC_PERF_TRACE.<rank>.json in the Chrome trace
+   event format (chrome://tracing, Perfetto).
+
+   Regions are begun and ended outside OpenMP parallel regions. */
+
+#include "generic_includes.h"
+
+#ifdef PERF_REGIONS
+
+#define PERF_MAXDEPTH 32
+#define PERF_MAX_EVENTS (1<<18)
+
+typedef struct {
+  const char *name;
+  int parent, first_child, last_child, next_sibling;
+  double calls, time, flops, bytes;
+  double t0;          /* start of the open instance */
+} perf_region;
+
+typedef struct {
+  int region;
+  double t0, dt;
+} perf_event;
+
+static perf_region *reg = NULL;
+static int nreg = 0, maxreg = 0;
+static int stack[PERF_MAXDEPTH];
+static int depth = 0;
+static double perf_t0;
+
+static char *trace_prefix = NULL;
+static perf_event *events = NULL;
+static int nevents = 0;
+
+/* Region 0 is the root */
+static int new_region(const char *name, int parent){
+  int r;
+
+  if(nreg == maxreg){
+    maxreg = maxreg == 0 ? 64 : 2*maxreg;
+    reg = (perf_region *)realloc(reg, maxreg*sizeof(perf_region));
+    if(reg == NULL){
+      printf("perf_begin(%d): no room for the region table\n", this_node);
+      terminate(1);
+    }
+  }
+  r = nreg++;
+  memset(&reg[r], 0, sizeof(perf_region));
+  reg[r].name = name;
+  reg[r].parent = parent;
+  reg[r].first_child = reg[r].last_child = reg[r].next_sibling = -1;
+  if(parent >= 0){
+    if(reg[parent].first_child < 0)reg[parent].first_child = r;
+    else reg[reg[parent].last_child].next_sibling = r;
+    reg[parent].last_child = r;
+  }
+  return r;
+}
+
+static void perf_init(void){
+  new_region("", -1);
+  perf_t0 = dclock();
+  trace_prefix = getenv("MILC_PERF_TRACE");
+  if(trace_prefix != NULL){
+    events = (perf_event *)malloc(PERF_MAX_EVENTS*sizeof(perf_event));
+    if(events == NULL)trace_prefix = NULL;
+  }
+}
+
+static int find_child(int parent, const char *name, size_t len){
+  int r;
+
+  for(r = reg[parent].first_child; r >= 0; r = reg[r].next_sibling)
+    if(strncmp(reg[r].name, name, len) == 0 && reg[r].name[len] == '\0')
+      return r;
+  return -1;
+}
+
+void perf_begin(const char *name){
+  int cur, r;
+
+  if(nreg == 0)perf_init();
+  cur = depth > 0 ? stack[depth-1] : 0;
+  for(r = reg[cur].first_child; r >= 0; r = reg[r].next_sibling)
+    if(reg[r].name == name || strcmp(reg[r].name, name) == 0)break;
+  if(r < 0)r = new_region(name, cur);
+
+  if(depth == PERF_MAXDEPTH){
+    printf("perf_begin(%d): regions nested deeper than %d at %s\n",
+	   this_node, PERF_MAXDEPTH, name);
+    terminate(1);
+  }
+  stack[depth++] = r;
+  reg[r].t0 = dclock();
+}
+
+void perf_end(const char *name, double flops, double bytes){
+  double t = dclock();
+  int r;
+
+  if(depth == 0 || strcmp(reg[stack[depth-1]].name, name) != 0){
+    printf("perf_end(%d): %s ends, but %s is open\n", this_node, name,
+	   depth == 0 ? "no region" : reg[stack[depth-1]].name);
+    terminate(1);
+  }
+  r = stack[--depth];
+  reg[r].calls += 1;
+  reg[r].time += t - reg[r].t0;
+  reg[r].flops += flops;
+  reg[r].bytes += bytes;
+
+  if(trace_prefix != NULL && nevents < PERF_MAX_EVENTS){
+    events[nevents].region = r;
+    events[nevents].t0 = reg[r].t0 - perf_t0;
+    events[nevents].dt = t - reg[r].t0;
+    nevents++;
+  }
+}
+
+/* Append the '/'-separated paths of r and its descendants, depth first */
+static void list_paths(int r, char *prefix, char **buf, int *len, int *max){
+  char path[1024];
+  int c, n;
+
+  for(c = reg[r].first_child; c >= 0; c = reg[c].next_sibling){
+    if(prefix[0] == '\0')snprintf(path, sizeof(path), "%s", reg[c].name);
+    else snprintf(path, sizeof(path), "%s/%s", prefix, reg[c].name);
+    n = strlen(path) + 1;
+    if(*len + n > *max){
+      *max = 2*(*max) + n;
+      *buf = (char *)realloc(*buf, *max);
+      if(*buf == NULL){
+	printf("report_perf_regions: no room for the region list\n");
+	terminate(1);
+      }
+    }
+    memcpy(*buf + *len, path, n);
+    *len += n;
+    list_paths(c, path, buf, len, max);
+  }
+}
+
+/* The region at path on this rank, or -1 */
+static int find_path(const char *path){
+  int r = 0;
+  const char *p = path, *q;
+
+  if(nreg == 0)return -1;
+  while(r >= 0){
+    q = strchr(p, '/');
+    if(q == NULL)return find_child(r, p, strlen(p));
+    r = find_child(r, p, q - p);
+    p = q + 1;
+  }
+  return -1;
+}
+
+static void write_trace(void){
+  char filename[512];
+  FILE *fp;
+  int k;
+
+  snprintf(filename, sizeof(filename), "%s.%d.json", trace_prefix, this_node);
+  fp = fopen(filename, "w");
+  if(fp == NULL){
+    printf("report_perf_regions(%d): can't open %s\n", this_node, filename);
+    return;
+  }
+  fprintf(fp, "{\"traceEvents\":[\n");
+  for(k = 0; k < nevents; k++)
+    fprintf(fp, "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":%d,\"tid\":0,\"ts\":%.3f,\"dur\":%.3f}\n",
+	    k == 0 ? "" : ",", reg[events[k].region].name, this_node,
+	    1e6*events[k].t0, 1e6*events[k].dt);
+  fprintf(fp, "]}\n");
+  fclose(fp);
+}
+
+/* Collective: all ranks must call it */
+void report_perf_regions(void){
+  char *paths = NULL, *p, *json_file;
+  char label[64];
+  int len = 0, max = 0, n, k, r, d;
+  double *sum, tmin, tmax, tavg;
+  FILE *json = NULL;
+
+  if(this_node == 0 && nreg > 0)
+    list_paths(0, "", &paths, &len, &max);
+  broadcast_bytes((char *)&len, sizeof(int));
+  if(len == 0){
+    if(trace_prefix != NULL)write_trace();
+    return;
+  }
+  if(this_node != 0){
+    paths = (char *)malloc(len);
+    if(paths == NULL){
+      printf("report_perf_regions(%d): no room for the region list\n", this_node);
+      terminate(1);
+    }
+  }
+  broadcast_bytes(paths, len);
+  for(n = 0, k = 0; k < len; k++)if(paths[k] == '\0')n++;
+
+  sum = (double *)malloc(4*n*sizeof(double));
+  if(sum == NULL){
+    printf("report_perf_regions(%d): no room\n", this_node);
+    terminate(1);
+  }
+  for(k = 0, p = paths; k < n; k++, p += strlen(p) + 1){
+    r = find_path(p);
+    sum[4*k]   = r < 0 ? 0. : reg[r].time;
+    sum[4*k+1] = r < 0 ? 0. : reg[r].calls;
+    sum[4*k+2] = r < 0 ? 0. : reg[r].flops;
+    sum[4*k+3] = r < 0 ? 0. : reg[r].bytes;
+  }
+  g_vecdoublesum(sum, 4*n);
+
+  json_file = getenv("MILC_PERF_JSON");
+  if(this_node == 0 && json_file != NULL){
+    json = fopen(json_file, "w");
+    if(json == NULL)printf("report_perf_regions: can't open %s\n", json_file);
+    else fprintf(json, "{\"ranks\":%d,\"regions\":[\n", numnodes());
+  }
+
+  node0_printf("PERF: %-36s %10s %10s %10s %10s %7s %8s %8s\n", "region",
+	       "calls", "min s", "avg s", "max s", "max/avg", "GFlop/s", "GB/s");
+  for(k = 0, p = paths; k < n; k++, p += strlen(p) + 1){
+    r = find_path(p);
+    tmax = r < 0 ? 0. : reg[r].time;
+    tmin = -tmax;
+    g_doublemax(&tmax);
+    g_doublemax(&tmin);
+    tmin = -tmin;
+    tavg = sum[4*k]/numnodes();
+    if(this_node != 0)continue;
+
+    for(d = 0, r = 0; p[r] != '\0'; r++)if(p[r] == '/')d++;
+    snprintf(label, sizeof(label), "%*s%s", 2*d, "",
+	     strrchr(p, '/') == NULL ? p : strrchr(p, '/') + 1);
+    printf("PERF: %-36s %10.0f %10.3e %10.3e %10.3e %7.2f",
+	   label, sum[4*k+1]/numnodes(), tmin, tavg, tmax,
+	   tavg > 0 ? tmax/tavg : 1.);
+    if(sum[4*k+2] > 0 && tmax > 0)printf(" %8.2f", sum[4*k+2]/(1e9*tmax));
+    else printf(" %8s", "-");
+    if(sum[4*k+3] > 0 && tmax > 0)printf(" %8.2f\n", sum[4*k+3]/(1e9*tmax));
+    else printf(" %8s\n", "-");
+
+    if(json != NULL)
+      fprintf(json, "%s{\"path\":\"%s\",\"calls\":%.0f,\"min_s\":%e,\"avg_s\":%e,\"max_s\":%e,\"flops\":%e,\"bytes\":%e}\n",
+	      k == 0 ? "" : ",", p, sum[4*k+1], tmin, tavg, tmax,
+	      sum[4*k+2], sum[4*k+3]);
+  }
+  node0_printf("PERF: calls are per rank; rates are totals over ranks divided by the max time\n");
+  fflush(stdout);
+
+  if(json != NULL){
+    fprintf(json, "]}\n");
+    fclose(json);
+  }
+  if(trace_prefix != NULL)write_trace();
+
+  free(sum);
+  free(paths);
+}
+
+#endif /* PERF_REGIONS */
@@ -34,11 +34,10 @@ int d[4];
     /* First multiply the link on every even site by the link above it */
     /* We will compute the Polyakov loop "at" the even sites in the 
 	first two time slices. */
-    tag=start_gather_site( F_OFFSET(link[TUP]), sizeof(su3_matrix),
-	TUP, EVEN, gen_pt[0] );
+    tag=start_gather_link( TUP, TUP, EVEN, gen_pt[0] );
     wait_gather(tag);
     FOREVENSITES(i,st){
-	mult_su3_nn( &(st->link[TUP]), (su3_matrix *)gen_pt[0][i],
+	mult_su3_nn( &(SITE_LINK(i)[TUP]), (su3_matrix *)gen_pt[0][i],
 	    &tempmat1[i]);
     }
     cleanup_gather(tag);
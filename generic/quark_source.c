@@ -184,15 +184,15 @@ wilson_vector *get_cached_wv_source(quark_source *qs){
 
 static void reset_qs(quark_source *qs){
   if(qs->c_src != NULL){
-    free(qs->c_src); 
+    destroy_c_field(qs->c_src); 
     qs->c_src = NULL;
   }
   if(qs->v_src != NULL){
-    free(qs->v_src);
+    destroy_v_field(qs->v_src);
     qs->v_src = NULL;
   }
   if(qs->wv_src != NULL){
-    free(qs->wv_src);
+    destroy_wv_field(qs->wv_src);
     qs->wv_src = NULL;
   }
 }
@@ -846,7 +846,7 @@ int w_source_dirac_site(field_offset src, quark_source *qs)
 
   t_src  = create_wv_field();
   status = w_source_dirac(t_src, qs);
-  free(t_src);
+  destroy_wv_field(t_src);
 
   return status;
 
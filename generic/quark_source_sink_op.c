@@ -1274,7 +1274,7 @@ static int apply_convolution_wv(wilson_vector *src,
   /* Do the convolution */
 
   smear_wv_field(src, chi_cs);
-  free(chi_cs);
+  destroy_c_field(chi_cs);
 
   return 1;
 
@@ -16,24 +16,24 @@ register site *s;
 	    if(dir==TUP || s->t>0){
 #endif
 #ifdef SITERAND
-		random_anti_hermitian( (anti_hermitmat *)&(s->mom[dir]),
+		random_anti_hermitian( (anti_hermitmat *)&(SITE_MOM(i)[dir]),
 		    &(s->site_prn) );
 #else
-		random_anti_hermitian( (anti_hermitmat *)&(s->mom[dir]),
+		random_anti_hermitian( (anti_hermitmat *)&(SITE_MOM(i)[dir]),
 		    &node_prn );
 #endif
 #ifdef SCHROED_FUN
 	    }
 	    else{
-		s->mom[dir].m00im = 0.0;
-		s->mom[dir].m11im = 0.0;
-		s->mom[dir].m22im = 0.0;
-		s->mom[dir].m01.real = 0.0;
-		s->mom[dir].m01.imag = 0.0;
-		s->mom[dir].m02.real = 0.0;
-		s->mom[dir].m02.imag = 0.0;
-		s->mom[dir].m12.real = 0.0;
-		s->mom[dir].m12.imag = 0.0;
+		SITE_MOM(i)[dir].m00im = 0.0;
+		SITE_MOM(i)[dir].m11im = 0.0;
+		SITE_MOM(i)[dir].m22im = 0.0;
+		SITE_MOM(i)[dir].m01.real = 0.0;
+		SITE_MOM(i)[dir].m01.imag = 0.0;
+		SITE_MOM(i)[dir].m02.real = 0.0;
+		SITE_MOM(i)[dir].m02.imag = 0.0;
+		SITE_MOM(i)[dir].m12.real = 0.0;
+		SITE_MOM(i)[dir].m12.imag = 0.0;
 	    }
 #endif
 	}
@@ -244,7 +244,7 @@ void reunitarize_cpu() {
 #else
     for(dir=XUP; dir<=TUP; dir++ ){
 #endif
-      mat = (su3_matrix *)&(s->link[dir]);
+      mat = (su3_matrix *)&(SITE_LINK(i)[dir]);
       errors = reunit_su3( mat );
       errcount += errors;
       if(errors && errcount <= MAXERRCOUNT)
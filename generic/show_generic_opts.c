@@ -24,4 +24,12 @@ void show_generic_opts( void ){
 #ifdef HALF_MIXED
   node0_printf("HALF_MIXED\n");
 #endif
+
+#ifdef MAX_MIXED
+  node0_printf("MAX_MIXED\n");
+#endif
+
+#ifdef KS_MULTICG_HALF
+  node0_printf("KS_MULTICG_HALF\n");
+#endif
 }
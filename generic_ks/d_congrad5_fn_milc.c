@@ -32,10 +32,12 @@
 #include "../include/openmp_defs.h"
 #include <string.h>
 
-/* The Fermilab relative residue */
+/* The Fermilab relative residue, summed over the sites of this node
+   only.  Solvers that batch their global sums add it to their own
+   reduction and normalize with ks_relative_residue_norm. */
 
-static Real 
-my_relative_residue(su3_vector *p, su3_vector *q, int parity)
+double
+ks_relative_residue_sum(su3_vector *p, su3_vector *q, int parity)
 {
   double residue, num, den;
   int i;
@@ -47,16 +49,37 @@ my_relative_residue(su3_vector *p, su3_vector *q, int parity)
     residue += (den==0) ? 1.0 : (num/den);
   } END_LOOP_OMP;
 
-  g_doublesum(&residue);
+  return residue;
+}
 
+/* Normalize a globally summed relative residue */
+
+Real
+ks_relative_residue_norm(double residue, int parity)
+{
   if(parity == EVENANDODD)
     return sqrt(residue/volume);
   else
     return sqrt(2*residue/volume);
 }
 
+/* The Fermilab relative residue */
+
+Real 
+ks_relative_residue(su3_vector *p, su3_vector *q, int parity)
+{
+  double residue = ks_relative_residue_sum(p, q, parity);
+
+  g_doublesum(&residue);
+  return ks_relative_residue_norm(residue, parity);
+}
+
 static const char *prec_label[2] = {"F", "D"};
 
+/* 1187 flops per site of this node per iteration, as for CGTIME */
+#define CG_PERF_END(iters) \
+  PERF_END("ks_congrad", 1187.*sites_on_node*(iters), 0)
+
 int
 ks_congrad_parity_cpu( su3_vector *t_src, su3_vector *t_dest, 
 		       quark_invert_control *qic, Real mass,
@@ -98,6 +121,26 @@ ks_congrad_parity_cpu( su3_vector *t_src, su3_vector *t_dest,
     printf("%s(%d): Called with NULL fn\n", myname, this_node);
     terminate(1);
   }
+
+  PERF_BEGIN("ks_congrad");
+
+#if defined(KS_CG_MIXED) && (MILC_PRECISION == 2)
+  /* Single precision iterations with double precision reliable updates */
+  if(qic->prec == 1 && parity != EVENANDODD){
+    iteration = ks_congrad_parity_mixed_cpu(t_src, t_dest, qic, mass, fn);
+    CG_PERF_END(iteration);
+    return iteration;
+  }
+#endif
+
+#ifdef KS_CG_PIPELINED
+  /* One nonblocking global sum per iteration */
+  if(parity != EVENANDODD){
+    iteration = ks_congrad_parity_pipe_cpu(t_src, t_dest, qic, mass, fn);
+    CG_PERF_END(iteration);
+    return iteration;
+  }
+#endif
   
   dtimec = -dclock(); 
   double dsltime = 0.;
@@ -148,6 +191,7 @@ ks_congrad_parity_cpu( su3_vector *t_src, su3_vector *t_dest,
     fflush(stdout);}
 #endif
 
+    CG_PERF_END(0);
     return 0;
   }
 
@@ -162,9 +206,13 @@ ks_congrad_parity_cpu( su3_vector *t_src, su3_vector *t_dest,
     printf("%s(%d): No room for temporaries\n",myname,this_node);
   }
 
-  memset(ttt, 0, (sites_on_node+PAD)*sizeof(su3_vector));
-  memset(cg_p, 0, (sites_on_node+PAD)*sizeof(su3_vector));
-  memset(resid, 0, (sites_on_node+PAD)*sizeof(su3_vector));
+  /* With OpenMP the threads clear their own sites (first touch) */
+  clear_v_field(ttt);
+  clear_v_field(cg_p);
+  clear_v_field(resid);
+  memset(ttt + sites_on_node, 0, PAD*sizeof(su3_vector));
+  memset(cg_p + sites_on_node, 0, PAD*sizeof(su3_vector));
+  memset(resid + sites_on_node, 0, PAD*sizeof(su3_vector));
 
 #ifdef CG_DEBUG
   node0_printf("rsqmin = %g relmin = %g\n",rsqmin,relrsqmin);
@@ -215,7 +263,7 @@ ks_congrad_parity_cpu( su3_vector *t_src, su3_vector *t_dest,
         g_doublesum( &rsq );
 
 	if(relrsqmin > 0)
-	  relrsq = my_relative_residue(resid, t_dest, parity);
+	  relrsq = ks_relative_residue(resid, t_dest, parity);
 
 	qic->final_rsq    = (Real)rsq/source_norm;
 	qic->final_relrsq = (Real)relrsq;
@@ -345,7 +393,7 @@ ks_congrad_parity_cpu( su3_vector *t_src, su3_vector *t_dest,
 #endif	
 
     if(relrsqmin > 0)
-      relrsq = my_relative_residue(resid, t_dest, parity);
+      relrsq = ks_relative_residue(resid, t_dest, parity);
     
     qic->size_r        = (Real)rsq/source_norm;
     qic->size_relr     = relrsq;
@@ -403,15 +451,551 @@ ks_congrad_parity_cpu( su3_vector *t_src, su3_vector *t_dest,
     fflush(stdout);}
 #endif
 
+  CG_PERF_END(iteration);
   return iteration;
 }
 
+/*********************************************************************/
+/* Block CG for several right-hand sides with the same mass            */
+/*********************************************************************/
+
+/* Breakdown-free block conjugate gradient (Ji and Li,
+   arXiv:1502.01449).  All sources share one Krylov space, so every
+   column of the solution benefits from the search directions
+   generated by the others.  The search block P is kept orthonormal
+   with a rank-revealing (pivoted) Cholesky QR, which drops directions
+   that have become linearly dependent, e.g. when one of the sources
+   has converged or when two sources are nearly parallel.  This is what
+   avoids the breakdown of the original O'Leary algorithm.
+
+   The notation follows the paper:
+
+     R = B - A X,  P = orth(R)
+     loop:
+       Q = A P
+       alpha = (P^H Q)^-1 P^H R
+       X <- X + P alpha,  R <- R - Q alpha
+       beta = -(P^H Q)^-1 Q^H R
+       P <- orth(R + P beta)
+
+   Here A = M_adjoint M = 4m^2 - Dslash_eo Dslash_oe on the selected
+   parity.  The small dense matrices are kept in double precision. */
+
+/* Squared-norm threshold (relative to the largest column) below which a
+   direction is considered linearly dependent and dropped from P */
+#ifndef BLOCKCG_RANK_TOL
+#if MILC_PRECISION == 1
+#define BLOCKCG_RANK_TOL 1e-8
+#else
+#define BLOCKCG_RANK_TOL 1e-16
+#endif
+#endif
+
+/* dest[k] <- M_adjoint M src[k] = 4m^2 src[k] - Dslash Dslash src[k]
+   on "parity" for k = 0..n-1, all columns in one multi-RHS dslash.
+   dest[k] must not alias src[k] */
+
+static void
+block_apply_normal_op(int n, su3_vector **src, su3_vector **dest,
+		      Real msq_x4, int parity, imp_ferm_links_t *fn)
+{
+  int i, k;
+  int otherparity = (parity == EVEN) ? ODD : EVEN;
+
+  dslash_fn_field_multi(src, dest, n, otherparity, fn);
+  dslash_fn_field_multi(dest, dest, n, parity, fn);
+  for(k = 0; k < n; k++){
+    su3_vector *s = src[k], *d = dest[k];
+    FORSOMEFIELDPARITY_OMP(i,parity,default(shared)){
+      su3_vector tvec;
+      scalar_mult_su3_vector( &s[i], msq_x4, &tvec );
+      sub_su3_vector( &tvec, &d[i], &d[i] );
+    } END_LOOP_OMP;
+  }
+}
+
+/* Node-local block inner product c[ia*nb + ib] = a[ia]^dagger b[ib] */
+
+static void
+block_dot(int na, su3_vector **a, int nb, su3_vector **b,
+	  double_complex *c, int parity)
+{
+  int i, ia, ib;
+
+  for(ia = 0; ia < na; ia++)
+    for(ib = 0; ib < nb; ib++){
+      double cr = 0., ci = 0.;
+      su3_vector *va = a[ia], *vb = b[ib];
+      FORSOMEFIELDPARITY_OMP(i,parity,reduction(+:cr,ci)){
+	complex cc = su3_dot( &va[i], &vb[i] );
+	cr += cc.real;
+	ci += cc.imag;
+      } END_LOOP_OMP;
+      c[ia*nb + ib].real = cr;
+      c[ia*nb + ib].imag = ci;
+    }
+}
+
+/* out[j] <- out[j] + sign * sum_k in[k] coef[k*nout + j] */
+
+static void
+block_mult_add(int nout, su3_vector **out, int nin, su3_vector **in,
+	       double_complex *coef, Real sign, int parity)
+{
+  int i, j, k;
+  complex cc;
+
+  for(j = 0; j < nout; j++)
+    for(k = 0; k < nin; k++){
+      su3_vector *vo = out[j], *vi = in[k];
+      cc.real = sign*coef[k*nout + j].real;
+      cc.imag = sign*coef[k*nout + j].imag;
+      FORSOMEFIELDPARITY_OMP(i,parity,default(shared)){
+	c_scalar_mult_add_su3vec( &vo[i], &cc, &vi[i] );
+      } END_LOOP_OMP;
+    }
+}
+
+/* In-place Cholesky factorization G = L L^H of an n x n Hermitian
+   positive definite matrix.  L overwrites the lower triangle.
+   Returns 1 if G is not numerically positive definite. */
+
+static int
+block_cholesky(int n, double_complex *G)
+{
+  int i, j, k;
+
+  for(k = 0; k < n; k++){
+    double d = G[k*n + k].real;
+    for(j = 0; j < k; j++)
+      d -= G[k*n + j].real*G[k*n + j].real + G[k*n + j].imag*G[k*n + j].imag;
+    if(d <= 0.)return 1;
+    d = sqrt(d);
+    G[k*n + k].real = d; G[k*n + k].imag = 0.;
+    for(i = k+1; i < n; i++){
+      double_complex t = G[i*n + k];
+      for(j = 0; j < k; j++){
+	/* t -= L[i][j] conj(L[k][j]) */
+	t.real -= G[i*n + j].real*G[k*n + j].real + G[i*n + j].imag*G[k*n + j].imag;
+	t.imag -= G[i*n + j].imag*G[k*n + j].real - G[i*n + j].real*G[k*n + j].imag;
+      }
+      G[i*n + k].real = t.real/d;
+      G[i*n + k].imag = t.imag/d;
+    }
+  }
+  return 0;
+}
+
+/* Solve L L^H X = B for the n x m matrix B, overwritten by X, using
+   the factor from block_cholesky */
+
+static void
+block_cholesky_solve(int n, double_complex *L, int m, double_complex *B)
+{
+  int i, j, c;
+
+  for(c = 0; c < m; c++){
+    /* Forward substitution L y = b */
+    for(i = 0; i < n; i++){
+      double_complex t = B[i*m + c];
+      for(j = 0; j < i; j++){
+	t.real -= L[i*n + j].real*B[j*m + c].real - L[i*n + j].imag*B[j*m + c].imag;
+	t.imag -= L[i*n + j].real*B[j*m + c].imag + L[i*n + j].imag*B[j*m + c].real;
+      }
+      B[i*m + c].real = t.real/L[i*n + i].real;
+      B[i*m + c].imag = t.imag/L[i*n + i].real;
+    }
+    /* Back substitution L^H x = y */
+    for(i = n-1; i >= 0; i--){
+      double_complex t = B[i*m + c];
+      for(j = i+1; j < n; j++){
+	/* t -= conj(L[j][i]) x[j] */
+	t.real -= L[j*n + i].real*B[j*m + c].real + L[j*n + i].imag*B[j*m + c].imag;
+	t.imag -= L[j*n + i].real*B[j*m + c].imag - L[j*n + i].imag*B[j*m + c].real;
+      }
+      B[i*m + c].real = t.real/L[i*n + i].real;
+      B[i*m + c].imag = t.imag/L[i*n + i].real;
+    }
+  }
+}
+
+/* Rank-revealing orthonormalization P = orth(W).  The Gram matrix
+   W^H W is factored with a diagonally pivoted Cholesky decomposition,
+   stopping when the remaining diagonal drops below BLOCKCG_RANK_TOL
+   times the largest column norm.  The retained columns are
+   orthonormalized as P = W_sel L^-H.  Returns the rank. */
+
+static int
+block_orth(int n, su3_vector **W, su3_vector **P, int parity)
+{
+  int i, j, k, m, piv, rank;
+  double dmax, dbest;
+  int *perm = (int *)malloc(n*sizeof(int));
+  double *diag = (double *)malloc(n*sizeof(double));
+  double_complex *G = (double_complex *)malloc(n*n*sizeof(double_complex));
+  double_complex *L = (double_complex *)malloc(n*n*sizeof(double_complex));
+  double_complex *Linv = (double_complex *)malloc(n*n*sizeof(double_complex));
+  su3_vector **Wsel = (su3_vector **)malloc(n*sizeof(su3_vector *));
+
+  block_dot(n, W, n, W, G, parity);
+  g_vecdcomplexsum(G, n*n);
+
+  dmax = 0.;
+  for(i = 0; i < n; i++){
+    perm[i] = i;
+    diag[i] = G[i*n + i].real;
+    if(diag[i] > dmax)dmax = diag[i];
+  }
+  memset(L, 0, n*n*sizeof(double_complex));
+
+  for(k = 0; k < n; k++){
+    /* Pivot on the largest remaining diagonal element */
+    piv = k; dbest = diag[perm[k]];
+    for(i = k+1; i < n; i++)
+      if(diag[perm[i]] > dbest){ dbest = diag[perm[i]]; piv = i; }
+    if(dbest <= 0. || dbest <= BLOCKCG_RANK_TOL*dmax)break;
+    if(piv != k){
+      int t = perm[k]; perm[k] = perm[piv]; perm[piv] = t;
+      /* Keep the rows of L consistent with the permutation */
+      for(m = 0; m < k; m++){
+	double_complex c = L[k*n + m];
+	L[k*n + m] = L[piv*n + m];
+	L[piv*n + m] = c;
+      }
+    }
+    L[k*n + k].real = sqrt(dbest); L[k*n + k].imag = 0.;
+    for(i = k+1; i < n; i++){
+      double_complex t = G[perm[i]*n + perm[k]];
+      for(m = 0; m < k; m++){
+	t.real -= L[i*n + m].real*L[k*n + m].real + L[i*n + m].imag*L[k*n + m].imag;
+	t.imag -= L[i*n + m].imag*L[k*n + m].real - L[i*n + m].real*L[k*n + m].imag;
+      }
+      L[i*n + k].real = t.real/L[k*n + k].real;
+      L[i*n + k].imag = t.imag/L[k*n + k].real;
+      diag[perm[i]] -= L[i*n + k].real*L[i*n + k].real + 
+	L[i*n + k].imag*L[i*n + k].imag;
+    }
+  }
+  rank = k;
+
+  /* Invert the leading rank x rank block of L (lower triangular) */
+  memset(Linv, 0, n*n*sizeof(double_complex));
+  for(j = 0; j < rank; j++){
+    Linv[j*n + j].real = 1./L[j*n + j].real;
+    for(i = j+1; i < rank; i++){
+      double_complex t = {0., 0.};
+      for(m = j; m < i; m++){
+	t.real += L[i*n + m].real*Linv[m*n + j].real - L[i*n + m].imag*Linv[m*n + j].imag;
+	t.imag += L[i*n + m].real*Linv[m*n + j].imag + L[i*n + m].imag*Linv[m*n + j].real;
+      }
+      Linv[i*n + j].real = -t.real/L[i*n + i].real;
+      Linv[i*n + j].imag = -t.imag/L[i*n + i].real;
+    }
+  }
+
+  /* P[c] = sum_a Wsel[a] conj(Linv[c][a]).  Reuse G for the
+     coefficient matrix, stored as coef[a*rank + c] */
+  for(i = 0; i < rank; i++)Wsel[i] = W[perm[i]];
+  for(i = 0; i < rank; i++)
+    for(j = 0; j < rank; j++){
+      G[i*rank + j].real =  Linv[j*n + i].real;
+      G[i*rank + j].imag = -Linv[j*n + i].imag;
+    }
+  for(j = 0; j < rank; j++){
+    FORSOMEFIELDPARITY_OMP(i,parity,default(shared)){
+      clearvec( &P[j][i] );
+    } END_LOOP_OMP;
+  }
+  block_mult_add(rank, P, rank, Wsel, G, 1.0, parity);
+
+  free(Wsel); free(Linv); free(L); free(G); free(diag); free(perm);
+  return rank;
+}
+
 int ks_congrad_block_parity_cpu( int nsrc, su3_vector **t_src, su3_vector **t_dest, 
-				     quark_invert_control *qic, Real mass,
-				     imp_ferm_links_t *fn){
-  /* FAKE version for now */
-  int iters = 0;
-  for(int i = 0; i < nsrc; i++)
-    iters += ks_congrad_parity_cpu(t_src[i], t_dest[i], qic, mass, fn);
-  return iters;
+				 quark_invert_control *qic, Real mass,
+				 imp_ferm_links_t *fn){
+  int i, j, k;
+  int iteration;	/* counter for block iterations */
+  int nrestart;         /* Restart counter */
+  int rank = 0;         /* number of independent search directions */
+  int restart_now;      /* force a true-residual restart */
+  int all_converged;
+  int nmatvec = 0;      /* number of single-vector M_adjoint*M products */
+  Real msq_x4;	        /* 4*mass*mass */
+  double max_rsq, max_relrsq;
+  double *source_norm, *rsq, *relrsq;
+  double_complex *GPR, *QR, *alpha, *beta, *G;
+  su3_vector **resid, **cg_p, **ttt, **wvec;
+  double dtimec;
+#ifdef CGTIME
+  double nflop = 1187;
+#endif
+  char myname[] = "ks_congrad_block_parity_cpu";
+
+  /* Unpack structure */
+  int niter        = qic->max;      /* maximum number of iters per restart */
+  int max_restarts = qic->nrestart; /* maximum restarts */
+  Real rsqmin      = qic->resid * qic->resid;    /* desired residual - 
+			 normalized as sqrt(r*r)/sqrt(src_e*src_e) */
+  Real relrsqmin   = qic->relresid * qic->relresid; /* desired relative residual (FNAL)*/
+  int parity       = qic->parity;   /* EVEN, ODD */
+
+  int max_cg = max_restarts*niter; /* Maximum number of iterations */
+
+  if(fn == NULL){
+    printf("%s(%d): Called with NULL fn\n", myname, this_node);
+    terminate(1);
+  }
+
+  /* Nothing to gain from the block algorithm */
+  if(nsrc == 1)
+    return ks_congrad_parity_cpu(t_src[0], t_dest[0], qic, mass, fn);
+
+  dtimec = -dclock(); 
+
+  msq_x4 = 4.0*mass*mass;
+
+  source_norm = (double *)malloc(nsrc*sizeof(double));
+  rsq = (double *)malloc(2*nsrc*sizeof(double));
+  relrsq = (double *)malloc(nsrc*sizeof(double));
+  GPR = (double_complex *)malloc(nsrc*2*nsrc*sizeof(double_complex));
+  QR = (double_complex *)malloc((nsrc + nsrc*nsrc)*sizeof(double_complex));
+  alpha = (double_complex *)malloc(nsrc*nsrc*sizeof(double_complex));
+  beta = (double_complex *)malloc(nsrc*nsrc*sizeof(double_complex));
+  G = (double_complex *)malloc(nsrc*nsrc*sizeof(double_complex));
+  resid = (su3_vector **)malloc(nsrc*sizeof(su3_vector *));
+  cg_p = (su3_vector **)malloc(nsrc*sizeof(su3_vector *));
+  ttt = (su3_vector **)malloc(nsrc*sizeof(su3_vector *));
+  wvec = (su3_vector **)malloc(nsrc*sizeof(su3_vector *));
+  if(source_norm == NULL || rsq == NULL || relrsq == NULL || GPR == NULL ||
+     QR == NULL || alpha == NULL || beta == NULL || G == NULL ||
+     resid == NULL || cg_p == NULL || ttt == NULL || wvec == NULL){
+    printf("%s(%d): No room for temporaries\n",myname,this_node);
+    terminate(1);
+  }
+
+  /* Source norms */
+  for(j = 0; j < nsrc; j++){
+    double sn = 0.;
+    su3_vector *src = t_src[j];
+    FORSOMEFIELDPARITY_OMP(i,parity,reduction(+:sn)){
+      sn += (double)magsq_su3vec( &src[i] );
+    } END_LOOP_OMP;
+    source_norm[j] = sn;
+  }
+  g_vecdoublesum( source_norm, nsrc );
+
+  /* Provision for trivial solutions */
+  for(j = 0; j < nsrc; j++)
+    if(source_norm[j] == 0.0){
+      su3_vector *dest = t_dest[j];
+      FORSOMEFIELDPARITY_OMP(i,parity,default(shared)){
+	memset(dest + i, 0, sizeof(su3_vector));
+      } END_LOOP_OMP;
+    }
+
+  for(j = 0; j < nsrc; j++){
+    resid[j] = create_v_field();
+    cg_p[j] = create_v_field();
+    ttt[j] = create_v_field();
+    wvec[j] = create_v_field();
+  }
+
+  nrestart = 0;
+  iteration = 0;
+  qic->size_r = 0;
+  qic->size_relr = 1.;
+  qic->final_iters   = 0;
+  qic->final_restart = 0;
+  qic->converged     = 1;
+  qic->final_rsq = 0.;
+  qic->final_relrsq = 0.;
+
+  all_converged = 0;
+  restart_now = 1;
+
+  while(1) {
+    /* Check for completion as in ks_congrad_parity_cpu: restart every
+       niter iterations, and when the recursive residuals say we are
+       done, confirm with the true residuals */
+    if( restart_now || ( iteration % niter == 0 ) || all_converged ){
+
+      /* resid <- src - A dest,  rsq = |resid|^2 */
+      block_apply_normal_op(nsrc, t_dest, ttt, msq_x4, parity, fn);
+      for(j = 0; j < nsrc; j++){
+	su3_vector *src = t_src[j], *r = resid[j], *t = ttt[j];
+	FORSOMEFIELDPARITY_OMP(i,parity,default(shared)){
+	  sub_su3_vector( &src[i], &t[i], &r[i] );
+	} END_LOOP_OMP;
+      }
+      iteration++;  /* counts block multiplications by M_adjoint*M */
+      total_iters += nsrc;
+      nmatvec += nsrc;
+
+      /* rsq[0:nsrc] = |resid|^2 and rsq[nsrc:2 nsrc] = the relative
+	 residue sums, with one global sum */
+      for(j = 0; j < nsrc; j++){
+	double r2 = 0.;
+	su3_vector *r = resid[j];
+	FORSOMEFIELDPARITY_OMP(i,parity,reduction(+:r2)){
+	  r2 += (double)magsq_su3vec( &r[i] );
+	} END_LOOP_OMP;
+	rsq[j] = r2;
+	rsq[nsrc + j] = (relrsqmin > 0) ?
+	  ks_relative_residue_sum(resid[j], t_dest[j], parity) : 0.;
+      }
+      g_vecdoublesum( rsq, (relrsqmin > 0) ? 2*nsrc : nsrc );
+
+      max_rsq = 0.; max_relrsq = 0.;
+      all_converged = 1;
+      for(j = 0; j < nsrc; j++){
+	double r = (source_norm[j] == 0.) ? 0. : rsq[j]/source_norm[j];
+	relrsq[j] = 1.;
+	if(relrsqmin > 0)
+	  relrsq[j] = (source_norm[j] == 0.) ? 0. :
+	    ks_relative_residue_norm(rsq[nsrc + j], parity);
+	if(r > max_rsq)max_rsq = r;
+	if(relrsq[j] > max_relrsq)max_relrsq = relrsq[j];
+	if( !( ( rsqmin    <= 0 || rsqmin    > r         ) &&
+	       ( relrsqmin <= 0 || relrsqmin > relrsq[j] ) ) )
+	  all_converged = 0;
+      }
+      qic->final_rsq    = (Real)max_rsq;
+      qic->final_relrsq = (Real)max_relrsq;
+
+#ifdef CG_DEBUG
+      if(this_node==0)printf("BLOCKCG: (re)start %d max rsq = %.10e relrsq %.10e\n",
+			     nrestart, qic->final_rsq, qic->final_relrsq);
+#endif
+      if( iteration >= max_cg || nrestart >= max_restarts || all_converged )
+	break;
+
+      nrestart++;
+      restart_now = 0;
+
+      /* Fresh search space P = orth(resid) */
+      rank = block_orth(nsrc, resid, cg_p, parity);
+      if(rank == 0)break;
+    }
+
+    /* ttt <- A cg_p */
+    block_apply_normal_op(rank, cg_p, ttt, msq_x4, parity, fn);
+
+    /* [G | P^H R] = P^H [ttt | resid] with one global sum */
+    block_dot(rank, cg_p, rank, ttt, GPR, parity);
+    block_dot(rank, cg_p, nsrc, resid, GPR + rank*rank, parity);
+    g_vecdcomplexsum( GPR, rank*rank + rank*nsrc );
+    memcpy(G, GPR, rank*rank*sizeof(double_complex));
+    memcpy(alpha, GPR + rank*rank, rank*nsrc*sizeof(double_complex));
+    iteration++;
+    total_iters += rank;
+    nmatvec += rank;
+
+    if(block_cholesky(rank, G)){
+      /* Lost positivity through roundoff.  Start over from the true
+	 residual. */
+      restart_now = 1;
+      continue;
+    }
+
+    /* alpha <- (P^H A P)^-1 P^H R */
+    block_cholesky_solve(rank, G, nsrc, alpha);
+
+    /* dest <- dest + P alpha,  resid <- resid - A P alpha */
+    block_mult_add(nsrc, t_dest, rank, cg_p, alpha,  1.0, parity);
+    block_mult_add(nsrc, resid,  rank, ttt,  alpha, -1.0, parity);
+
+    /* [|R|^2 | Q^H R] with one global sum.  The relative residue
+       sums ride along in the imaginary parts of the first block. */
+    for(j = 0; j < nsrc; j++){
+      double r2 = 0.;
+      su3_vector *r = resid[j];
+      FORSOMEFIELDPARITY_OMP(i,parity,reduction(+:r2)){
+	r2 += (double)magsq_su3vec( &r[i] );
+      } END_LOOP_OMP;
+      QR[j].real = r2;
+      QR[j].imag = (relrsqmin > 0) ?
+	ks_relative_residue_sum(resid[j], t_dest[j], parity) : 0.;
+    }
+    block_dot(rank, ttt, nsrc, resid, QR + nsrc, parity);
+    g_vecdcomplexsum( QR, nsrc + rank*nsrc );
+
+    max_rsq = 0.; max_relrsq = 0.;
+    all_converged = 1;
+    for(j = 0; j < nsrc; j++){
+      double r;
+      rsq[j] = QR[j].real;
+      r = (source_norm[j] == 0.) ? 0. : rsq[j]/source_norm[j];
+      if(relrsqmin > 0)
+	relrsq[j] = (source_norm[j] == 0.) ? 0. :
+	  ks_relative_residue_norm(QR[j].imag, parity);
+      if(r > max_rsq)max_rsq = r;
+      if(relrsq[j] > max_relrsq)max_relrsq = relrsq[j];
+      if( !( ( rsqmin    <= 0 || rsqmin    > r         ) &&
+	     ( relrsqmin <= 0 || relrsqmin > relrsq[j] ) ) )
+	all_converged = 0;
+    }
+
+    qic->size_r        = (Real)max_rsq;
+    qic->size_relr     = (Real)max_relrsq;
+    qic->final_iters   = iteration;
+    qic->final_restart = nrestart;
+    qic->converged     = 1;
+
+#ifdef CG_DEBUG
+    if(mynode()==0){printf("iter=%d, rank=%d, max rsq/src= %e, relrsq= %e\n",
+			   iteration, rank, (double)qic->size_r,
+			   (double)qic->size_relr);fflush(stdout);}
+#endif
+
+    if(all_converged)continue;
+
+    /* beta <- -(P^H A P)^-1 Q^H R */
+    memcpy(beta, QR + nsrc, rank*nsrc*sizeof(double_complex));
+    block_cholesky_solve(rank, G, nsrc, beta);
+
+    /* wvec <- resid - P beta,  cg_p <- orth(wvec) */
+    for(j = 0; j < nsrc; j++){
+      su3_vector *r = resid[j], *w = wvec[j];
+      FORSOMEFIELDPARITY_OMP(i,parity,default(shared)){
+	w[i] = r[i];
+      } END_LOOP_OMP;
+    }
+    block_mult_add(nsrc, wvec, rank, cg_p, beta, -1.0, parity);
+    rank = block_orth(nsrc, wvec, cg_p, parity);
+
+    /* No independent directions left.  Check the true residual. */
+    if(rank == 0)restart_now = 1;
+  }
+
+  qic->final_iters   = iteration;
+  qic->final_restart = nrestart;
+  qic->converged     = 1;
+  if(nrestart == max_restarts || iteration >= max_cg || !all_converged){
+    qic->converged = 0;
+    fflush(stdout);
+  }
+
+  for(j = 0; j < nsrc; j++){
+    destroy_v_field(resid[j]);
+    destroy_v_field(cg_p[j]);
+    destroy_v_field(ttt[j]);
+    destroy_v_field(wvec[j]);
+  }
+  cleanup_dslash_temps();
+  free(wvec); free(ttt); free(cg_p); free(resid);
+  free(G); free(beta); free(alpha); free(QR); free(GPR);
+  free(relrsq); free(rsq); free(source_norm);
+
+  dtimec += dclock();
+#ifdef CGTIME
+  if(this_node==0){
+    printf("CONGRAD5: time = %e (fn %s) masses = 1 srcs = %d iters = %d mflops = %e\n",
+	   dtimec, prec_label[MILC_PRECISION-1], nsrc, qic->final_iters, 
+	   (double)(nflop*volume*nmatvec/(1.0e6*dtimec*numnodes())) );
+    fflush(stdout);}
+#endif
+
+  return iteration;
 }
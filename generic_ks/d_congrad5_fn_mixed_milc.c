@@ -0,0 +1,490 @@
+/******* d_congrad5_fn_mixed_milc.c - mixed precision CG for SU3/fermions ****/
+/* MIMD version 7 */
+/* Kogut-Susskind fermions -- this version for "fat plus Naik" quark
+   actions.
+
+   Mixed-precision conjugate gradient with reliable updates for the
+   plain MILC (no QOP, Grid, QPhiX, or GPU) build.  Requires
+   -DKS_CG_MIXED and PRECISION=2.  It is selected by
+   ks_congrad_parity_cpu when the caller asks for qic->prec = 1.
+
+   The Krylov iteration runs entirely in single precision, with single
+   precision copies of the fat and long links kept in fn_links_t.
+   Global sums are accumulated in double precision.  Whenever the
+   iterated residual has dropped by a factor KS_CG_MIXED_DELTA since
+   the last update, or appears to have met the stopping condition, the
+   single precision solution is added to the double precision one and
+   the true residual is recomputed in double precision (a "reliable
+   update", Clark et al, arXiv:0911.3191).  The search direction is
+   kept across updates, so the single precision iteration continues
+   without a restart.
+
+   The stopping criteria are the same as for ks_congrad_parity_cpu and
+   are applied to the true (double precision) residual.  The relative
+   (FNAL) residual is checked only at reliable updates.
+
+   qic->final_restart reports the number of reliable updates.
+*/
+
+#include "generic_ks_includes.h"
+#include "../include/openmp_defs.h"
+#include <string.h>
+
+#if defined(KS_CG_MIXED) && (MILC_PRECISION == 2)
+
+/* Do a reliable update when the iterated residual norm has dropped by
+   this factor relative to the largest since the last update */
+#ifndef KS_CG_MIXED_DELTA
+#define KS_CG_MIXED_DELTA 0.1
+#endif
+
+/* Single precision linear algebra */
+
+static inline void
+clearvec_F( fsu3_vector *v ){
+  int j;
+  for(j = 0; j < 3; j++){
+    v->c[j].real = 0.; v->c[j].imag = 0.;
+  }
+}
+
+/* c <- c + a*b */
+static inline void
+mult_su3_mat_vec_sum_F( fsu3_matrix *a, fsu3_vector *b, fsu3_vector *c ){
+  int i, j;
+  for(i = 0; i < 3; i++){
+    float cr = c->c[i].real, ci = c->c[i].imag;
+    for(j = 0; j < 3; j++){
+      cr += a->e[i][j].real*b->c[j].real - a->e[i][j].imag*b->c[j].imag;
+      ci += a->e[i][j].real*b->c[j].imag + a->e[i][j].imag*b->c[j].real;
+    }
+    c->c[i].real = cr; c->c[i].imag = ci;
+  }
+}
+
+/* c <- a[0]*b0 + a[1]*b1 + a[2]*b2 + a[3]*b3 */
+static inline void
+mult_su3_mat_vec_sum_4dir_F( fsu3_matrix *a, fsu3_vector *b0,
+			     fsu3_vector *b1, fsu3_vector *b2,
+			     fsu3_vector *b3, fsu3_vector *c ){
+  clearvec_F(c);
+  mult_su3_mat_vec_sum_F(a,   b0, c);
+  mult_su3_mat_vec_sum_F(a+1, b1, c);
+  mult_su3_mat_vec_sum_F(a+2, b2, c);
+  mult_su3_mat_vec_sum_F(a+3, b3, c);
+}
+
+/* c <- a + s*b */
+static inline void
+scalar_mult_add_su3_vector_F( fsu3_vector *a, fsu3_vector *b, float s,
+			      fsu3_vector *c ){
+  int j;
+  for(j = 0; j < 3; j++){
+    c->c[j].real = a->c[j].real + s*b->c[j].real;
+    c->c[j].imag = a->c[j].imag + s*b->c[j].imag;
+  }
+}
+
+static inline double
+su3_rdot_F( fsu3_vector *a, fsu3_vector *b ){
+  double sum = 0.;
+  int j;
+  for(j = 0; j < 3; j++)
+    sum += a->c[j].real*b->c[j].real + a->c[j].imag*b->c[j].imag;
+  return sum;
+}
+
+static fsu3_vector *
+create_v_field_F(void){
+  fsu3_vector *v = (fsu3_vector *)malloc(sites_on_node*sizeof(fsu3_vector));
+  if(v == NULL){
+    printf("create_v_field_F(%d): No room\n",this_node);
+    terminate(1);
+  }
+  memset(v, 0, sites_on_node*sizeof(fsu3_vector));
+  return v;
+}
+
+/* Single precision Dslash, "parity" sites of dest from the other
+   parity of src.  Modeled on dslash_fn_field_special in
+   dslash_fn_dblstore.c.  The gathers are started when start = 1 and
+   restarted otherwise, so src must be the same field on every call
+   with the same tags. */
+
+static void
+dslash_fn_field_special_F( fsu3_vector *src, fsu3_vector *dest,
+			   int parity, msg_tag **tag, int start,
+			   fn_links_t *fn ){
+  int i, dir;
+  site *s;
+  fsu3_matrix *t_fatlink     = get_F_fatlinks(fn);
+  fsu3_matrix *t_fatbacklink = get_F_fatbacklinks(fn);
+  fsu3_matrix *t_longlink    = get_F_lnglinks(fn);
+  fsu3_matrix *t_longbacklink = get_F_lngbacklinks(fn);
+#ifndef NO_LONG_LINKS
+  int do_long = 1;
+#else
+  int do_long = 0;
+#endif
+
+  /* Start gathers from positive directions and the 3-step gathers */
+  for(dir = XUP; dir <= TUP; dir++){
+    if(start == 1){
+      tag[dir] = start_gather_field( src, sizeof(fsu3_vector),
+				     dir, parity, gen_pt[dir] );
+      if(do_long)
+	tag[DIR3(dir)] = start_gather_field( src, sizeof(fsu3_vector),
+					     DIR3(dir), parity,
+					     gen_pt[DIR3(dir)] );
+    } else {
+      restart_gather_field( src, sizeof(fsu3_vector),
+			    dir, parity, gen_pt[dir], tag[dir] );
+      if(do_long)
+	restart_gather_field( src, sizeof(fsu3_vector), DIR3(dir), parity,
+			      gen_pt[DIR3(dir)], tag[DIR3(dir)] );
+    }
+  }
+
+  /* Start gathers from negative directions */
+  for(dir = XUP; dir <= TUP; dir++){
+    if(start == 1){
+      tag[OPP_DIR(dir)] = start_gather_field( src, sizeof(fsu3_vector),
+			     OPP_DIR(dir), parity, gen_pt[OPP_DIR(dir)] );
+      if(do_long)
+	tag[OPP_3_DIR(DIR3(dir))] = start_gather_field( src,
+			     sizeof(fsu3_vector), OPP_3_DIR(DIR3(dir)), parity,
+			     gen_pt[OPP_3_DIR(DIR3(dir))] );
+    } else {
+      restart_gather_field( src, sizeof(fsu3_vector), OPP_DIR(dir), parity,
+			    gen_pt[OPP_DIR(dir)], tag[OPP_DIR(dir)] );
+      if(do_long)
+	restart_gather_field( src, sizeof(fsu3_vector), OPP_3_DIR(DIR3(dir)),
+			      parity, gen_pt[OPP_3_DIR(DIR3(dir))],
+			      tag[OPP_3_DIR(DIR3(dir))] );
+    }
+  }
+
+  /* Wait gathers from positive directions, multiply by matrix and
+     accumulate */
+  for(dir = XUP; dir <= TUP; dir++){
+    wait_gather(tag[dir]);
+    if(do_long)
+      wait_gather(tag[DIR3(dir)]);
+  }
+
+  FORSOMEPARITYDOMAIN_OMP(i,s,parity,default(shared)){
+    fsu3_vector tvec;
+    int j;
+    mult_su3_mat_vec_sum_4dir_F( t_fatlink + 4*i,
+	    (fsu3_vector *)gen_pt[XUP][i], (fsu3_vector *)gen_pt[YUP][i],
+	    (fsu3_vector *)gen_pt[ZUP][i], (fsu3_vector *)gen_pt[TUP][i],
+	    &dest[i] );
+    if(do_long){
+      mult_su3_mat_vec_sum_4dir_F( t_longlink + 4*i,
+	    (fsu3_vector *)gen_pt[X3UP][i], (fsu3_vector *)gen_pt[Y3UP][i],
+	    (fsu3_vector *)gen_pt[Z3UP][i], (fsu3_vector *)gen_pt[T3UP][i],
+	    &tvec );
+      for(j = 0; j < 3; j++){
+	dest[i].c[j].real += tvec.c[j].real;
+	dest[i].c[j].imag += tvec.c[j].imag;
+      }
+    }
+  } END_LOOP_OMP;
+
+  /* Wait gathers from negative directions, accumulate (negative) */
+  for(dir = XUP; dir <= TUP; dir++){
+    wait_gather(tag[OPP_DIR(dir)]);
+    if(do_long)
+      wait_gather(tag[OPP_3_DIR(DIR3(dir))]);
+  }
+
+  FORSOMEPARITYDOMAIN_OMP(i,s,parity,default(shared)){
+    fsu3_vector tvec;
+    int j;
+    mult_su3_mat_vec_sum_4dir_F( t_fatbacklink + 4*i,
+	    (fsu3_vector *)gen_pt[XDOWN][i], (fsu3_vector *)gen_pt[YDOWN][i],
+	    (fsu3_vector *)gen_pt[ZDOWN][i], (fsu3_vector *)gen_pt[TDOWN][i],
+	    &tvec );
+    if(do_long){
+      mult_su3_mat_vec_sum_F( t_longbacklink + 4*i + XUP,
+	    (fsu3_vector *)gen_pt[X3DOWN][i], &tvec );
+      mult_su3_mat_vec_sum_F( t_longbacklink + 4*i + YUP,
+	    (fsu3_vector *)gen_pt[Y3DOWN][i], &tvec );
+      mult_su3_mat_vec_sum_F( t_longbacklink + 4*i + ZUP,
+	    (fsu3_vector *)gen_pt[Z3DOWN][i], &tvec );
+      mult_su3_mat_vec_sum_F( t_longbacklink + 4*i + TUP,
+	    (fsu3_vector *)gen_pt[T3DOWN][i], &tvec );
+    }
+    for(j = 0; j < 3; j++){
+      dest[i].c[j].real -= tvec.c[j].real;
+      dest[i].c[j].imag -= tvec.c[j].imag;
+    }
+  } END_LOOP_OMP;
+}
+
+/* Free the gathers started by dslash_fn_field_special_F */
+
+static void
+cleanup_gathers_F( msg_tag *tags[] ){
+  int i;
+  for(i = XUP; i <= TUP; i++){
+    cleanup_gather(tags[i]);
+    cleanup_gather(tags[OPP_DIR(i)]);
+#ifndef NO_LONG_LINKS
+    cleanup_gather(tags[DIR3(i)]);
+    cleanup_gather(tags[OPP_3_DIR(DIR3(i))]);
+#endif
+  }
+}
+
+/* resid <- src - (4m^2 - Dslash Dslash) dest in double precision.
+   Returns |resid|^2 summed over nodes */
+
+static double
+true_residual(su3_vector *t_src, su3_vector *t_dest, su3_vector *resid,
+	      su3_vector *ttt, Real msq_x4, int parity, int otherparity,
+	      fn_links_t *fn){
+  int i;
+  double rsq = 0.;
+
+  dslash_fn_field(t_dest, ttt, otherparity, fn);
+  dslash_fn_field(ttt, ttt, parity, fn);
+  FORSOMEFIELDPARITY_OMP(i,parity,reduction(+:rsq)){
+    scalar_mult_add_su3_vector( &ttt[i], &t_dest[i], -msq_x4, &ttt[i] );
+    add_su3_vector( &t_src[i], &ttt[i], &resid[i] );
+    rsq += (double)magsq_su3vec( &resid[i] );
+  } END_LOOP_OMP;
+  g_doublesum( &rsq );
+
+  return rsq;
+}
+
+int
+ks_congrad_parity_mixed_cpu( su3_vector *t_src, su3_vector *t_dest,
+			     quark_invert_control *qic, Real mass,
+			     imp_ferm_links_t *fn){
+  int i, j;
+  int iteration;	/* counter for iterations */
+  int iters_since_update; /* iterations since the last reliable update */
+  int nupdate;          /* number of reliable updates */
+  int converged;
+  double a, b;
+  double rsq, oldrsq, pkp, relrsq = 1.;
+  double maxrsq;        /* largest iterated rsq since the last update */
+  double source_norm;
+  float msq_x4;
+  int otherparity = 0;
+  msg_tag *tags1[16], *tags2[16];
+  int special_started = 0;
+  su3_vector *resid, *ttt;
+  fsu3_vector *r_F, *p_F, *x_F, *t_F;
+#ifdef CGTIME
+  double nflop = 1187;
+#endif
+  double dtimec;
+  char myname[] = "ks_congrad_parity_mixed_cpu";
+
+  /* Unpack structure */
+  int niter        = qic->max;      /* maximum number of iters per restart */
+  int max_restarts = qic->nrestart; /* maximum restarts */
+  Real rsqmin      = qic->resid * qic->resid;
+  Real relrsqmin   = qic->relresid * qic->relresid;
+  int parity       = qic->parity;   /* EVEN, ODD */
+
+  int max_cg = max_restarts*niter; /* Maximum number of iterations */
+
+  if(fn == NULL){
+    printf("%s(%d): Called with NULL fn\n", myname, this_node);
+    terminate(1);
+  }
+  if(parity == EVENANDODD){
+    printf("%s(%d): EVENANDODD not supported\n", myname, this_node);
+    terminate(1);
+  }
+
+  dtimec = -dclock();
+
+  msq_x4 = 4.0*mass*mass;
+  otherparity = (parity == EVEN) ? ODD : EVEN;
+
+  /* Source norm */
+  source_norm = 0.0;
+  FORSOMEFIELDPARITY_OMP(i,parity,reduction(+:source_norm)){
+    source_norm += (double)magsq_su3vec( &t_src[i] );
+  } END_LOOP_OMP;
+  g_doublesum( &source_norm );
+
+  iteration = 0;
+  iters_since_update = 0;
+  nupdate = 0;
+  qic->size_r = 0;
+  qic->size_relr = 1.;
+  qic->final_iters   = 0;
+  qic->final_restart = 0;
+  qic->converged     = 1;
+  qic->final_rsq = 0.;
+  qic->final_relrsq = 0.;
+
+  /* Provision for trivial solution */
+  if(source_norm == 0.0){
+    FORSOMEFIELDPARITY_OMP(i,parity,default(shared)){
+      memset(t_dest + i, 0, sizeof(su3_vector));
+    } END_LOOP_OMP;
+    return 0;
+  }
+
+  resid = create_v_field();
+  ttt = create_v_field();
+  r_F = create_v_field_F();
+  p_F = create_v_field_F();
+  x_F = create_v_field_F();
+  t_F = create_v_field_F();
+
+  /* Initial true residual.  p_F <- r_F <- resid */
+  rsq = true_residual(t_src, t_dest, resid, ttt, msq_x4, parity,
+		      otherparity, fn);
+  iteration++;
+  total_iters++;
+  FORSOMEFIELDPARITY_OMP(i,parity,private(j)){
+    for(j = 0; j < 3; j++){
+      r_F[i].c[j].real = resid[i].c[j].real;
+      r_F[i].c[j].imag = resid[i].c[j].imag;
+    }
+    p_F[i] = r_F[i];
+  } END_LOOP_OMP;
+  maxrsq = rsq;
+
+  if(relrsqmin > 0)
+    relrsq = ks_relative_residue(resid, t_dest, parity);
+  qic->final_rsq    = (Real)rsq/source_norm;
+  qic->final_relrsq = (Real)relrsq;
+  converged = ( rsqmin    <= 0 || rsqmin    > qic->final_rsq   ) &&
+              ( relrsqmin <= 0 || relrsqmin > qic->final_relrsq);
+
+  while(!converged && iteration < max_cg){
+
+    /* t_F <- (4m^2 - Dslash Dslash) p_F,  pkp <- p_F.t_F */
+    if(special_started == 0){
+      dslash_fn_field_special_F( p_F, t_F, otherparity, tags2, 1, fn );
+      dslash_fn_field_special_F( t_F, t_F, parity, tags1, 1, fn );
+      special_started = 1;
+    } else {
+      dslash_fn_field_special_F( p_F, t_F, otherparity, tags2, 0, fn );
+      dslash_fn_field_special_F( t_F, t_F, parity, tags1, 0, fn );
+    }
+
+    pkp = 0.;
+    FORSOMEFIELDPARITY_OMP(i,parity,reduction(+:pkp)){
+      scalar_mult_add_su3_vector_F( &t_F[i], &p_F[i], -msq_x4, &t_F[i] );
+      pkp -= su3_rdot_F( &p_F[i], &t_F[i] );
+    } END_LOOP_OMP;
+    g_doublesum( &pkp );
+    iteration++;
+    iters_since_update++;
+    total_iters++;
+
+    /* x_F <- x_F + a p_F,  r_F <- r_F - a t_F */
+    a = rsq/pkp;
+    oldrsq = rsq;
+    rsq = 0.;
+    FORSOMEFIELDPARITY_OMP(i,parity,reduction(+:rsq)){
+      scalar_mult_add_su3_vector_F( &x_F[i], &p_F[i], (float)a, &x_F[i] );
+      scalar_mult_add_su3_vector_F( &r_F[i], &t_F[i], (float)a, &r_F[i] );
+      rsq += su3_rdot_F( &r_F[i], &r_F[i] );
+    } END_LOOP_OMP;
+    g_doublesum( &rsq );
+
+    qic->size_r = (Real)rsq/source_norm;
+    if(rsq > maxrsq)maxrsq = rsq;
+
+#ifdef CG_DEBUG
+    if(mynode()==0){printf("iter=%d, rsq/src= %e, pkp=%e\n",
+			   iteration,(double)qic->size_r,(double)pkp);
+      fflush(stdout);}
+#endif
+
+    /* Reliable update */
+    if( rsq < KS_CG_MIXED_DELTA*KS_CG_MIXED_DELTA*maxrsq ||
+	( rsqmin > 0 && rsqmin > qic->size_r ) ||
+	iters_since_update >= niter || iteration >= max_cg ){
+
+      if(special_started == 1){
+	cleanup_gathers_F(tags1);
+	cleanup_gathers_F(tags2);
+	special_started = 0;
+      }
+
+      /* t_dest <- t_dest + x_F,  x_F <- 0 */
+      FORSOMEFIELDPARITY_OMP(i,parity,private(j)){
+	for(j = 0; j < 3; j++){
+	  t_dest[i].c[j].real += x_F[i].c[j].real;
+	  t_dest[i].c[j].imag += x_F[i].c[j].imag;
+	}
+	clearvec_F( &x_F[i] );
+      } END_LOOP_OMP;
+
+      rsq = true_residual(t_src, t_dest, resid, ttt, msq_x4, parity,
+			  otherparity, fn);
+      iteration++;
+      total_iters++;
+      nupdate++;
+      iters_since_update = 0;
+
+      FORSOMEFIELDPARITY_OMP(i,parity,private(j)){
+	for(j = 0; j < 3; j++){
+	  r_F[i].c[j].real = resid[i].c[j].real;
+	  r_F[i].c[j].imag = resid[i].c[j].imag;
+	}
+      } END_LOOP_OMP;
+      maxrsq = rsq;
+
+      if(relrsqmin > 0)
+	relrsq = ks_relative_residue(resid, t_dest, parity);
+      qic->final_rsq    = (Real)rsq/source_norm;
+      qic->final_relrsq = (Real)relrsq;
+      qic->size_r       = qic->final_rsq;
+      qic->size_relr    = relrsq;
+
+#ifdef CG_DEBUG
+      if(this_node==0)printf("CONGRAD: update %d rsq = %.10e relrsq %.10e\n",
+			     nupdate, qic->final_rsq, qic->final_relrsq);
+#endif
+      converged = ( rsqmin    <= 0 || rsqmin    > qic->final_rsq   ) &&
+	          ( relrsqmin <= 0 || relrsqmin > qic->final_relrsq);
+      if(converged)break;
+    }
+
+    /* p_F <- r_F + b p_F */
+    b = rsq/oldrsq;
+    FORSOMEFIELDPARITY_OMP(i,parity,default(shared)){
+      scalar_mult_add_su3_vector_F( &r_F[i], &p_F[i], (float)b, &p_F[i] );
+    } END_LOOP_OMP;
+  }
+
+  if(special_started == 1){
+    cleanup_gathers_F(tags1);
+    cleanup_gathers_F(tags2);
+  }
+  cleanup_dslash_temps();
+
+  qic->final_iters   = iteration;
+  qic->final_restart = nupdate;
+  qic->converged     = converged;
+
+  free(t_F); free(x_F); free(p_F); free(r_F);
+  destroy_v_field(ttt);
+  destroy_v_field(resid);
+
+  dtimec += dclock();
+#ifdef CGTIME
+  if(this_node==0){
+    printf("CONGRAD5: time = %e (fn F-D) masses = 1 iters = %d mflops = %e\n",
+	   dtimec, qic->final_iters,
+	   (double)(nflop*volume*qic->final_iters/(1.0e6*dtimec*numnodes())) );
+    fflush(stdout);}
+#endif
+
+  return iteration;
+}
+
+#endif /* KS_CG_MIXED && MILC_PRECISION == 2 */
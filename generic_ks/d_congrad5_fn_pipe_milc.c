@@ -0,0 +1,290 @@
+/******* d_congrad5_fn_pipe_milc.c - pipelined CG for SU3/fermions ****/
+/* MIMD version 7 */
+/* Kogut-Susskind fermions -- this version for "fat plus Naik" quark
+   actions.
+
+   Pipelined conjugate gradient (Ghysels and Vanroose, Parallel
+   Computing 40 (2014) 224) for the plain MILC build.  Requires
+   -DKS_CG_PIPELINED.  It replaces ks_congrad_parity_cpu for single
+   parity solves.
+
+   The standard CG needs two global sums per iteration, each followed
+   at once by work that depends on it.  The pipelined recurrence
+   carries w = A r, s = A p and z = A s along with r and p, so that both
+   inner products (r,r) and (w,r) of an iteration are available before
+   its matrix-vector product.  They are summed in one nonblocking
+   reduction (start_g_vecdoublesum), and the product q = A w is computed
+   while the reduction is in flight.  Here A = M_adjoint M =
+   4m^2 - Dslash_eo Dslash_oe on the selected parity.
+
+   The price is three more vectors and three more vector updates per
+   iteration, and a slow drift of the iterated residual away from the
+   true one.  As in ks_congrad_parity_cpu the true residual is
+   recomputed at every restart (every qic->max iterations) and when the
+   iterated residual appears to have met the stopping condition, and
+   the stopping criteria are applied to the true residual.  A restart
+   costs two applications of A and is counted as two iterations.
+
+   When a relative (FNAL) residual is requested, its sum over sites is
+   added to the same nonblocking reduction.
+*/
+
+#include "generic_ks_includes.h"
+#include "../include/openmp_defs.h"
+#include <string.h>
+
+#ifdef KS_CG_PIPELINED
+
+static const char *prec_label[2] = {"F", "D"};
+
+int
+ks_congrad_parity_pipe_cpu( su3_vector *t_src, su3_vector *t_dest,
+			    quark_invert_control *qic, Real mass,
+			    imp_ferm_links_t *fn){
+  int i;
+  int iteration;	/* counter for iterations */
+  int restart_iter = 0;	/* iteration of the last restart */
+  double rsq = 0, relrsq = 1.;	/* true resid**2, rel resid**2 */
+  double gamma, delta;	/* (r,r) and (w,r) */
+  double oldgamma = 1., a = 0., olda = 1., b, den;
+  double sums[3];
+  sum_tag *stag;
+  Real msq_x4 = 4.0*mass*mass;
+  double source_norm;	/* squared magnitude of source vector */
+  int otherparity = 0;	/* the other parity */
+  msg_tag *tags1[16], *tags2[16];	/* tags for gathers to parity and opposite */
+  int special_started = 0; /* 1 if dslash_fn_field_special has been called */
+  int nrestart;		/* Restart counter */
+  int first;		/* 1 on the first iteration after a restart */
+  su3_vector *r, *w, *q, *z, *s, *p;
+#ifdef CGTIME
+  double nflop = 1187;
+#endif
+  double dtimec;
+  char myname[] = "ks_congrad_parity_pipe_cpu";
+
+  /* Unpack structure */
+  int niter        = qic->max;      /* maximum number of iters per restart */
+  int max_restarts = qic->nrestart; /* maximum restarts */
+  Real rsqmin      = qic->resid * qic->resid;    /* desired residual -
+			 normalized as sqrt(r*r)/sqrt(src_e*src_e) */
+  Real relrsqmin   = qic->relresid * qic->relresid; /* desired relative residual (FNAL)*/
+  int parity       = qic->parity;   /* EVEN, ODD */
+
+  int max_cg = max_restarts*niter; /* Maximum number of iterations */
+
+  if(fn == NULL){
+    printf("%s(%d): Called with NULL fn\n", myname, this_node);
+    terminate(1);
+  }
+
+  dtimec = -dclock();
+
+  switch(parity){
+  case(EVEN): otherparity=ODD; break;
+  case(ODD):  otherparity=EVEN; break;
+  default:
+    node0_printf("%s: requires EVEN or ODD parity\n", myname);
+    terminate(1);
+  }
+
+  /* Source norm */
+  source_norm = 0.0;
+  FORSOMEFIELDPARITY_OMP(i,parity,reduction(+:source_norm)){
+    source_norm += (double)magsq_su3vec( &t_src[i] );
+  } END_LOOP_OMP;
+  g_doublesum( &source_norm );
+
+  nrestart = 0;
+  iteration = 0;
+  qic->size_r = 0;
+  qic->size_relr = 1.;
+  qic->final_iters   = 0;
+  qic->final_restart = 0;
+  qic->converged     = 1;
+  qic->final_rsq = 0.;
+  qic->final_relrsq = 0.;
+
+  /* Provision for trivial solution */
+  if(source_norm == 0.0){
+    FORSOMEFIELDPARITY_OMP(i,parity,default(shared)){
+      memset(t_dest + i, 0, sizeof(su3_vector));
+    } END_LOOP_OMP;
+    return 0;
+  }
+
+  r = create_v_field();
+  w = create_v_field();
+  q = create_v_field();
+  z = create_v_field();
+  s = create_v_field();
+  p = create_v_field();
+
+  first = 1;
+  while(1) {
+
+    if(first){
+      /* (Re)start: r <- src - A dest, then w <- A r */
+      if(special_started==1) {
+	cleanup_gathers(tags1,tags2);
+	special_started=0;
+      }
+      rsq = 0.0;
+      dslash_fn_field(t_dest, q, otherparity, fn);
+      dslash_fn_field(q, q, parity, fn);
+      FORSOMEFIELDPARITY_OMP(i,parity,reduction(+:rsq)){
+	scalar_mult_add_su3_vector( &q[i], &t_dest[i], -msq_x4, &q[i] );
+	add_su3_vector( &t_src[i], &q[i], &r[i] );
+	rsq += (double)magsq_su3vec( &r[i] );
+      } END_LOOP_OMP;
+      g_doublesum( &rsq );
+
+      if(relrsqmin > 0)
+	relrsq = ks_relative_residue(r, t_dest, parity);
+
+      qic->final_rsq    = (Real)rsq/source_norm;
+      qic->final_relrsq = (Real)relrsq;
+
+      iteration++;
+      total_iters++;
+
+#ifdef CG_DEBUG
+      if(this_node==0)printf("CONGRAD_PIPE: (re)start %d rsq = %.10e relrsq %.10e\n",
+			     nrestart, qic->final_rsq, qic->final_relrsq);
+#endif
+      if( iteration >= max_cg ||
+	  nrestart  >= max_restarts ||
+	  ( ( rsqmin    <= 0 || rsqmin    > qic->final_rsq   ) &&
+	    ( relrsqmin <= 0 || relrsqmin > qic->final_relrsq) ) ) break;
+
+      nrestart++;
+      restart_iter = iteration;
+
+      dslash_fn_field(r, w, otherparity, fn);
+      dslash_fn_field(w, w, parity, fn);
+      FORSOMEFIELDPARITY_OMP(i,parity,default(shared)){
+	scalar_mult_su3_vector( &w[i], -1.0, &w[i] );
+	scalar_mult_sum_su3_vector( &w[i], &r[i], msq_x4 );
+      } END_LOOP_OMP;
+      iteration++;
+      total_iters++;
+    }
+
+    /* gamma <- (r,r), delta <- (w,r), summed while q <- A w */
+    gamma = 0.0; delta = 0.0;
+    FORSOMEFIELDPARITY_OMP(i,parity,reduction(+:gamma,delta)){
+      gamma += (double)magsq_su3vec( &r[i] );
+      delta += (double)su3_rdot( &w[i], &r[i] );
+    } END_LOOP_OMP;
+    sums[0] = gamma; sums[1] = delta;
+    sums[2] = (relrsqmin > 0) ? ks_relative_residue_sum(r, t_dest, parity) : 0.;
+    stag = start_g_vecdoublesum( sums, 3 );
+
+    if(special_started==0){
+      dslash_fn_field_special( w, q, otherparity, tags2, 1, fn );
+      dslash_fn_field_special( q, q, parity, tags1, 1, fn );
+      special_started=1;
+    }
+    else {
+      dslash_fn_field_special( w, q, otherparity, tags2, 0, fn );
+      dslash_fn_field_special( q, q, parity, tags1, 0, fn );
+    }
+    FORSOMEFIELDPARITY_OMP(i,parity,default(shared)){
+      scalar_mult_su3_vector( &q[i], -1.0, &q[i] );
+      scalar_mult_sum_su3_vector( &q[i], &w[i], msq_x4 );
+    } END_LOOP_OMP;
+
+    wait_g_vecdoublesum( stag );
+    gamma = sums[0]; delta = sums[1];
+    iteration++;
+    total_iters++;
+
+    if(relrsqmin > 0)
+      relrsq = ks_relative_residue_norm(sums[2], parity);
+
+    qic->size_r        = (Real)gamma/source_norm;
+    qic->size_relr     = relrsq;
+    qic->final_iters   = iteration;
+    qic->final_restart = nrestart;
+
+#ifdef CG_DEBUG
+    if(mynode()==0){printf("iter=%d, rsq/src= %e, relrsq= %e, delta=%e\n",
+			   iteration,(double)qic->size_r,
+			   (double)qic->size_relr, delta);fflush(stdout);}
+#endif
+
+    /* Check the true residual when the iterated one says we are done,
+       and restart every niter iterations */
+    if( iteration - restart_iter >= niter || iteration >= max_cg ||
+	( ( rsqmin    <= 0 || rsqmin    > qic->size_r   ) &&
+	  ( relrsqmin <= 0 || relrsqmin > qic->size_relr) ) ){
+      first = 1;
+      continue;
+    }
+
+    if(first){
+      b = 0.;
+      den = delta;
+    } else {
+      b = gamma/oldgamma;
+      den = delta - b*gamma/olda;
+    }
+    /* Loss of positivity from roundoff.  Start over */
+    if(den <= 0.){
+      first = 1;
+      continue;
+    }
+    a = gamma/den;
+
+    /* z <- q + b z,  s <- w + b s,  p <- r + b p
+       dest <- dest + a p,  r <- r - a s,  w <- w - a z */
+    FORSOMEFIELDPARITY_OMP(i,parity,default(shared)){
+      if(first){
+	z[i] = q[i];
+	s[i] = w[i];
+	p[i] = r[i];
+      } else {
+	scalar_mult_add_su3_vector( &q[i], &z[i], b, &z[i] );
+	scalar_mult_add_su3_vector( &w[i], &s[i], b, &s[i] );
+	scalar_mult_add_su3_vector( &r[i], &p[i], b, &p[i] );
+      }
+      scalar_mult_sum_su3_vector( &t_dest[i], &p[i], a );
+      scalar_mult_sum_su3_vector( &r[i], &s[i], -a );
+      scalar_mult_sum_su3_vector( &w[i], &z[i], -a );
+    } END_LOOP_OMP;
+
+    oldgamma = gamma;
+    olda = a;
+    first = 0;
+  }
+
+  qic->final_iters   = iteration;
+  qic->final_restart = nrestart;
+  qic->converged     = 1;
+  if(nrestart == max_restarts || iteration >= max_cg){
+    qic->converged = 0;
+    fflush(stdout);
+  }
+
+  if(special_started==1) {
+    cleanup_gathers(tags1,tags2);
+    special_started = 0;
+  }
+  cleanup_dslash_temps();
+
+  destroy_v_field(r); destroy_v_field(w); destroy_v_field(q);
+  destroy_v_field(z); destroy_v_field(s); destroy_v_field(p);
+
+  dtimec += dclock();
+#ifdef CGTIME
+  if(this_node==0){
+    printf("CONGRAD5: time = %e (fn %s pipelined) masses = 1 iters = %d mflops = %e\n",
+	   dtimec, prec_label[MILC_PRECISION-1], qic->final_iters,
+	   (double)(nflop*volume*qic->final_iters/(1.0e6*dtimec*numnodes())) );
+    fflush(stdout);}
+#endif
+
+  return iteration;
+}
+
+#endif /* KS_CG_PIPELINED */
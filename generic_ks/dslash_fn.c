@@ -26,6 +26,10 @@
 static su3_vector *temp[9] ;
 /* Flag indicating if temp is allocated               */
 static int temp_not_allocated=1 ;
+/* Interleaved work space for dslash_fn_field_multi, kept between
+   calls and grown as needed */
+static su3_vector *multi_buf = NULL, *multi_tbuf = NULL, *multi_lbuf = NULL;
+static int multi_nrhs = 0;
 
 static void 
 cleanup_one_gather_set(msg_tag *tags[])
@@ -56,6 +60,11 @@ void cleanup_dslash_temps(){
       free(temp[i]) ; 
     }
   temp_not_allocated=1 ;
+  if(multi_nrhs > 0){
+    free(multi_buf); free(multi_tbuf); free(multi_lbuf);
+    multi_buf = multi_tbuf = multi_lbuf = NULL;
+    multi_nrhs = 0;
+  }
 }
 
 
@@ -575,6 +584,175 @@ void dslash_fn_field_special(su3_vector *src, su3_vector *dest,
       
 }
 
+/* Multiple right-hand-side dslash.  Applies the same Dslash to nrhs
+   source fields at once.  Each fat/long link matrix is loaded from
+   memory once per site and applied to all nrhs vectors while it is in
+   cache.  Sources and the adjoint-multiplied backward terms are
+   interleaved site by site, so each gather moves all nrhs vectors in
+   a single message per direction.  Results are identical to nrhs
+   calls to dslash_fn_field. */
+
+static msg_tag *
+start_strided_gather_multi(void *field, size_t stride, size_t size, 
+			   int index, int parity, char **dest)
+{
+  msg_tag *mt = declare_strided_gather(field, stride, size, index, 
+				       parity, dest);
+  prepare_gather(mt);
+  do_gather(mt);
+  return mt;
+}
+
+void dslash_fn_field_multi(su3_vector **src, su3_vector **dest, int nrhs,
+			   int parity, fn_links_t *fn){
+  register int i;
+  register site *s;
+  register int dir, k;
+  int otherparity = 0;
+  su3_matrix *fat4, *long4;
+  su3_matrix *t_fatlink, *t_longlink;
+#ifndef NO_LONG_LINKS
+  int do_long = 1;
+#else
+  int do_long = 0;
+#endif
+  su3_vector *buf, *tbuf, *lbuf;
+  size_t vsize = nrhs*sizeof(su3_vector);
+  msg_tag *tag[16];
+  char myname[] = "dslash_fn_field_multi";
+
+  if(nrhs <= 0)return;
+
+  if(fn == NULL){
+    printf("%s: invalid fn links!\n", myname);
+    terminate(1);
+  }
+  t_fatlink = get_fatlinks(fn);
+  t_longlink = get_lnglinks(fn);
+
+  switch(parity){
+  case EVEN:       otherparity=ODD; break;
+  case ODD:        otherparity=EVEN; break;
+  case EVENANDODD: otherparity=EVENANDODD; break;
+  }
+
+  /* buf[nrhs*i+k] = src[k][i] 
+     tbuf[nrhs*(8*i+d)+k] = adjoint link d times src[k][i] 
+     lbuf[nrhs*i+k] = Naik term of dest[k][i] */
+  if(nrhs > multi_nrhs){
+    free(multi_buf); free(multi_tbuf); free(multi_lbuf);
+    multi_buf = (su3_vector *)malloc(sites_on_node*vsize);
+    multi_tbuf = (su3_vector *)malloc(8*sites_on_node*vsize);
+    multi_lbuf = (su3_vector *)malloc(sites_on_node*vsize);
+    if(multi_buf == NULL || multi_tbuf == NULL || multi_lbuf == NULL){
+      printf("%s(%d): No room for temporary\n", myname, this_node);
+      terminate(1);
+    }
+    multi_nrhs = nrhs;
+  }
+  buf = multi_buf;
+  tbuf = multi_tbuf;
+  lbuf = multi_lbuf;
+  FORSOMEFIELDPARITY_OMP(i,otherparity,private(k)){
+    for(k = 0; k < nrhs; k++)
+      buf[nrhs*i+k] = src[k][i];
+  } END_LOOP_OMP;
+
+  /* Start gathers from positive directions */
+  for(dir = XUP; dir <= TUP; dir++){
+    tag[dir] = start_gather_field(buf, vsize, dir, parity, gen_pt[dir]);
+    if(do_long)
+      tag[DIR3(dir)] = start_gather_field(buf, vsize, DIR3(dir), parity,
+					  gen_pt[DIR3(dir)]);
+  }
+
+  /* Multiply by adjoint matrix at other sites */
+  FORSOMEPARITYDOMAIN_OMP(i,s,otherparity,private(k,fat4,long4)){
+    fat4 = &(t_fatlink[4*i]);
+    long4 = do_long ? &(t_longlink[4*i]) : NULL;
+    for(k = 0; k < nrhs; k++){
+      mult_adj_su3_mat_4vec( fat4, &(src[k][i]), 
+			     tbuf + nrhs*(8*i+0) + k, tbuf + nrhs*(8*i+1) + k,
+			     tbuf + nrhs*(8*i+2) + k, tbuf + nrhs*(8*i+3) + k );
+      if(do_long)
+	mult_adj_su3_mat_4vec( long4, &(src[k][i]),
+			     tbuf + nrhs*(8*i+4) + k, tbuf + nrhs*(8*i+5) + k,
+			     tbuf + nrhs*(8*i+6) + k, tbuf + nrhs*(8*i+7) + k );
+    }
+  } END_LOOP_OMP;
+
+  /* Start gathers from negative directions */
+  for(dir = XUP; dir <= TUP; dir++){
+    tag[OPP_DIR(dir)] = 
+      start_strided_gather_multi(tbuf + nrhs*dir, 8*vsize, vsize,
+				 OPP_DIR(dir), parity, gen_pt[OPP_DIR(dir)]);
+    if(do_long)
+      tag[OPP_3_DIR(DIR3(dir))] = 
+	start_strided_gather_multi(tbuf + nrhs*(dir+4), 8*vsize, vsize,
+				   OPP_3_DIR(DIR3(dir)), parity, 
+				   gen_pt[OPP_3_DIR(DIR3(dir))]);
+  }
+
+  /* Wait gathers from positive directions, multiply by matrix and
+     accumulate */
+  for(dir = XUP; dir <= TUP; dir++){
+    wait_gather(tag[dir]);
+    if(do_long)
+      wait_gather(tag[DIR3(dir)]);
+  }
+
+  FORSOMEPARITYDOMAIN_OMP(i,s,parity,private(k,fat4,long4)){
+    fat4 = &(t_fatlink[4*i]);
+    long4 = do_long ? &(t_longlink[4*i]) : NULL;
+    for(k = 0; k < nrhs; k++){
+      mult_su3_mat_vec_sum_4dir( fat4,
+	    (su3_vector *)gen_pt[XUP][i] + k, (su3_vector *)gen_pt[YUP][i] + k,
+	    (su3_vector *)gen_pt[ZUP][i] + k, (su3_vector *)gen_pt[TUP][i] + k,
+	    &(dest[k][i]) );
+      if(do_long){
+	mult_su3_mat_vec_sum_4dir( long4,
+	    (su3_vector *)gen_pt[X3UP][i] + k, (su3_vector *)gen_pt[Y3UP][i] + k,
+	    (su3_vector *)gen_pt[Z3UP][i] + k, (su3_vector *)gen_pt[T3UP][i] + k,
+	    lbuf + nrhs*i + k );
+      }
+    }
+  } END_LOOP_OMP;
+
+  /* Wait gathers from negative directions, accumulate (negative) */
+  for(dir = XUP; dir <= TUP; dir++){
+    wait_gather(tag[OPP_DIR(dir)]);
+    if(do_long)
+      wait_gather(tag[OPP_3_DIR(DIR3(dir))]);
+  }
+
+  FORSOMEPARITYDOMAIN_OMP(i,s,parity,private(k)){
+    for(k = 0; k < nrhs; k++){
+      sub_four_su3_vecs( &(dest[k][i]),
+			 (su3_vector *)gen_pt[XDOWN][i] + k,
+			 (su3_vector *)gen_pt[YDOWN][i] + k,
+			 (su3_vector *)gen_pt[ZDOWN][i] + k,
+			 (su3_vector *)gen_pt[TDOWN][i] + k );
+      if(do_long){
+	sub_four_su3_vecs( lbuf + nrhs*i + k,
+			   (su3_vector *)gen_pt[X3DOWN][i] + k,
+			   (su3_vector *)gen_pt[Y3DOWN][i] + k,
+			   (su3_vector *)gen_pt[Z3DOWN][i] + k,
+			   (su3_vector *)gen_pt[T3DOWN][i] + k );
+	add_su3_vector(&(dest[k][i]), lbuf + nrhs*i + k, &(dest[k][i]));
+      }
+    }
+  } END_LOOP_OMP;
+
+  for(dir = XUP; dir <= TUP; dir++){
+    cleanup_gather(tag[dir]);
+    cleanup_gather(tag[OPP_DIR(dir)]);
+    if(do_long){
+      cleanup_gather(tag[DIR3(dir)]);
+      cleanup_gather(tag[OPP_3_DIR(DIR3(dir))]);
+    }
+  }
+}
+
 void 
 dslash_fn_dir(su3_vector *src, su3_vector *dest, int parity,
 	      fn_links_t *fn, int dir, int fb, 
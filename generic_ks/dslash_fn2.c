@@ -527,6 +527,16 @@ void dslash_fn_field_special(su3_vector *src, su3_vector *dest,
 
 }
 
+/* Multiple right-hand-side dslash.  No batching in this version.
+   See dslash_fn_dblstore.c */
+void dslash_fn_field_multi(su3_vector **src, su3_vector **dest, int nrhs,
+			   int parity, fn_links_t *fn){
+  int k;
+
+  for(k = 0; k < nrhs; k++)
+    dslash_fn_field(src[k], dest[k], parity, fn);
+}
+
 /* Apply a Fat-Naik dslash-type shift in direction "dir", either
    forward or backward and with specified weights for the fat and Naik
    components.  Do this for dest sites of the specified
@@ -8,9 +8,10 @@
 /* This version double stores long and fat links  */
 
 
-/* This version overlaps computation and gathers from negative
-   directions, and has an extra lattice loop devoted to exclusively to
-   sub_four_vectors (traditional algorithm) */
+/* This version computes the sites with no off-node neighbors while
+   all gathers are in flight and the remaining sites after they
+   complete (the Schroedinger functional version overlaps computation
+   with the gathers from negative directions only) */
 
 /* Jim Hetrick, Kari Rummukainen, Doug Toussaint, Steven Gottlieb */
 /* C. DeTar 9/29/01 Standardized prefetching and synced versions */
@@ -27,6 +28,239 @@
 BOMB.  Requires compilation with -DDBLSTORE_FN
 #endif
 
+/* Interleaved work space for dslash_fn_field_multi, kept between
+   calls and grown as needed */
+static su3_vector *multi_buf = NULL;
+static int multi_nrhs = 0;
+
+#ifdef D_FN_SOA
+#ifdef SCHROED_FUN
+BOMB.  D_FN_SOA does not support SCHROED_FUN
+#endif
+
+/* Kernels for the SIMD (structure of arrays) link layout.  The
+   neighbor vectors found through gen_pt are transposed into SIMD tiles
+   block by block, and the links are read from the SIMD copies kept in
+   the fn_links_t.  Each gathered record holds nrhs vectors, one for
+   each dest[k], so a block of links is reused for all of them. */
+
+static void
+load_soa_tiles(su3_vector_soa t[4], char **gp[4], int i0, int n, int k){
+  int d, c, l;
+
+  for(d = 0; d < 4; d++){
+    for(l = 0; l < n; l++){
+      su3_vector *v = (su3_vector *)gp[d][i0+l] + k;
+      for(c = 0; c < 3; c++){
+	t[d].re[c][l] = v->c[c].real;
+	t[d].im[c][l] = v->c[c].imag;
+      }
+    }
+    for(; l < SOA_VLEN; l++)
+      for(c = 0; c < 3; c++){
+	t[d].re[c][l] = 0.;
+	t[d].im[c][l] = 0.;
+      }
+  }
+}
+
+/* dest[k] <- sum over positive directions of fat and long links times
+   the gathered neighbors */
+static void
+dslash_fn_soa_fwd(su3_vector **dest, int nrhs, int parity, fn_links_t *fn,
+		  int do_long){
+  su3_matrix_soa *fat = get_fatlinks_soa(fn);
+  su3_matrix_soa *lng = get_lnglinks_soa(fn);
+  char **gp1[4] = { gen_pt[XUP], gen_pt[YUP], gen_pt[ZUP], gen_pt[TUP] };
+  char **gp3[4] = { gen_pt[X3UP], gen_pt[Y3UP], gen_pt[Z3UP], gen_pt[T3UP] };
+  int b, bend = soa_end_block(parity);
+
+#ifdef OMP
+#pragma omp parallel for
+#endif
+  for(b = soa_first_block(parity); b < bend; b++){
+    su3_vector_soa t[4], acc, tl;
+    int i0, n, c, l, k;
+
+    soa_block_sites(b, &i0, &n);
+    for(k = 0; k < nrhs; k++){
+      load_soa_tiles(t, gp1, i0, n, k);
+      mult_su3_mat_vec_sum_4dir_soa(fat + 4*b, t, &acc);
+      if(do_long){
+	load_soa_tiles(t, gp3, i0, n, k);
+	mult_su3_mat_vec_sum_4dir_soa(lng + 4*b, t, &tl);
+	for(c = 0; c < 3; c++)
+	  for(l = 0; l < SOA_VLEN; l++){
+	    acc.re[c][l] += tl.re[c][l];
+	    acc.im[c][l] += tl.im[c][l];
+	  }
+      }
+      for(l = 0; l < n; l++)
+	for(c = 0; c < 3; c++){
+	  dest[k][i0+l].c[c].real = acc.re[c][l];
+	  dest[k][i0+l].c[c].imag = acc.im[c][l];
+	}
+    }
+  }
+}
+
+/* dest[k] <- dest[k] - sum over negative directions of the back links
+   times the gathered neighbors */
+static void
+dslash_fn_soa_back(su3_vector **dest, int nrhs, int parity, fn_links_t *fn,
+		   int do_long){
+  su3_matrix_soa *fatback = get_fatbacklinks_soa(fn);
+  su3_matrix_soa *lngback = get_lngbacklinks_soa(fn);
+  char **gp1[4] = { gen_pt[XDOWN], gen_pt[YDOWN], gen_pt[ZDOWN], 
+		    gen_pt[TDOWN] };
+  char **gp3[4] = { gen_pt[X3DOWN], gen_pt[Y3DOWN], gen_pt[Z3DOWN], 
+		    gen_pt[T3DOWN] };
+  int b, bend = soa_end_block(parity);
+
+#ifdef OMP
+#pragma omp parallel for
+#endif
+  for(b = soa_first_block(parity); b < bend; b++){
+    su3_vector_soa t[4], acc, tl;
+    int i0, n, c, l, k;
+
+    soa_block_sites(b, &i0, &n);
+    for(k = 0; k < nrhs; k++){
+      for(l = 0; l < n; l++)
+	for(c = 0; c < 3; c++){
+	  acc.re[c][l] = dest[k][i0+l].c[c].real;
+	  acc.im[c][l] = dest[k][i0+l].c[c].imag;
+	}
+      for(; l < SOA_VLEN; l++)
+	for(c = 0; c < 3; c++){
+	  acc.re[c][l] = 0.;
+	  acc.im[c][l] = 0.;
+	}
+      load_soa_tiles(t, gp1, i0, n, k);
+      mult_su3_mat_vec_sum_4dir_soa(fatback + 4*b, t, &tl);
+      for(c = 0; c < 3; c++)
+	for(l = 0; l < SOA_VLEN; l++){
+	  acc.re[c][l] -= tl.re[c][l];
+	  acc.im[c][l] -= tl.im[c][l];
+	}
+      if(do_long){
+	load_soa_tiles(t, gp3, i0, n, k);
+	mult_su3_mat_vec_sum_4dir_soa(lngback + 4*b, t, &tl);
+	for(c = 0; c < 3; c++)
+	  for(l = 0; l < SOA_VLEN; l++){
+	    acc.re[c][l] -= tl.re[c][l];
+	    acc.im[c][l] -= tl.im[c][l];
+	  }
+      }
+      for(l = 0; l < n; l++)
+	for(c = 0; c < 3; c++){
+	  dest[k][i0+l].c[c].real = acc.re[c][l];
+	  dest[k][i0+l].c[c].imag = acc.im[c][l];
+	}
+    }
+  }
+}
+#endif /* D_FN_SOA */
+
+#if !defined(SCHROED_FUN) && !defined(D_FN_SOA)
+/* Overlap of computation with communication.  Sites whose first and
+   third neighbors are all on this node ("interior" sites) are done
+   while the gathers are in flight, the rest ("boundary" sites) after
+   the gathers complete.  The site lists depend only on the layout and
+   are built on first use. */
+#define D_FN_OVERLAP
+
+static int *fn_site_list[3] = {NULL, NULL, NULL}; /* EVEN, ODD, EVENANDODD */
+static int fn_ninterior[3];
+static int fn_nsites[3];
+
+static int
+neighbors_on_node(site *s, int do_long){
+  int len[4], c[4], hop[4] = {1, -1, 3, -3};
+  int dir, k, nhop = do_long ? 4 : 2;
+
+  len[XUP] = nx; len[YUP] = ny; len[ZUP] = nz; len[TUP] = nt;
+  for(dir = XUP; dir <= TUP; dir++)
+    for(k = 0; k < nhop; k++){
+      c[XUP] = s->x; c[YUP] = s->y; c[ZUP] = s->z; c[TUP] = s->t;
+      c[dir] = (c[dir] + hop[k] + len[dir]) % len[dir];
+      if(node_number(c[XUP], c[YUP], c[ZUP], c[TUP]) != this_node)
+	return 0;
+    }
+  return 1;
+}
+
+/* Interior sites of the given parity, followed by the boundary sites */
+static int *
+get_fn_site_list(int parity, int do_long, int *ninterior, int *nsites){
+  int slot = (parity == EVEN) ? 0 : (parity == ODD) ? 1 : 2;
+  int i, n, pass;
+  site *s;
+
+  if(fn_site_list[slot] == NULL){
+    int *list = (int *)malloc(sites_on_node*sizeof(int));
+    if(list == NULL){
+      printf("get_fn_site_list(%d): no room\n", this_node);
+      terminate(1);
+    }
+    n = 0;
+    for(pass = 1; pass >= 0; pass--){
+      FORSOMEPARITYDOMAIN(i,s,parity){
+	if(neighbors_on_node(s, do_long) == pass)
+	  list[n++] = i;
+      } END_LOOP;
+      if(pass == 1)fn_ninterior[slot] = n;
+    }
+    fn_nsites[slot] = n;
+    fn_site_list[slot] = list;
+  }
+
+  *ninterior = fn_ninterior[slot];
+  *nsites = fn_nsites[slot];
+  return fn_site_list[slot];
+}
+
+/* dest <- Dslash src on the listed sites, from the gen_pt pointers */
+static void
+dslash_fn_listed_sites(su3_vector *dest, int *list, int n, int do_long,
+		       su3_matrix *fat, su3_matrix *fatback,
+		       su3_matrix *lng, su3_matrix *lngback){
+  int j;
+
+#ifdef OMP
+#pragma omp parallel for
+#endif
+  for(j = 0; j < n; j++){
+    int i = list[j];
+    su3_vector tvec;
+
+    mult_su3_mat_vec_sum_4dir( fat + 4*i,
+	    (su3_vector *)gen_pt[XUP][i], (su3_vector *)gen_pt[YUP][i],
+	    (su3_vector *)gen_pt[ZUP][i], (su3_vector *)gen_pt[TUP][i],
+	    &(dest[i]) );
+    if(do_long){
+      mult_su3_mat_vec_sum_4dir( lng + 4*i,
+	    (su3_vector *)gen_pt[X3UP][i], (su3_vector *)gen_pt[Y3UP][i],
+	    (su3_vector *)gen_pt[Z3UP][i], (su3_vector *)gen_pt[T3UP][i],
+	    &tvec );
+      add_su3_vector(&(dest[i]), &tvec, &(dest[i]) );
+    }
+    mult_su3_mat_vec_sum_4dir( fatback + 4*i,
+	    (su3_vector *)gen_pt[XDOWN][i], (su3_vector *)gen_pt[YDOWN][i],
+	    (su3_vector *)gen_pt[ZDOWN][i], (su3_vector *)gen_pt[TDOWN][i],
+	    &tvec );
+    sub_su3_vector(&(dest[i]), &tvec, &(dest[i]) );
+    if(do_long){
+      mult_su3_mat_vec_sum_4dir( lngback + 4*i,
+	    (su3_vector *)gen_pt[X3DOWN][i], (su3_vector *)gen_pt[Y3DOWN][i],
+	    (su3_vector *)gen_pt[Z3DOWN][i], (su3_vector *)gen_pt[T3DOWN][i],
+	    &tvec );
+      sub_su3_vector(&(dest[i]), &tvec, &(dest[i]) );
+    }
+  }
+}
+#endif /* !SCHROED_FUN && !D_FN_SOA */
+
 static void 
 cleanup_one_gather_set(msg_tag *tags[])
 {
@@ -330,12 +564,16 @@ void dslash_fn_field_special(su3_vector *src, su3_vector *dest,
   int coords[4]; /* for avoiding gathers */
   static int d_fn_g13_checked = 0;
 #endif
+#ifdef D_FN_OVERLAP
+  int *site_list, ninterior, nsites;
+#endif
 
   /* load fatlinks and longlinks */
   if(fn == NULL){
     printf("dslash_fn_field_special: invalid fn links!\n");
     terminate(1);
   }
+  PERF_BEGIN("dslash_fn");
   t_fatlink = get_fatlinks(fn);
   t_fatbacklink = get_fatbacklinks(fn);
   t_longlink = get_lnglinks(fn);
@@ -415,6 +653,13 @@ void dslash_fn_field_special(su3_vector *src, su3_vector *dest,
       }
    }
 
+#ifdef D_FN_OVERLAP
+  /* Interior sites need no off-node data */
+  site_list = get_fn_site_list(parity, do_long, &ninterior, &nsites);
+  dslash_fn_listed_sites(dest, site_list, ninterior, do_long, t_fatlink,
+			 t_fatbacklink, t_longlink, t_longbacklink);
+#endif
+
   /* Wait gathers from positive directions, multiply by matrix and
      accumulate */
   /* wait for the 3-neighbours from positive directions, multiply */
@@ -425,52 +670,56 @@ void dslash_fn_field_special(su3_vector *src, su3_vector *dest,
 
 #else //D_GATHER13
   /* Start gathers from positive directions */
-  /* And start the 3-step gather too */
+  /* The 3-step gather goes with the 1-step gather in the same
+     direction, so halos bound for the same node share one message.
+     tag[DIR3(dir)] is then NULL (cleanup_gather ignores it). */
   for( dir=XUP; dir<=TUP; dir++ ){
     if(start==1)
       {
-	tag[dir] = start_gather_field( src, sizeof(su3_vector), 
-					   dir, parity,gen_pt[dir] );
+	tag[dir] = NULL;
+	declare_accumulate_gather_field( &tag[dir], src, sizeof(su3_vector),
+					 dir, parity, gen_pt[dir] );
 	if(do_long)
-	  tag[DIR3(dir)] = start_gather_field(src, sizeof(su3_vector),
-				      DIR3(dir),parity, 
-				      gen_pt[DIR3(dir)] );
-      }
-    else
-      {
-	restart_gather_field( src, sizeof(su3_vector), 
-				  dir, parity,gen_pt[dir], tag[dir]);
-	if(do_long)
-	  restart_gather_field(src, sizeof(su3_vector), DIR3(dir), parity, 
-				 gen_pt[DIR3(dir)], tag[DIR3(dir)]);
+	  declare_accumulate_gather_field( &tag[dir], src, sizeof(su3_vector),
+					   DIR3(dir), parity, gen_pt[DIR3(dir)] );
+	tag[DIR3(dir)] = NULL;
+	prepare_gather( tag[dir] );
       }
+    restart_gather_field( src, sizeof(su3_vector), 
+			  dir, parity,gen_pt[dir], tag[dir]);
   }
   
-  /* Start gathers from negative directions */
+  /* Start gathers from negative directions, together with the
+     3-neighbour gathers */
   for( dir=XUP; dir <= TUP; dir++){
-      if (start==1) tag[OPP_DIR(dir)] = start_gather_field( src,
-	   sizeof(su3_vector), OPP_DIR( dir), parity, gen_pt[OPP_DIR(dir)] );
-      else restart_gather_field( src, sizeof(su3_vector), 
+    if (start==1)
+      {
+	tag[OPP_DIR(dir)] = NULL;
+	declare_accumulate_gather_field( &tag[OPP_DIR(dir)], src,
+		 sizeof(su3_vector), OPP_DIR(dir), parity, gen_pt[OPP_DIR(dir)] );
+	if(do_long)
+	  declare_accumulate_gather_field( &tag[OPP_DIR(dir)], src,
+		   sizeof(su3_vector), OPP_3_DIR(DIR3(dir)), parity,
+		   gen_pt[OPP_3_DIR(DIR3(dir))] );
+	tag[OPP_3_DIR(DIR3(dir))] = NULL;
+	prepare_gather( tag[OPP_DIR(dir)] );
+      }
+    restart_gather_field( src, sizeof(su3_vector), 
 	   OPP_DIR( dir), parity, gen_pt[OPP_DIR(dir)], tag[OPP_DIR(dir)] );
-   }
-
-  /* Start 3-neighbour gathers from negative directions */
-  if(do_long){
-    for( dir=X3UP; dir <= T3UP; dir++){
-      if (start==1) tag[OPP_3_DIR(dir)]=start_gather_field(
-        src, sizeof(su3_vector), OPP_3_DIR( dir), parity, gen_pt[OPP_3_DIR(dir)] );
-      else restart_gather_field( src, sizeof(su3_vector),
-        OPP_3_DIR( dir),parity, gen_pt[OPP_3_DIR(dir)], tag[OPP_3_DIR(dir)] );
-    }
   }
 
+#ifdef D_FN_OVERLAP
+  /* Interior sites need no off-node data */
+  site_list = get_fn_site_list(parity, do_long, &ninterior, &nsites);
+  dslash_fn_listed_sites(dest, site_list, ninterior, do_long, t_fatlink,
+			 t_fatbacklink, t_longlink, t_longbacklink);
+#endif
+
   /* Wait gathers from positive directions, multiply by matrix and
      accumulate */
   /* wait for the 3-neighbours from positive directions, multiply */
   for(dir=XUP; dir<=TUP; dir++){
     wait_gather(tag[dir]);
-    if(do_long)
-      wait_gather(tag[DIR3(dir)]);
   }
 #endif // D_GATHER13
 
@@ -495,25 +744,9 @@ void dslash_fn_field_special(su3_vector *src, su3_vector *dest,
     }
   } END_LOOP_OMP;
 
-#else // SCHROED_FN
-   
-  su3_matrix *long4;
-  FORSOMEPARITYDOMAIN_OMP(i,s,parity,private(fat4,long4,tvec)){
-    fat4 = &(t_fatlink[4*i]);
-    mult_su3_mat_vec_sum_4dir( fat4,
-	    (su3_vector *)gen_pt[XUP][i], (su3_vector *)gen_pt[YUP][i],
-	    (su3_vector *)gen_pt[ZUP][i], (su3_vector *)gen_pt[TUP][i],
-	    &(dest[i]) );
+#elif defined(D_FN_SOA)
 
-    if(do_long){
-      long4 = &(t_longlink[4*i]);
-      mult_su3_mat_vec_sum_4dir( long4,
-	    (su3_vector *)gen_pt[X3UP][i], (su3_vector *)gen_pt[Y3UP][i],
-	    (su3_vector *)gen_pt[Z3UP][i], (su3_vector *)gen_pt[T3UP][i],
-	    &tvec );
-      add_su3_vector(&(dest[i]), &tvec, &(dest[i]) );
-    }
-  } END_LOOP_OMP;
+  dslash_fn_soa_fwd(&dest, 1, parity, fn, do_long);
 
 #endif // SCHROED_FN
    
@@ -533,14 +766,17 @@ void dslash_fn_field_special(su3_vector *src, su3_vector *dest,
   for(dir=XUP; dir<=TUP; dir++){
     wait_gather(tag[OPP_DIR(dir)]);
   }
-  if(do_long){
-    for(dir=X3UP; dir<=T3UP; dir++){
-      wait_gather(tag[OPP_3_DIR(dir)]);
-    }
-  }
 
 #endif
 
+#ifdef D_FN_SOA
+  dslash_fn_soa_back(&dest, 1, parity, fn, do_long);
+#elif defined(D_FN_OVERLAP)
+  /* Boundary sites, now that the gathers are complete */
+  dslash_fn_listed_sites(dest, site_list + ninterior, nsites - ninterior,
+			 do_long, t_fatlink, t_fatbacklink, t_longlink,
+			 t_longbacklink);
+#else
   FORSOMEPARITYDOMAIN_OMP(i,s,parity,private(fatback4,longback4,tvec)){
     fatback4 = &(t_fatbacklink[4*i]);
     mult_su3_mat_vec_sum_4dir( fatback4,
@@ -558,11 +794,172 @@ void dslash_fn_field_special(su3_vector *src, su3_vector *dest,
       sub_su3_vector(&(dest[i]), &tvec, &(dest[i]) );
     }
   } END_LOOP_OMP; 
+#endif
+
+#ifdef PERF_REGIONS
+  {
+    /* Per output site: a matrix-vector multiply per link, the sums,
+       and one read of each link and neighbor */
+    double nsites = parity == EVENANDODD ? sites_on_node :
+      (parity == EVEN ? even_sites_on_node : odd_sites_on_node);
+    int nlinks = do_long ? 16 : 8;
+    PERF_END("dslash_fn", nsites*(66*nlinks + 6*(nlinks-1)),
+	     nsites*(18*nlinks + 6*(nlinks+1))*sizeof(Real));
+  }
+#endif
+}
+
+/* Multiple right-hand-side dslash.  Applies the same Dslash to nrhs
+   source fields at once.  The sources are interleaved site by site
+   into one buffer, so each gather moves all nrhs vectors in a single
+   message per direction, and each fat/long link matrix is loaded from
+   memory once and applied to all nrhs vectors while it is in cache.
+   Results are identical to nrhs calls to dslash_fn_field. */
+
+void dslash_fn_field_multi(su3_vector **src, su3_vector **dest, int nrhs,
+			   int parity, fn_links_t *fn){
+  register int i;
+  register site *s;
+  register int dir, k;
+  int otherparity = 0;
+  su3_matrix *fat4, *fatback4, *long4, *longback4;
+  su3_matrix *t_fatlink, *t_fatbacklink, *t_longlink, *t_longbacklink;
+#ifndef NO_LONG_LINKS
+  int do_long = 1;
+#else
+  int do_long = 0;
+#endif
+  su3_vector tvec;
+  su3_vector *buf;
+  size_t vsize = nrhs*sizeof(su3_vector);
+  msg_tag *tag[16];
+  char myname[] = "dslash_fn_field_multi";
+
+  if(nrhs <= 0)return;
+
+#ifdef SCHROED_FUN
+  /* Keep the special time-boundary treatment in one place */
+  for(k = 0; k < nrhs; k++)
+    dslash_fn_field(src[k], dest[k], parity, fn);
+  return;
+#endif
+
+  if(fn == NULL){
+    printf("%s: invalid fn links!\n", myname);
+    terminate(1);
+  }
+  t_fatlink = get_fatlinks(fn);
+  t_fatbacklink = get_fatbacklinks(fn);
+  t_longlink = get_lnglinks(fn);
+  t_longbacklink = get_lngbacklinks(fn);
+
+  switch(parity){
+  case EVEN:       otherparity=ODD; break;
+  case ODD:        otherparity=EVEN; break;
+  case EVENANDODD: otherparity=EVENANDODD; break;
+  }
+
+  /* Interleave the sources: buf[nrhs*i+k] = src[k][i] */
+  if(nrhs > multi_nrhs){
+    free(multi_buf);
+    multi_buf = (su3_vector *)malloc(sites_on_node*vsize);
+    if(multi_buf == NULL){
+      printf("%s(%d): No room for temporary\n", myname, this_node);
+      terminate(1);
+    }
+    multi_nrhs = nrhs;
+  }
+  buf = multi_buf;
+  FORSOMEFIELDPARITY_OMP(i,otherparity,private(k)){
+    for(k = 0; k < nrhs; k++)
+      buf[nrhs*i+k] = src[k][i];
+  } END_LOOP_OMP;
+
+  /* Start all gathers, positive directions first */
+  for(dir = XUP; dir <= TUP; dir++){
+    tag[dir] = start_gather_field(buf, vsize, dir, parity, gen_pt[dir]);
+    if(do_long)
+      tag[DIR3(dir)] = start_gather_field(buf, vsize, DIR3(dir), parity,
+					  gen_pt[DIR3(dir)]);
+  }
+  for(dir = XUP; dir <= TUP; dir++){
+    tag[OPP_DIR(dir)] = start_gather_field(buf, vsize, OPP_DIR(dir), parity,
+					   gen_pt[OPP_DIR(dir)]);
+    if(do_long)
+      tag[OPP_3_DIR(DIR3(dir))] = 
+	start_gather_field(buf, vsize, OPP_3_DIR(DIR3(dir)), parity, 
+			   gen_pt[OPP_3_DIR(DIR3(dir))]);
+  }
+
+  /* Positive directions */
+  for(dir = XUP; dir <= TUP; dir++){
+    wait_gather(tag[dir]);
+    if(do_long)
+      wait_gather(tag[DIR3(dir)]);
+  }
+
+#ifdef D_FN_SOA
+  dslash_fn_soa_fwd(dest, nrhs, parity, fn, do_long);
+#else
+  FORSOMEPARITYDOMAIN_OMP(i,s,parity,private(k,fat4,long4,tvec)){
+    fat4 = &(t_fatlink[4*i]);
+    long4 = do_long ? &(t_longlink[4*i]) : NULL;
+    for(k = 0; k < nrhs; k++){
+      mult_su3_mat_vec_sum_4dir( fat4,
+	    (su3_vector *)gen_pt[XUP][i] + k, (su3_vector *)gen_pt[YUP][i] + k,
+	    (su3_vector *)gen_pt[ZUP][i] + k, (su3_vector *)gen_pt[TUP][i] + k,
+	    &(dest[k][i]) );
+      if(do_long){
+	mult_su3_mat_vec_sum_4dir( long4,
+	    (su3_vector *)gen_pt[X3UP][i] + k, (su3_vector *)gen_pt[Y3UP][i] + k,
+	    (su3_vector *)gen_pt[Z3UP][i] + k, (su3_vector *)gen_pt[T3UP][i] + k,
+	    &tvec );
+	add_su3_vector(&(dest[k][i]), &tvec, &(dest[k][i]) );
+      }
+    }
+  } END_LOOP_OMP;
+#endif
+
+  /* Negative directions */
+  for(dir = XUP; dir <= TUP; dir++){
+    wait_gather(tag[OPP_DIR(dir)]);
+    if(do_long)
+      wait_gather(tag[OPP_3_DIR(DIR3(dir))]);
+  }
+
+#ifdef D_FN_SOA
+  dslash_fn_soa_back(dest, nrhs, parity, fn, do_long);
+#else
+  FORSOMEPARITYDOMAIN_OMP(i,s,parity,private(k,fatback4,longback4,tvec)){
+    fatback4 = &(t_fatbacklink[4*i]);
+    longback4 = do_long ? &(t_longbacklink[4*i]) : NULL;
+    for(k = 0; k < nrhs; k++){
+      mult_su3_mat_vec_sum_4dir( fatback4,
+	    (su3_vector *)gen_pt[XDOWN][i] + k, (su3_vector *)gen_pt[YDOWN][i] + k,
+	    (su3_vector *)gen_pt[ZDOWN][i] + k, (su3_vector *)gen_pt[TDOWN][i] + k,
+	    &tvec );
+      sub_su3_vector(&(dest[k][i]), &tvec, &(dest[k][i]) );
+      if(do_long){
+	mult_su3_mat_vec_sum_4dir( longback4,
+	    (su3_vector *)gen_pt[X3DOWN][i] + k, (su3_vector *)gen_pt[Y3DOWN][i] + k,
+	    (su3_vector *)gen_pt[Z3DOWN][i] + k, (su3_vector *)gen_pt[T3DOWN][i] + k,
+	    &tvec );
+	sub_su3_vector(&(dest[k][i]), &tvec, &(dest[k][i]) );
+      }
+    }
+  } END_LOOP_OMP;
+#endif
 
+  cleanup_one_gather_set(tag);
 }
 
-/* We don't need temps, but d_congrad5_fn thinks we do.  Do nothing */
+/* Only dslash_fn_field_multi keeps temps */
 void cleanup_dslash_temps(){
+  if(multi_nrhs > 0){
+    free(multi_buf);
+    multi_buf = NULL;
+    multi_nrhs = 0;
+  }
 }
 
 /* Apply a Fat-Naik dslash-type shift in direction "dir", either
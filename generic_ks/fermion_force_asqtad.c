@@ -431,8 +431,7 @@ eo_fermion_force_twoterms_hwv( Real eps, Real weight1, Real weight2,
   
   /* Gather backward links */
   FORALLUPDIR(dir){
-    mtag[dir] = start_gather_site( F_OFFSET(link[dir]), sizeof(su3_matrix), 
-			      OPP_DIR(dir), EVENANDODD, gen_pt[dir] );
+    mtag[dir] = start_gather_link( dir, OPP_DIR(dir), EVENANDODD, gen_pt[dir] );
   }
   FORALLUPDIR(dir){
     wait_gather(mtag[dir]);
@@ -454,7 +453,7 @@ eo_fermion_force_twoterms_hwv( Real eps, Real weight1, Real weight2,
   }
   FORALLUPDIR(dir){
     FORALLSITES(i,s){
-      tempmom[dir][i] = s->mom[dir];
+      tempmom[dir][i] = SITE_MOM(i)[dir];
     }
   }
   
@@ -708,7 +707,7 @@ eo_fermion_force_twoterms_hwv( Real eps, Real weight1, Real weight2,
 
   FORALLUPDIR(dir){
     FORALLSITES(i,s){
-      s->mom[dir] = tempmom[dir][i];
+      SITE_MOM(i)[dir] = tempmom[dir][i];
     }
   }
 
@@ -972,8 +971,7 @@ fermion_force_asqtad_multi( Real eps, Real *residues,
   
   /* Gather backward links */
   FORALLUPDIR(dir){
-    mtag[dir] = start_gather_site( F_OFFSET(link[dir]), sizeof(su3_matrix), 
-			      OPP_DIR(dir), EVENANDODD, gen_pt[dir] );
+    mtag[dir] = start_gather_link( dir, OPP_DIR(dir), EVENANDODD, gen_pt[dir] );
   }
   FORALLUPDIR(dir){
     wait_gather(mtag[dir]);
@@ -995,7 +993,7 @@ fermion_force_asqtad_multi( Real eps, Real *residues,
   }
   FORALLUPDIR(dir){
     FORALLSITES(i,s){
-      tempmom[dir][i] = s->mom[dir];
+      tempmom[dir][i] = SITE_MOM(i)[dir];
     }
   }
   
@@ -1246,7 +1244,7 @@ fermion_force_asqtad_multi( Real eps, Real *residues,
 
   FORALLUPDIR(dir){
     FORALLSITES(i,s){
-      s->mom[dir] = tempmom[dir][i];
+      SITE_MOM(i)[dir] = tempmom[dir][i];
     }
   }
 
@@ -1303,7 +1301,7 @@ u_shift_fermion(su3_vector *src, su3_vector *dest, int dir ) {
 				    dir, EVENANDODD, gen_pt[0]);
       wait_gather(mtag);
       FORALLSITES(i,s)
-	mult_su3_mat_vec(&(s->link[dir]),(su3_vector *)(gen_pt[0][i]),
+	mult_su3_mat_vec(&(SITE_LINK(i)[dir]),(su3_vector *)(gen_pt[0][i]),
 			 &(dest[i]));
       cleanup_gather(mtag);
     }
@@ -1311,7 +1309,7 @@ u_shift_fermion(su3_vector *src, su3_vector *dest, int dir ) {
     {
       tmpvec = (su3_vector *)malloc( sites_on_node*sizeof(su3_vector) );
       FORALLSITES(i,s)
-	mult_adj_su3_mat_vec(&(s->link[OPP_DIR(dir)]),&(src[i]), &tmpvec[i]);
+	mult_adj_su3_mat_vec(&(SITE_LINK(i)[OPP_DIR(dir)]),&(src[i]), &tmpvec[i]);
       mtag = start_gather_field(tmpvec, sizeof(su3_vector), dir, 
 				    EVENANDODD, gen_pt[0]);
       wait_gather(mtag);
@@ -1358,7 +1356,7 @@ u_shift_hw_fermion(half_wilson_vector *src, half_wilson_vector *dest,
     {
 #if 0
       FORALLSITES(i,s)
-	mult_su3_mat_hwvec( &(s->link[dir]), 
+	mult_su3_mat_hwvec( &(SITE_LINK(i)[dir]), 
 			    (half_wilson_vector *)gen_pt[dir][i], 
 			    dest + i );
 #else
@@ -1408,10 +1406,10 @@ add_force_to_mom(su3_vector *back,su3_vector *forw, int dir,Real coeff) {
       tmp_coeff = -coeff ;
     else
       tmp_coeff = coeff ;
-    uncompress_anti_hermitian( &(s->mom[dir]), &tmat2 );
+    uncompress_anti_hermitian( &(SITE_MOM(i)[dir]), &tmat2 );
     su3_projector(&(back[i]), &(forw[i]), &tmat);
     scalar_mult_add_su3_matrix(&tmat2, &tmat,  tmp_coeff, &tmat2 );
-    make_anti_hermitian( &tmat2, &(s->mom[dir]) ); 
+    make_anti_hermitian( &tmat2, &(SITE_MOM(i)[dir]) ); 
   }
 }
 
@@ -1572,7 +1570,7 @@ u_shift_veclist_fermion(veclist *src, veclist *dest, int dir,
     {
 #if 0
       FORALLSITES(i,s)
-	mult_su3_mat_hwvec( &(s->link[dir]), 
+	mult_su3_mat_hwvec( &(SITE_LINK(i)[dir]), 
 			    (half_wilson_vector *)gen_pt[dir][i], 
 			    dest + i );
 #else
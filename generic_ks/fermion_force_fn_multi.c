@@ -217,14 +217,13 @@ fermion_force_fn_multi( Real eps, Real *residues,
       if( ilink==0 ){
         dir = this_path->dir[0];
           if( GOES_FORWARDS(dir) ){
-            mtag[1] = start_gather_site( F_OFFSET(link[dir]), sizeof(su3_matrix),
-                   OPP_DIR(dir), EVENANDODD, gen_pt[1] );
+            mtag[1] = start_gather_link( dir, OPP_DIR(dir), EVENANDODD, gen_pt[1] );
             wait_gather(mtag[1]);
             FORALLSITES(i,s){ su3_adjoint( (su3_matrix *)gen_pt[1][i], &(mats_along_path[1][i]) ); }
             cleanup_gather(mtag[1]);
           }
           else{
-            FORALLSITES(i,s){ mats_along_path[1][i] = s->link[OPP_DIR(dir)]; }
+            FORALLSITES(i,s){ mats_along_path[1][i] = SITE_LINK(i)[OPP_DIR(dir)]; }
           }
       }
       else { // ilink != 0
@@ -287,9 +286,9 @@ fermion_force_fn_multi( Real eps, Real *residues,
 
   // add force to momentum
   for(dir=XUP; dir<=TUP; dir++)FORALLSITES(i,s){
-     uncompress_anti_hermitian( &(s->mom[dir]), &tmat2 );
+     uncompress_anti_hermitian( &(SITE_MOM(i)[dir]), &tmat2 );
      add_su3_matrix( &tmat2, &(force_accum[dir][i]), &tmat2 );
-     make_anti_hermitian( &tmat2, &(s->mom[dir]) );
+     make_anti_hermitian( &tmat2, &(SITE_MOM(i)[dir]) );
   }
 //tempflops+=4*18;
 //tempflops+=4*18;
@@ -458,14 +457,13 @@ fermion_force_fn_multi_reverse( Real eps, Real *residues,
       if( ilink==0 ){
         dir = this_path->dir[0];
           if( GOES_FORWARDS(dir) ){
-            mtag = start_gather_site( F_OFFSET(link[dir]), sizeof(su3_matrix),
-                   OPP_DIR(dir), EVENANDODD, gen_pt[1] );
+            mtag = start_gather_link( dir, OPP_DIR(dir), EVENANDODD, gen_pt[1] );
             wait_gather(mtag);
             FORALLSITES(i,s){ su3_adjoint( (su3_matrix *)gen_pt[1][i], &(mats_along_path[1][i]) ); }
             cleanup_gather(mtag);
           }
           else{
-            FORALLSITES(i,s){ mats_along_path[1][i] = s->link[OPP_DIR(dir)]; }
+            FORALLSITES(i,s){ mats_along_path[1][i] = SITE_LINK(i)[OPP_DIR(dir)]; }
           }
       }
       else { // ilink != 0
@@ -528,9 +526,9 @@ fermion_force_fn_multi_reverse( Real eps, Real *residues,
 
   // add force to momentum
   for(dir=XUP; dir<=TUP; dir++)FORALLSITES(i,s){
-     uncompress_anti_hermitian( &(s->mom[dir]), &tmat2 );
+     uncompress_anti_hermitian( &(SITE_MOM(i)[dir]), &tmat2 );
      add_su3_matrix( &tmat2, &(force_accum[dir][i]), &tmat2 );
-     make_anti_hermitian( &tmat2, &(s->mom[dir]) );
+     make_anti_hermitian( &tmat2, &(SITE_MOM(i)[dir]) );
   }
 //tempflops+=4*18;
 //tempflops+=4*18;
@@ -652,26 +650,26 @@ fermion_force_fn_multi_june05( Real eps, Real *residues,
 	      /* Put antihermitian traceless part into momentum */
 	      if( ilink<length && GOES_FORWARDS(dir) ){
 	        FORALLSITES(i,s){
-	          uncompress_anti_hermitian( &(s->mom[dir]), &tmat2 );
+	          uncompress_anti_hermitian( &(SITE_MOM(i)[dir]), &tmat2 );
 		  if( s->parity==EVEN ){
 		    scalar_mult_add_su3_matrix(&tmat2, &(mat_tmp0[i]),  coeff, &tmat2 );
 		  }
 		  else{
 		    scalar_mult_add_su3_matrix(&tmat2, &(mat_tmp0[i]), -coeff, &tmat2 );
 		  }
-	          make_anti_hermitian( &tmat2, &(s->mom[dir]) );
+	          make_anti_hermitian( &tmat2, &(SITE_MOM(i)[dir]) );
 	        }
 	      }
 	      if( ilink>0 && GOES_BACKWARDS(lastdir) ){
 	        FORALLSITES(i,s){
-	          uncompress_anti_hermitian( &(s->mom[OPP_DIR(lastdir)]), &tmat2 );
+	          uncompress_anti_hermitian( &(SITE_MOM(i)[OPP_DIR(lastdir)]), &tmat2 );
 		  if( s->parity==EVEN ){
 		    scalar_mult_add_su3_matrix(&tmat2, &(mat_tmp0[i]), -coeff, &tmat2 );
 		  }
 		  else{
 		    scalar_mult_add_su3_matrix(&tmat2, &(mat_tmp0[i]),  coeff, &tmat2 );
 		  }
-	          make_anti_hermitian( &tmat2, &(s->mom[OPP_DIR(lastdir)]) );
+	          make_anti_hermitian( &tmat2, &(SITE_MOM(i)[OPP_DIR(lastdir)]) );
 	        }
 	      }
 
@@ -682,8 +680,8 @@ fermion_force_fn_multi_june05( Real eps, Real *residues,
 	
 		if( GOES_FORWARDS(dir) ){
 		  FORALLSITES(i,s){
-	            mult_su3_an( &(s->link[dir]), &(mat_tmp0[i]), &(tmat) );
-	            mult_su3_nn( &(tmat), &(s->link[dir]), &(mat_tmp1[i]) );
+	            mult_su3_an( &(SITE_LINK(i)[dir]), &(mat_tmp0[i]), &(tmat) );
+	            mult_su3_nn( &(tmat), &(SITE_LINK(i)[dir]), &(mat_tmp1[i]) );
 		  }
 		  mtag1 = start_gather_field( mat_tmp1, sizeof(su3_matrix),
 	             OPP_DIR(dir), EVENANDODD, gen_pt[1] );
@@ -698,8 +696,8 @@ fermion_force_fn_multi_june05( Real eps, Real *residues,
 	               OPP_DIR(dir), EVENANDODD, gen_pt[1] );
 	          wait_gather(mtag1);
 	          FORALLSITES(i,s){
-	            mult_su3_nn( &(s->link[OPP_DIR(dir)]), (su3_matrix *)(gen_pt[1][i]), &(tmat) );
-	            mult_su3_na( &(tmat), &(s->link[OPP_DIR(dir)]), &(mat_tmp1[i]) );
+	            mult_su3_nn( &(SITE_LINK(i)[OPP_DIR(dir)]), (su3_matrix *)(gen_pt[1][i]), &(tmat) );
+	            mult_su3_na( &(tmat), &(SITE_LINK(i)[OPP_DIR(dir)]), &(mat_tmp1[i]) );
 		  }
 		  tmp_matpt = mat_tmp0; mat_tmp0 = mat_tmp1; mat_tmp1 = tmp_matpt;
 	          cleanup_gather(mtag1);
@@ -141,7 +141,7 @@ dtime=-dclock();
       /* Put antihermitian traceless part into momentum */
       FORALLSITES(i,s){
         if( ilink<length && GOES_FORWARDS(dir) ){
-          uncompress_anti_hermitian( &(s->mom[dir]), &tmat2 );
+          uncompress_anti_hermitian( &(SITE_MOM(i)[dir]), &tmat2 );
 	  su3_projector( &(hw_tmp0[i].h[0]), &(hw_tmp0[i].h[1]), &tmat );
 	  if( s->parity==EVEN ){
 	    scalar_mult_add_su3_matrix(&tmat2, &tmat,  coeff, &tmat2 );
@@ -149,10 +149,10 @@ dtime=-dclock();
 	  else{
 	    scalar_mult_add_su3_matrix(&tmat2, &tmat, -coeff, &tmat2 );
 	  }
-          make_anti_hermitian( &tmat2, &(s->mom[dir]) );
+          make_anti_hermitian( &tmat2, &(SITE_MOM(i)[dir]) );
         }
 	if( ilink>0 && GOES_BACKWARDS(lastdir) ){
-          uncompress_anti_hermitian( &(s->mom[OPP_DIR(lastdir)]), &tmat2 );
+          uncompress_anti_hermitian( &(SITE_MOM(i)[OPP_DIR(lastdir)]), &tmat2 );
 	  su3_projector( &(hw_tmp0[i].h[0]), &(hw_tmp0[i].h[1]), &tmat );
 	  if( s->parity==EVEN ){
 	    scalar_mult_add_su3_matrix(&tmat2, &tmat, -coeff, &tmat2 );
@@ -160,7 +160,7 @@ dtime=-dclock();
 	  else{
 	    scalar_mult_add_su3_matrix(&tmat2, &tmat,  coeff, &tmat2 );
 	  }
-          make_anti_hermitian( &tmat2, &(s->mom[OPP_DIR(lastdir)]) );
+          make_anti_hermitian( &tmat2, &(SITE_MOM(i)[OPP_DIR(lastdir)]) );
         }
       }
       lastdir = dir;
@@ -296,22 +296,22 @@ if( x2_off-x1_off != sizeof(su3_vector) ){node0_printf("BOTCH\n"); exit(0);}
       FORALLSITES(i,s){
         if( ilink<length && GOES_FORWARDS(dir) ){
 	  if( s->parity==ODD ){coeff1 *= -1.0; coeff2 *= -1.0; }
-          uncompress_anti_hermitian( &(s->mom[dir]), &tmat2 );
+          uncompress_anti_hermitian( &(SITE_MOM(i)[dir]), &tmat2 );
 	  su3_projector( &(w_tmp0[i].d[0]), &(w_tmp0[i].d[2]), &tmat );
 	  scalar_mult_add_su3_matrix( &tmat2, &tmat,  coeff1, &tmat2 );
 	  su3_projector( &(w_tmp0[i].d[1]), &(w_tmp0[i].d[3]), &tmat );
 	  scalar_mult_add_su3_matrix( &tmat2, &tmat,  coeff2, &tmat2 );
-          make_anti_hermitian( &tmat2, &(s->mom[dir]) );
+          make_anti_hermitian( &tmat2, &(SITE_MOM(i)[dir]) );
 	  if( s->parity==ODD ){coeff1 *= -1.0; coeff2 *= -1.0; }
         }
 	if( ilink>0 && GOES_BACKWARDS(lastdir) ){
 	  if( s->parity==EVEN ){coeff1 *= -1.0; coeff2 *= -1.0; }
-          uncompress_anti_hermitian( &(s->mom[OPP_DIR(lastdir)]), &tmat2 );
+          uncompress_anti_hermitian( &(SITE_MOM(i)[OPP_DIR(lastdir)]), &tmat2 );
 	  su3_projector( &(w_tmp0[i].d[0]), &(w_tmp0[i].d[2]), &tmat );
 	  scalar_mult_add_su3_matrix( &tmat2, &tmat,  coeff1, &tmat2 );
 	  su3_projector( &(w_tmp0[i].d[1]), &(w_tmp0[i].d[3]), &tmat );
 	  scalar_mult_add_su3_matrix( &tmat2, &tmat,  coeff2, &tmat2 );
-          make_anti_hermitian( &tmat2, &(s->mom[OPP_DIR(lastdir)]) );
+          make_anti_hermitian( &tmat2, &(SITE_MOM(i)[OPP_DIR(lastdir)]) );
 	  if( s->parity==EVEN ){coeff1 *= -1.0; coeff2 *= -1.0; }
         }
       }
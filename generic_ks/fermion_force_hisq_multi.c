@@ -70,8 +70,8 @@ BOMB THE COMPILE
 #define special_alloc qcdoc_alloc
 #define special_free qfree
 #else
-#define special_alloc malloc
-#define special_free free
+#define special_alloc field_alloc
+#define special_free field_free
 #endif
 
 
@@ -167,11 +167,19 @@ fn_fermion_force_multi_hisq_wrapper_mx_gpu( info_t *info, Real eps, Real *residu
 static const char *qop_prec[2] = {"F", "D"};
 #endif
 
+/* Flops on this node in the last call, for benchmarks */
+static double last_final_flop = 0.;
+
+double eo_fermion_force_multi_flops( void ){
+  return last_final_flop;
+}
+
 void eo_fermion_force_multi( Real eps, Real *residues, su3_vector **xxx, 
 			     int nterms, int prec, fermion_links_t *fl) {
   double dtime = -dclock();
   info_t info = INFO_ZERO;
 
+  PERF_BEGIN("fermion_force");
   if(prec != MILC_PRECISION){
     node0_printf("eo_fermion_force_multi: WARNING, precision requests not supported. Using %d.\n",
 		 MILC_PRECISION);
@@ -193,6 +201,8 @@ void eo_fermion_force_multi( Real eps, Real *residues, su3_vector **xxx,
 
   dtime += dclock();
   info.final_sec = dtime;
+  last_final_flop = info.final_flop;
+  PERF_END("fermion_force", info.final_flop, 0);
 #ifdef FFTIME
 #ifdef USE_FF_GPU
   node0_printf("FFTIME:  time = %e (HISQ QUDA %s) terms = %d flops/site = %d mflops = %e\n",
@@ -446,15 +456,15 @@ fn_fermion_force_multi_hisq_mx( info_t *info, Real eps, Real *residues,
   if( nterms==0 )return;
 
   for(i=0;i<=MAX_PATH_LENGTH;i++){
-     oprod_along_path[i] = (su3_matrix *) malloc(sites_on_node*sizeof(su3_matrix) );
+     oprod_along_path[i] = (su3_matrix *) special_alloc(sites_on_node*sizeof(su3_matrix) );
   }
   for(i=1;i<=MAX_PATH_LENGTH;i++){ // 0 element is never used (it's unit matrix)
-     mats_along_path[i] = (su3_matrix *) malloc(sites_on_node*sizeof(su3_matrix) );
+     mats_along_path[i] = (su3_matrix *) special_alloc(sites_on_node*sizeof(su3_matrix) );
   }
   for(i=XUP;i<=TUP;i++){
-     force_accum_1[i] = (su3_matrix *) malloc(sites_on_node*sizeof(su3_matrix) );
-     force_accum_2[i] = (su3_matrix *) malloc(sites_on_node*sizeof(su3_matrix) );
-     force_accum_tmp[i] = (su3_matrix *) malloc(sites_on_node*sizeof(su3_matrix) );
+     force_accum_1[i] = (su3_matrix *) special_alloc(sites_on_node*sizeof(su3_matrix) );
+     force_accum_2[i] = (su3_matrix *) special_alloc(sites_on_node*sizeof(su3_matrix) );
+     force_accum_tmp[i] = (su3_matrix *) special_alloc(sites_on_node*sizeof(su3_matrix) );
   }
   mat_tmp0 = (su3_matrix *) special_alloc(sites_on_node*sizeof(su3_matrix) );
   mat_tmp1 = (su3_matrix *) special_alloc(sites_on_node*sizeof(su3_matrix) );
@@ -1134,26 +1144,26 @@ if(this_path->forwback== -1)continue;	// CHECK THIS!!!!
   /* Put antihermitian traceless part into momentum */
   // add force to momentum
   for(dir=XUP; dir<=TUP; dir++)FORALLSITES_OMP(i,s,private(tmat2) ){
-     uncompress_anti_hermitian( &(s->mom[dir]), &tmat2 );
+     uncompress_anti_hermitian( &(SITE_MOM(i)[dir]), &tmat2 );
      add_su3_matrix( &tmat2, &(force_accum_1[dir][i]), &tmat2 );
-     make_anti_hermitian( &tmat2, &(s->mom[dir]) );
+     make_anti_hermitian( &tmat2, &(SITE_MOM(i)[dir]) );
   } END_LOOP_OMP
   nflops += 144;
 //tempflops+=4*18;
 //tempflops+=4*18;
 	
-  free( mat_tmp0 );
-  free( mat_tmp1 );
+  special_free( mat_tmp0 );
+  special_free( mat_tmp1 );
   for(i=0;i<=MAX_PATH_LENGTH;i++){
-     free( oprod_along_path[i] );
+     special_free( oprod_along_path[i] );
   }
   for(i=1;i<=MAX_PATH_LENGTH;i++){
-     free( mats_along_path[i] );
+     special_free( mats_along_path[i] );
   }
   for(i=XUP;i<=TUP;i++){
-     free( force_accum_1[i] );
-     free( force_accum_2[i] );
-     free( force_accum_tmp[i] );
+     special_free( force_accum_1[i] );
+     special_free( force_accum_2[i] );
+     special_free( force_accum_tmp[i] );
   }
 
   info->final_flop = ((double)nflops)*volume/numnodes();
@@ -1258,17 +1268,17 @@ fn_fermion_force_multi_hisq_wrapper_mx_cpu( info_t *info, Real eps, Real *residu
 
   for(i=XUP;i<=TUP;i++){
      force_accum_0[i] = 
-       (su3_matrix *) malloc(sites_on_node*sizeof(su3_matrix) );
+       (su3_matrix *) special_alloc(sites_on_node*sizeof(su3_matrix) );
      force_accum_0_naik[i] = 
-       (su3_matrix *) malloc(sites_on_node*sizeof(su3_matrix) );
+       (su3_matrix *) special_alloc(sites_on_node*sizeof(su3_matrix) );
      force_accum_1[i] = 
-       (su3_matrix *) malloc(sites_on_node*sizeof(su3_matrix) );
+       (su3_matrix *) special_alloc(sites_on_node*sizeof(su3_matrix) );
      force_accum_1u[i] = 
-       (su3_matrix *) malloc(sites_on_node*sizeof(su3_matrix) );
+       (su3_matrix *) special_alloc(sites_on_node*sizeof(su3_matrix) );
      force_accum_2[i] = 
-       (su3_matrix *) malloc(sites_on_node*sizeof(su3_matrix) );
+       (su3_matrix *) special_alloc(sites_on_node*sizeof(su3_matrix) );
      force_final[i] = 
-       (su3_matrix *) malloc(sites_on_node*sizeof(su3_matrix) );
+       (su3_matrix *) special_alloc(sites_on_node*sizeof(su3_matrix) );
   }
   ahmat_tmp = 
     (anti_hermitmat *) special_alloc(sites_on_node*sizeof(anti_hermitmat) );
@@ -1411,7 +1421,7 @@ fn_fermion_force_multi_hisq_wrapper_mx_cpu( info_t *info, Real eps, Real *residu
   // after contributions from all levels of smearing are taken into account
   for(dir=XUP;dir<=TUP;dir++){
     FORALLSITES_OMP(i,s,  ){
-      mult_su3_nn( &( s->link[dir] ), &( force_accum_1[dir][i] ), 
+      mult_su3_nn( &( SITE_LINK(i)[dir] ), &( force_accum_1[dir][i] ), 
 		   &( force_final[dir][i] ) );
     } END_LOOP_OMP
     nflops += 198;
@@ -1449,23 +1459,23 @@ fn_fermion_force_multi_hisq_wrapper_mx_cpu( info_t *info, Real eps, Real *residu
   /* Put antihermitian traceless part into momentum */
   // add force to momentum
   for(dir=XUP; dir<=TUP; dir++)FORALLSITES_OMP(i,s,private(tmat2)){
-     uncompress_anti_hermitian( &(s->mom[dir]), &tmat2 );
+     uncompress_anti_hermitian( &(SITE_MOM(i)[dir]), &tmat2 );
      add_su3_matrix( &tmat2, &(force_final[dir][i]), &tmat2 );
-     make_anti_hermitian( &tmat2, &(s->mom[dir]) );
+     make_anti_hermitian( &tmat2, &(SITE_MOM(i)[dir]) );
   } END_LOOP_OMP
 
   nflops += 18;
 
 
   for(i=XUP;i<=TUP;i++){
-     free( force_accum_0[i] );
-     free( force_accum_0_naik[i] );
-     free( force_accum_1[i] );
-     free( force_accum_1u[i] );
-     free( force_accum_2[i] );
-     free( force_final[i] );
+     special_free( force_accum_0[i] );
+     special_free( force_accum_0_naik[i] );
+     special_free( force_accum_1[i] );
+     special_free( force_accum_1u[i] );
+     special_free( force_accum_2[i] );
+     special_free( force_final[i] );
   }
-  free(ahmat_tmp);
+  special_free(ahmat_tmp);
 
   dtime += dclock();
   info->final_sec = dtime;
@@ -1527,7 +1537,7 @@ fn_fermion_force_multi_hisq_smearing0( info_t *info, Real eps, Real *residues,
 
   for(i=0;i<=MAX_PATH_LENGTH;i++){
      oprod_along_path[i] = 
-       (su3_matrix *) malloc(sites_on_node*sizeof(su3_matrix) );
+       (su3_matrix *) special_alloc(sites_on_node*sizeof(su3_matrix) );
   }
   mat_tmp0 = (su3_matrix *) special_alloc(sites_on_node*sizeof(su3_matrix) );
   if( mat_tmp0 == NULL ){printf("Node %d NO ROOM\n",this_node); exit(0); }
@@ -1622,9 +1632,9 @@ fn_fermion_force_multi_hisq_smearing0( info_t *info, Real eps, Real *residues,
   } /* end of loop on directions */
 
 
-  free( mat_tmp0 );
+  special_free( mat_tmp0 );
   for(i=0;i<=MAX_PATH_LENGTH;i++){
-     free( oprod_along_path[i] );
+     special_free( oprod_along_path[i] );
   }
 
   info->final_flop = ((double)nflops)*volume/numnodes();
@@ -1669,11 +1679,11 @@ fn_fermion_force_multi_hisq_smearing( info_t *info,
   if( nterms==0 )return;
 
   for(i=0;i<=MAX_PATH_LENGTH;i++){
-     oprod_along_path[i] = (su3_matrix *) malloc(sites_on_node*sizeof(su3_matrix) );
+     oprod_along_path[i] = (su3_matrix *) special_alloc(sites_on_node*sizeof(su3_matrix) );
   }
   for(i=1;i<=MAX_PATH_LENGTH;i++){ // 0 element is never used (it's unit matrix)
      mats_along_path[i] = 
-       (su3_matrix *) malloc(sites_on_node*sizeof(su3_matrix) );
+       (su3_matrix *) special_alloc(sites_on_node*sizeof(su3_matrix) );
   }
 
   mat_tmp0 = (su3_matrix *) special_alloc(sites_on_node*sizeof(su3_matrix) );
@@ -1857,14 +1867,14 @@ fn_fermion_force_multi_hisq_smearing( info_t *info,
     } /* end loop over links in path */
   } /* end loop over paths */
 
-  free( mat_tmp0 );
-  free( mat_tmp1 );
-  free( ahmat_tmp );
+  special_free( mat_tmp0 );
+  special_free( mat_tmp1 );
+  special_free( ahmat_tmp );
   for(i=0;i<=MAX_PATH_LENGTH;i++){
-     free( oprod_along_path[i] );
+     special_free( oprod_along_path[i] );
   }
   for(i=1;i<=MAX_PATH_LENGTH;i++){
-     free( mats_along_path[i] );
+     special_free( mats_along_path[i] );
   }
 
   info->final_flop = ((double)nflops)*volume/numnodes();
@@ -2056,7 +2066,7 @@ static void outer_product_append( Real one_hop_coeff, Real three_hop_coeff,
   
   for(i=0;i<=MAX_PATH_LENGTH;i++){
     oprod_along_path[i] = 
-      (su3_matrix *) malloc(sites_on_node*sizeof(su3_matrix) );
+      (su3_matrix *) special_alloc(sites_on_node*sizeof(su3_matrix) );
   }
   mat_tmp0 = (su3_matrix *) special_alloc(sites_on_node*sizeof(su3_matrix) );
   if( mat_tmp0 == NULL ){printf("Node %d NO ROOM\n",this_node); exit(0); }
@@ -2145,9 +2155,9 @@ static void outer_product_append( Real one_hop_coeff, Real three_hop_coeff,
   } /* end of loop on directions */
   
   
-  free( mat_tmp0 );
+  special_free( mat_tmp0 );
   for(i=0;i<=MAX_PATH_LENGTH;i++){
-    free( oprod_along_path[i] );
+    special_free( oprod_along_path[i] );
   }
   return;
 } // outer_product_append
@@ -2271,7 +2281,7 @@ fn_fermion_force_multi_hisq_wrapper_mx_gpu(info_t* info, Real eps, Real *residue
   FORALLSITES_OMP(i,s,){
     for(int dir=0; dir<4; ++dir){
       for(int j=0; j<10; ++j){
-	*((Real*)(&(s->mom[dir])) + j) += *(momentum + (4*i+ dir)*10 + j);
+	*((Real*)(&(SITE_MOM(i)[dir])) + j) += *(momentum + (4*i+ dir)*10 + j);
       }
     }
   } END_LOOP_OMP
@@ -2424,7 +2434,7 @@ void u_shift_veclist_fermion(veclist *src, veclist *dest,
     {
 #if 0
       FORALLSITES(i,s)
-	mult_su3_mat_hwvec( &(s->link[dir]), 
+	mult_su3_mat_hwvec( &(SITE_LINK(i)[dir]), 
 			    (half_wilson_vector *)gen_pt[dir][i], 
 			    dest + i );
 #else
@@ -1052,9 +1052,9 @@ if(this_path->forwback== -1)continue;	// CHECK THIS!!!!
   /* Put antihermitian traceless part into momentum */
   // add force to momentum
   for(dir=XUP; dir<=TUP; dir++)FORALLSITES(i,s){
-     uncompress_anti_hermitian( &(s->mom[dir]), &tmat2 );
+     uncompress_anti_hermitian( &(SITE_MOM(i)[dir]), &tmat2 );
      add_su3_matrix( &tmat2, &(force_accum_1[dir][i]), &tmat2 );
-     make_anti_hermitian( &tmat2, &(s->mom[dir]) );
+     make_anti_hermitian( &tmat2, &(SITE_MOM(i)[dir]) );
   }
   nflops += 144;
 //tempflops+=4*18;
@@ -1367,9 +1367,9 @@ fn_fermion_force_multi_hypisq_wrapper_mx_cpu( info_t *info, Real eps, Real *resi
   /* Put antihermitian traceless part into momentum */
   // add force to momentum
   for(dir=XUP; dir<=TUP; dir++)FORALLSITES(i,s){
-     uncompress_anti_hermitian( &(s->mom[dir]), &tmat2 );
+     uncompress_anti_hermitian( &(SITE_MOM(i)[dir]), &tmat2 );
      add_su3_matrix( &tmat2, &(force_final[dir][i]), &tmat2 );
-     make_anti_hermitian( &tmat2, &(s->mom[dir]) );
+     make_anti_hermitian( &tmat2, &(SITE_MOM(i)[dir]) );
   }
 
   nflops += 18;
@@ -2208,7 +2208,7 @@ fn_fermion_force_multi_hypisq_wrapper_mx_gpu(info_t* info, Real eps, Real *resid
   FORALLSITES(i,s){
     for(dir=0; dir<4; ++dir){
       for(j=0; j<10; ++j){
-	*((Real*)(&(s->mom[dir])) + j) += *(momentum + (4*i+ dir)*10 + j);
+	*((Real*)(&(SITE_MOM(i)[dir])) + j) += *(momentum + (4*i+ dir)*10 + j);
       }
     }
   }
@@ -356,6 +356,9 @@ boundary_twist_fn(fn_links_t *fn, int flag) {
     terminate(1);
   }
 
+  /* The links change below.  Derived copies are rebuilt on next use */
+  invalidate_fn_link_copies(fn);
+
   /* Shift the KS phases and antiperiodic BC, depending on the offset */
 
   if(*status_now == OFF){
@@ -26,8 +26,8 @@
 #define special_alloc qudaAllocatePinned
 #define special_free qudaFreePinned
 #else
-#define special_alloc malloc
-#define special_free free
+#define special_alloc(bytes) field_alloc_tag(bytes, MEM_LINKS)
+#define special_free field_free
 #endif
 
 /*-------------------------------------------------------------------*/
@@ -775,9 +775,12 @@ create_hisq_links_milc(info_t *info, fn_links_t **fn, fn_links_t **fn_deps,
   double final_flop = 0.;
   double dtime = -dclock();
 
+  PERF_BEGIN("hisq_links");
   *aux = create_hisq_auxiliary_t(ap, links);
   
+  PERF_BEGIN("hisq_aux_links");
   load_hisq_aux_links(info, ap, *aux, links);
+  PERF_END("hisq_aux_links", info->final_flop, 0);
   final_flop += info->final_flop;
   
   for(i = 0; i < n_naiks; i++)
@@ -788,13 +791,112 @@ create_hisq_links_milc(info_t *info, fn_links_t **fn, fn_links_t **fn_deps,
   else
     *fn_deps = NULL;
 
+  PERF_BEGIN("hisq_fn_links");
   load_hisq_fn_links(info, fn, *fn_deps, *aux, ap, links, 
 		     want_deps, want_back);
+  PERF_END("hisq_fn_links", info->final_flop, 0);
   final_flop += info->final_flop;
 
   dtime += dclock();
   info->final_sec = dtime;
   info->final_flop = final_flop;
+  PERF_END("hisq_links", final_flop, 0);
+}
+
+/*-------------------------------------------------------------------*/
+/* Rebuild stale HISQ links level by level                           */
+/*-------------------------------------------------------------------*/
+
+/* 1 if the links differ from U anywhere on the lattice */
+static int
+links_differ(su3_matrix *U_link, su3_matrix *links){
+  int i;
+  double ndiff = 0.;
+
+  FORALLFIELDSITES_OMP(i,reduction(+:ndiff)){
+    if(memcmp(U_link + 4*i, links + 4*i, 4*sizeof(su3_matrix)) != 0)
+      ndiff += 1.;
+  } END_LOOP_OMP;
+  g_doublesum(&ndiff);
+  return ndiff > 0.;
+}
+
+/* For links built by create_hisq_links_milc with the auxiliary links
+   kept.  The gauge version advances only if the links differ from the
+   U links of the last build.  Each level is then rebuilt only if the
+   level it is made from was: V from U, Y and W from V, and the fn
+   links for all Naik epsilons, with fn_deps, from W.  With FLTIME
+   each call reports what was rebuilt and what reused. */
+
+void
+refresh_hisq_links_milc(info_t *info, hisq_links_t *hl, su3_matrix *links,
+			int want_deps, int want_back){
+  hisq_auxiliary_t *aux = hl->aux;
+  ks_action_paths_hisq *ap = hl->ap;
+  int i, u_new, v_new = 0, w_new = 0, x_new = 0;
+  double final_flop = 0.;
+  double dtime = -dclock();
+
+  u_new = links_differ(aux->U_link, links);
+  if(u_new){
+    load_U_from_field(info, aux, links);
+    hl->gauge_version++;
+  }
+
+  if(hl->V_version != hl->gauge_version || hl->W_version != hl->V_version){
+    PERF_BEGIN("hisq_aux_links");
+#ifdef USE_FL_GPU
+    /* The GPU makes V, Y and W together */
+    load_hisq_aux_links(info, ap, aux, links);
+    final_flop += info->final_flop;
+    v_new = w_new = 1;
+#else
+    if(hl->V_version != hl->gauge_version){
+      load_V_from_U(info, aux, &ap->p1);
+      final_flop += info->final_flop;
+      v_new = 1;
+    }
+    load_Y_from_V(info, aux, ap->umethod);
+    final_flop += info->final_flop;
+    load_W_from_Y(info, aux, ap->umethod, ap->ugroup);
+    final_flop += info->final_flop;
+    w_new = 1;
+#endif
+    hl->V_version = hl->gauge_version;
+    hl->W_version = hl->V_version;
+    PERF_END("hisq_aux_links", final_flop, 0);
+  }
+
+  if(hl->X_version != hl->W_version){
+    PERF_BEGIN("hisq_fn_links");
+    load_hisq_fn_links(info, hl->fn, hl->fn_deps, aux, ap, links,
+		       want_deps, want_back);
+    PERF_END("hisq_fn_links", info->final_flop, 0);
+    final_flop += info->final_flop;
+    /* Copies in other layouts and precisions are out of date */
+    for(i = 0; i < ap->n_naiks; i++){
+      invalidate_fn_link_copies(hl->fn[i]);
+      hl->fn[i]->notify_quda_new_links = 1;
+    }
+    if(hl->fn_deps != NULL){
+      invalidate_fn_link_copies(hl->fn_deps);
+      hl->fn_deps->notify_quda_new_links = 1;
+    }
+    hl->X_version = hl->W_version;
+    x_new = 1;
+  }
+  hl->stale = 0;
+
+  dtime += dclock();
+  info->final_sec = dtime;
+  info->final_flop = final_flop;
+
+#ifdef FLTIME
+  node0_printf("FLCACHE: gauge version %d U %s V %s W %s X %s\n",
+	       hl->gauge_version, u_new ? "changed" : "same",
+	       v_new ? "rebuilt" : "reused", w_new ? "rebuilt" : "reused",
+	       x_new ? "rebuilt" : "reused");
+#endif
 }
 
 void
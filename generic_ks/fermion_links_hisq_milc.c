@@ -39,6 +39,8 @@ create_hisq_links_t(info_t *info, ks_action_paths_hisq *ap, su3_matrix *links,
 
   create_hisq_links_milc(info, hl->fn, &hl->fn_deps, &hl->aux, ap, links, 
 			 options->want_deps, options->want_back);
+  hl->stale = 0;
+  hl->gauge_version = hl->V_version = hl->W_version = hl->X_version = 0;
 
   /* Free the space if so desired */
   if(!options->want_aux){
@@ -63,11 +65,21 @@ destroy_hisq_links_t(hisq_links_t *hl){
 }
 
 
+/* With the auxiliary links we only mark the links stale.  On restore
+   they are compared with the gauge links and rebuilt only as far as
+   needed (refresh_hisq_links_milc).  The precision is not part of the
+   test, since only MILC_PRECISION is ever built here. */
+
 static void
 invalidate_hisq_links_t(hisq_links_t *hl){
   if(hl == NULL)return;
 
-  /* Destroy the auxiliary and fn links and reset the pointers */
+  if(hl->aux != NULL && hl->fn[0] != NULL){
+    hl->stale = 1;
+    return;
+  }
+
+  /* Otherwise destroy the auxiliary and fn links and reset the pointers */
   /* Keep the path tables */
 
   destroy_hisq_links_milc(hl->ap, hl->aux, hl->fn, hl->fn_deps);
@@ -81,16 +93,23 @@ restore_hisq_links_t(info_t *info, hisq_links_t *hl, su3_matrix *links,
 
   if(hl == NULL)return;
 
-  /* If the first fn member is not NULL, the links are assumed to be
-     valid and we do nothing */
+  /* If the first fn member is not NULL, the links are valid or only
+     stale */
 
-  if(hl->fn[0] != NULL)return;
+  if(hl->fn[0] != NULL){
+    if(hl->stale)
+      refresh_hisq_links_milc(info, hl, links, options->want_deps,
+			      options->want_back);
+    return;
+  }
 
   /* Allocate and create the HISQ auxiliary links and the fn links */
 
   create_hisq_links_milc(info, hl->fn, &hl->fn_deps, &hl->aux, 
 			 hl->ap, links, options->want_deps,
 			 options->want_back);
+  hl->stale = 0;
+  hl->V_version = hl->W_version = hl->X_version = hl->gauge_version;
 
   /* Free the space if so desired */
   if(!options->want_aux){
@@ -120,7 +139,7 @@ get_hisq_links_t_ap(hisq_links_t *hl){
 /* We keep only one precision for MILC types */
 static int
 valid_hisq_links_t(hisq_links_t *hl, int precision){
-  return hl->fn[0] != NULL;
+  return hl->fn[0] != NULL && !hl->stale;
 }
 
 static hisq_auxiliary_t *
@@ -154,12 +154,11 @@ void mult_su3_sitelink_lathwvec( int dir,
       i < sites_on_node; 
       i++, s++, b++, c++)
     {
-      a = &(s->link[dir]);
+      a = &(SITE_LINK(i)[dir]);
 
 #ifdef CACHE_TOUCH
       if(i < sites_on_node - 1){
-	site *sn = s + 1;
-	su3_matrix *an = &(sn->link[dir]);
+	su3_matrix *an = &(SITE_LINK(i+1)[dir]);
 	half_wilson_vector **bn = b + 1;
 
 	cache_touch(&(an->e[0][0].real));
@@ -209,8 +208,7 @@ void mult_su3_sitelink_lathwvec( int dir,
       
 #ifdef CACHE_TOUCH
       if(i < sites_on_node - 1){
-	site *sn = s + 1;
-	su3_matrix *an = &(sn->link[dir]);
+	su3_matrix *an = &(SITE_LINK(i+1)[dir]);
 	half_wilson_vector **bn = b + 1;
 
 	cache_touch(&((*bn)->h[0].c[0].real));
@@ -1008,12 +1006,11 @@ void mult_su3_sitelink_latveclist( int dir,
 
   for(i = 0, s = lattice, b = src_pt, c = dest; 
       i < sites_on_node; i++, s++, b++, c++) {
-          a = &(s->link[dir]);
+          a = &(SITE_LINK(i)[dir]);
     
 #ifdef CACHE_TOUCH
       if(i < sites_on_node - 1){
-	    site *sn = s + 1;
-	    su3_matrix *an = &(sn->link[dir]);
+	    su3_matrix *an = &(SITE_LINK(i+1)[dir]);
 	    veclist **bn = b + 1;
     
 	    cache_touch(&(an->e[0][0].real));
@@ -1064,8 +1061,7 @@ void mult_su3_sitelink_latveclist( int dir,
           
 #ifdef CACHE_TOUCH
           if(i < sites_on_node - 1){
-		site *sn = s + 1;
-		su3_matrix *an = &(sn->link[dir]);
+		su3_matrix *an = &(SITE_LINK(i+1)[dir]);
 		veclist **bn = b + 1;
 		cache_touch(&((*bn)->v[j].c[0].real));
           }
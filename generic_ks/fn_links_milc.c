@@ -15,8 +15,8 @@
 #define special_alloc qudaAllocatePinned
 #define special_free qudaFreePinned
 #else
-#define special_alloc malloc
-#define special_free free
+#define special_alloc(bytes) field_alloc_tag(bytes, MEM_LINKS)
+#define special_free field_free
 #endif
 
 /*-------------------------------------------------------------------*/
@@ -34,7 +34,7 @@ create_G_special(void){
     terminate(1);
   }
 
-  memset(m, '\0', sites_on_node*4*sizeof(su3_matrix));
+  clear_m_array_field(m, 4);  /* first touch with OpenMP */
   return m;
 }
 
@@ -205,6 +205,275 @@ destroy_fatbacklinks(su3_matrix *fatback){
   destroy_G_special(fatback);
 }
 
+#ifdef D_FN_SOA
+/*-------------------------------------------------------------------*/
+/* SIMD (structure of arrays) copies of the links                    */
+/*-------------------------------------------------------------------*/
+
+/* Sites are taken in blocks of SOA_VLEN.  Even sites fill the first
+   SOA_NBLOCKS(even_sites_on_node) blocks and odd sites the rest, so a
+   block never mixes parities */
+
+int
+soa_first_block(int parity){
+  return parity == ODD ? SOA_NBLOCKS(even_sites_on_node) : 0;
+}
+
+int
+soa_end_block(int parity){
+  int nbe = SOA_NBLOCKS(even_sites_on_node);
+  if(parity == EVEN)return nbe;
+  return nbe + SOA_NBLOCKS(sites_on_node - even_sites_on_node);
+}
+
+/* First site and number of live lanes in block b */
+void
+soa_block_sites(int b, int *i0, int *n){
+  int nbe = SOA_NBLOCKS(even_sites_on_node);
+  int iend;
+
+  if(b < nbe){
+    *i0 = b*SOA_VLEN;
+    iend = even_sites_on_node;
+  } else {
+    *i0 = even_sites_on_node + (b - nbe)*SOA_VLEN;
+    iend = sites_on_node;
+  }
+  *n = (iend - *i0 < SOA_VLEN) ? iend - *i0 : SOA_VLEN;
+}
+
+/* Aligned allocation.  The malloc'ed pointer is kept just below the
+   aligned block */
+static void *
+soa_alloc(size_t bytes){
+  char *raw, *p;
+
+  raw = (char *)field_alloc_tag(bytes + SOA_VBYTES + sizeof(void *), MEM_LINKS);
+  if(raw == NULL)return NULL;
+  p = raw + sizeof(void *);
+  p += (SOA_VBYTES - ((size_t)p % SOA_VBYTES)) % SOA_VBYTES;
+  ((void **)p)[-1] = raw;
+  return p;
+}
+
+static void
+soa_free(void *p){
+  if(p == NULL)return;
+  field_free(((void **)p)[-1]);
+}
+
+/* Convert a field with 4*su3_matrix per site */
+static su3_matrix_soa *
+create_G_soa(su3_matrix *G){
+  char myname[] = "create_G_soa";
+  su3_matrix_soa *m;
+  int b, nb = soa_end_block(EVENANDODD);
+
+  if(G == NULL)return NULL;
+
+  m = (su3_matrix_soa *)soa_alloc(nb*4*sizeof(su3_matrix_soa));
+  if(m == NULL){
+    printf("%s: no room\n",myname);
+    terminate(1);
+  }
+
+#ifdef OMP
+#pragma omp parallel for
+#endif
+  for(b = 0; b < nb; b++){
+    int i0, n, l, dir, i, j;
+    soa_block_sites(b, &i0, &n);
+    memset(m + 4*b, '\0', 4*sizeof(su3_matrix_soa));
+    for(dir = XUP; dir <= TUP; dir++)
+      for(l = 0; l < n; l++)
+	for(i = 0; i < 3; i++)for(j = 0; j < 3; j++){
+	  m[4*b+dir].re[i][j][l] = G[4*(i0+l)+dir].e[i][j].real;
+	  m[4*b+dir].im[i][j][l] = G[4*(i0+l)+dir].e[i][j].imag;
+	}
+  }
+
+  return m;
+}
+
+static void
+invalidate_fn_soa_links(fn_links_t *fn){
+  if(fn == NULL)return;
+  soa_free(fn->fat_soa);
+  soa_free(fn->lng_soa);
+  soa_free(fn->fatback_soa);
+  soa_free(fn->lngback_soa);
+  fn->fat_soa = NULL;
+  fn->lng_soa = NULL;
+  fn->fatback_soa = NULL;
+  fn->lngback_soa = NULL;
+}
+
+/* Build the SIMD copies from the current fat, lng, and back links */
+void
+load_fn_soa_links(fn_links_t *fn){
+  if(fn == NULL)return;
+
+  invalidate_fn_soa_links(fn);
+  fn->fat_soa = create_G_soa(fn->fat);
+  fn->lng_soa = create_G_soa(fn->lng);
+  fn->fatback_soa = create_G_soa(fn->fatback);
+  fn->lngback_soa = create_G_soa(fn->lngback);
+}
+#endif
+
+#ifdef KS_CG_MIXED
+/*-------------------------------------------------------------------*/
+/* Single precision copies of the links for the mixed-precision CG  */
+/*-------------------------------------------------------------------*/
+
+/* Convert a field with 4*su3_matrix per site */
+static fsu3_matrix *
+create_G_F(su3_matrix *G){
+  char myname[] = "create_G_F";
+  fsu3_matrix *m;
+  int i, dir, j, k;
+
+  if(G == NULL)return NULL;
+
+  m = (fsu3_matrix *)field_alloc_tag(sites_on_node*4*sizeof(fsu3_matrix), MEM_LINKS);
+  if(m == NULL){
+    printf("%s: no room\n",myname);
+    terminate(1);
+  }
+
+  FORALLFIELDSITES_OMP(i,private(dir,j,k)){
+    for(dir = XUP; dir <= TUP; dir++)
+      for(j = 0; j < 3; j++)for(k = 0; k < 3; k++){
+	m[4*i+dir].e[j][k].real = G[4*i+dir].e[j][k].real;
+	m[4*i+dir].e[j][k].imag = G[4*i+dir].e[j][k].imag;
+      }
+  } END_LOOP_OMP;
+
+  return m;
+}
+
+static void
+invalidate_fn_F_links(fn_links_t *fn){
+  if(fn == NULL)return;
+  field_free(fn->fat_F);
+  field_free(fn->lng_F);
+  field_free(fn->fatback_F);
+  field_free(fn->lngback_F);
+  fn->fat_F = NULL;
+  fn->lng_F = NULL;
+  fn->fatback_F = NULL;
+  fn->lngback_F = NULL;
+}
+
+/* Build the single precision copies.  The single precision dslash
+   always uses back links, so they are made here if the double
+   precision ones are not kept. */
+void
+load_fn_F_links(fn_links_t *fn){
+  su3_matrix *fatback, *lngback;
+
+  if(fn == NULL)return;
+
+  invalidate_fn_F_links(fn);
+  fn->fat_F = create_G_F(fn->fat);
+  fn->lng_F = create_G_F(fn->lng);
+
+  fatback = fn->fatback;
+  if(fatback == NULL)fatback = create_fatbacklinks(fn->fat);
+  fn->fatback_F = create_G_F(fatback);
+  if(fatback != fn->fatback)destroy_fatbacklinks(fatback);
+
+  lngback = fn->lngback;
+  if(lngback == NULL)lngback = create_lngbacklinks(fn->lng);
+  fn->lngback_F = create_G_F(lngback);
+  if(lngback != fn->lngback)destroy_lngbacklinks(lngback);
+}
+#endif
+
+#ifdef KS_MULTICG_HALF
+/*-------------------------------------------------------------------*/
+/* 16-bit copies of the links for the multimass CG                   */
+/*-------------------------------------------------------------------*/
+
+static hsu3_matrix *
+create_G_H(su3_matrix *G){
+  char myname[] = "create_G_H";
+  hsu3_matrix *m;
+  int i, dir;
+
+  if(G == NULL)return NULL;
+
+  m = (hsu3_matrix *)field_alloc_tag(sites_on_node*4*sizeof(hsu3_matrix), MEM_LINKS);
+  if(m == NULL){
+    printf("%s: no room\n",myname);
+    terminate(1);
+  }
+
+  FORALLFIELDSITES_OMP(i,private(dir)){
+    for(dir = XUP; dir <= TUP; dir++)
+      su3mat_to_half(G + 4*i + dir, m + 4*i + dir);
+  } END_LOOP_OMP;
+
+  return m;
+}
+
+static void
+invalidate_fn_H_links(fn_links_t *fn){
+  if(fn == NULL)return;
+  field_free(fn->fat_H);
+  field_free(fn->lng_H);
+  field_free(fn->fatback_H);
+  field_free(fn->lngback_H);
+  fn->fat_H = NULL;
+  fn->lng_H = NULL;
+  fn->fatback_H = NULL;
+  fn->lngback_H = NULL;
+}
+
+/* As for the single precision copies, the back links are made here if
+   the working precision ones are not kept */
+void
+load_fn_H_links(fn_links_t *fn){
+  su3_matrix *fatback, *lngback;
+
+  if(fn == NULL)return;
+
+  invalidate_fn_H_links(fn);
+  fn->fat_H = create_G_H(fn->fat);
+  fn->lng_H = create_G_H(fn->lng);
+
+  fatback = fn->fatback;
+  if(fatback == NULL)fatback = create_fatbacklinks(fn->fat);
+  fn->fatback_H = create_G_H(fatback);
+  if(fatback != fn->fatback)destroy_fatbacklinks(fatback);
+
+  lngback = fn->lngback;
+  if(lngback == NULL)lngback = create_lngbacklinks(fn->lng);
+  fn->lngback_H = create_G_H(lngback);
+  if(lngback != fn->lngback)destroy_lngbacklinks(lngback);
+}
+#endif
+
+/* Drop copies derived from the links (SIMD layout, single precision,
+   16-bit) and mark the multigrid coarse operator stale.
+   Call this whenever the links change.  The copies are rebuilt on next
+   use. */
+void
+invalidate_fn_link_copies(fn_links_t *fn){
+#ifdef D_FN_SOA
+  invalidate_fn_soa_links(fn);
+#endif
+#ifdef KS_CG_MIXED
+  invalidate_fn_F_links(fn);
+#endif
+#ifdef KS_MULTICG_HALF
+  invalidate_fn_H_links(fn);
+#endif
+#ifdef KS_MG_MILC
+  invalidate_fn_mg(fn);
+#endif
+}
+
 /*-------------------------------------------------------------------*/
 /* Load back links                                                   */
 /*-------------------------------------------------------------------*/
@@ -225,6 +494,7 @@ load_fn_backlinks(fn_links_t *fn){
   destroy_fn_backlinks(fn);
   fn->lngback = create_lngbacklinks(fn->lng);
   fn->fatback = create_fatbacklinks(fn->fat);
+  invalidate_fn_link_copies(fn);
 }
 
 /*-------------------------------------------------------------------*/
@@ -239,6 +509,27 @@ init_ferm_links(fn_links_t *fn){
   fn->lngback = NULL;
   fn->eps_naik = 0.0;
   fn->notify_quda_new_links = 1;
+#ifdef D_FN_SOA
+  fn->fat_soa = NULL;
+  fn->lng_soa = NULL;
+  fn->fatback_soa = NULL;
+  fn->lngback_soa = NULL;
+#endif
+#ifdef KS_CG_MIXED
+  fn->fat_F = NULL;
+  fn->lng_F = NULL;
+  fn->fatback_F = NULL;
+  fn->lngback_F = NULL;
+#endif
+#ifdef KS_MULTICG_HALF
+  fn->fat_H = NULL;
+  fn->lng_H = NULL;
+  fn->fatback_H = NULL;
+  fn->lngback_H = NULL;
+#endif
+#ifdef KS_MG_MILC
+  fn->mg = NULL;
+#endif
 }
 /* The fat/long members are not created */
 
@@ -278,6 +569,10 @@ destroy_fn_links(fn_links_t *fn){
   destroy_fatlinks(fn->fat);
   destroy_lnglinks(fn->lng);
   destroy_fn_backlinks(fn);
+  invalidate_fn_link_copies(fn);
+#ifdef KS_MG_MILC
+  destroy_fn_mg(fn);
+#endif
   free(fn);
 }
 
@@ -301,6 +596,79 @@ su3_matrix *get_fatbacklinks(fn_links_t *fn){
   return fn->fatback;
 }
 
+#ifdef KS_CG_MIXED
+/* The single precision copies are built on first use after any change
+   to the links */
+
+fsu3_matrix *get_F_fatlinks(fn_links_t *fn){
+  if(fn->fat_F == NULL)load_fn_F_links(fn);
+  return fn->fat_F;
+}
+
+fsu3_matrix *get_F_lnglinks(fn_links_t *fn){
+  if(fn->fat_F == NULL)load_fn_F_links(fn);
+  return fn->lng_F;
+}
+
+fsu3_matrix *get_F_fatbacklinks(fn_links_t *fn){
+  if(fn->fat_F == NULL)load_fn_F_links(fn);
+  return fn->fatback_F;
+}
+
+fsu3_matrix *get_F_lngbacklinks(fn_links_t *fn){
+  if(fn->fat_F == NULL)load_fn_F_links(fn);
+  return fn->lngback_F;
+}
+#endif
+
+#ifdef KS_MULTICG_HALF
+/* Likewise the 16-bit copies */
+
+hsu3_matrix *get_H_fatlinks(fn_links_t *fn){
+  if(fn->fat_H == NULL)load_fn_H_links(fn);
+  return fn->fat_H;
+}
+
+hsu3_matrix *get_H_lnglinks(fn_links_t *fn){
+  if(fn->fat_H == NULL)load_fn_H_links(fn);
+  return fn->lng_H;
+}
+
+hsu3_matrix *get_H_fatbacklinks(fn_links_t *fn){
+  if(fn->fat_H == NULL)load_fn_H_links(fn);
+  return fn->fatback_H;
+}
+
+hsu3_matrix *get_H_lngbacklinks(fn_links_t *fn){
+  if(fn->fat_H == NULL)load_fn_H_links(fn);
+  return fn->lngback_H;
+}
+#endif
+
+#ifdef D_FN_SOA
+/* The SIMD copies are built on first use after any change to the links */
+
+su3_matrix_soa *get_fatlinks_soa(fn_links_t *fn){
+  if(fn->fat_soa == NULL)load_fn_soa_links(fn);
+  return fn->fat_soa;
+}
+
+su3_matrix_soa *get_lnglinks_soa(fn_links_t *fn){
+  if(fn->fat_soa == NULL)load_fn_soa_links(fn);
+  return fn->lng_soa;
+}
+
+su3_matrix_soa *get_fatbacklinks_soa(fn_links_t *fn){
+  if(fn->fat_soa == NULL)load_fn_soa_links(fn);
+  return fn->fatback_soa;
+}
+
+su3_matrix_soa *get_lngbacklinks_soa(fn_links_t *fn){
+  if(fn->fat_soa == NULL)load_fn_soa_links(fn);
+  return fn->lngback_soa;
+}
+#endif
+
 /*-------------------------------------------------------------------*/
 /* Some methods                                                      */
 /*-------------------------------------------------------------------*/
@@ -337,6 +705,8 @@ copy_fn(fn_links_t *fn_src, fn_links_t *fn_dst){
   fn_dst->eps_naik = fn_src->eps_naik;
 
   END_LOOP_OMP;
+
+  invalidate_fn_link_copies(fn_dst);
 }
 
 /* Multipy by scalar: fndst = fnsrc * s.  OK to do this in place. */
@@ -366,6 +736,8 @@ scalar_mult_fn(fn_links_t *fn_src, Real s, fn_links_t *fn_dst){
     }
   }
   END_LOOP_OMP;
+
+  invalidate_fn_link_copies(fn_dst);
 }
 
 /* Add fnC = fnA + fnB */
@@ -410,6 +782,8 @@ add_fn(fn_links_t *fn_A, fn_links_t *fn_B, fn_links_t *fn_C){
     }
   }
   END_LOOP_OMP;
+
+  invalidate_fn_link_copies(fn_C);
 }
 
 int
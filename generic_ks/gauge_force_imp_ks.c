@@ -5,16 +5,22 @@
 
 #include "generic_ks_includes.h"	/* definitions files and prototypes */
 
-void imp_gauge_force_ks( Real eps, field_offset mom_off ){
+/* Updates the momenta, wherever the application keeps them */
+
+void imp_gauge_force_ks( Real eps ){
 #ifdef USE_GF_GPU
-  imp_gauge_force_gpu(eps, mom_off);
+  imp_gauge_force_gpu(eps, F_OFFSET(mom));
 #elif USE_GF_QPHIX
   rephase(OFF);
-  imp_gauge_force_qphix(eps, mom_off);
+  imp_gauge_force_qphix(eps, F_OFFSET(mom));
   rephase(ON);
 #else
   rephase(OFF);
-  imp_gauge_force_cpu(eps, mom_off);
+#ifdef MOM_FIELD
+  imp_gauge_force_cpu_field(eps, mom_field);
+#else
+  imp_gauge_force_cpu(eps, F_OFFSET(mom));
+#endif
   rephase(ON);
 #endif
 }
@@ -230,7 +230,7 @@ void ks_meson_cont_mom(
       terminate(1);
     }
   
-  meson = (complex *)malloc(sites_on_node*sizeof(complex));
+  meson = (complex *)field_alloc(sites_on_node*sizeof(complex));
   if(meson == NULL){
     printf("%s(%d): No room for meson\n",myname,this_node);
     terminate(1);
@@ -250,7 +250,7 @@ void ks_meson_cont_mom(
   
   for(t = 0; t < nt; t++)nonzero[t] = 0;
   
-  ftfact = (complex *)malloc(no_q_momenta*sites_on_node*sizeof(complex));
+  ftfact = (complex *)field_alloc(no_q_momenta*sites_on_node*sizeof(complex));
   if(ftfact == NULL)
     {
       printf("%s(%d): No room for FFT phases\n",myname,this_node);
@@ -415,7 +415,7 @@ void ks_meson_cont_mom(
       free(p_ind);
     }  /**** end of the loop over the spin-taste table ******/
   
-  free(meson);  free(meson_q);  free(nonzero);  free(ftfact);
+  field_free(meson);  free(meson_q);  free(nonzero);  field_free(ftfact);
   
   destroy_v_field(quark);
   destroy_v_field(antiquark);
@@ -0,0 +1,1110 @@
+/******* ks_mg_milc.c - multigrid solver for improved staggered fermions ****/
+/* MIMD version 7 */
+/* Kogut-Susskind fermions -- this version for "fat plus Naik" quark
+   actions on the plain MILC path.  Requires -DMULTIGRID.
+
+   Two-level adaptive algebraic multigrid for M = 2m + Dslash, used by
+   mat_invert_uml_field and mat_invert_cg_field when the caller sets
+   qic->inv_type = MGTYPE.
+
+   Coarsening
+
+   The lattice is divided into blocks of mg_block_size^4 sites, which
+   must tile each node's sublattice.  The block size must be even, so
+   every block has equal numbers of even and odd sites.  Each of the
+   mg_nvecs near-null vectors is split into its even-site and odd-site
+   parts on every block and the parts are orthonormalized block by
+   block, giving 2*mg_nvecs coarse degrees of freedom per block.
+   Because Dslash connects only opposite parities, this parity
+   ("Kahler-Dirac") splitting keeps the coarse operator in the form
+   2m + D_c with D_c anti-Hermitian and connecting only even to odd
+   coarse degrees of freedom.  Like the fine operator it couples a
+   block to its neighbors at distance one block (fat links) and, for
+   mg_block_size 2, distance two (long links).
+
+   The near-null vectors are the first mg_nvecs eigenvectors of
+   -Dslash^2, if the application has computed at least that many.
+   Otherwise they are made from random vectors by inverse iteration,
+   applying mg_setup_iters CG iterations on the even-site normal
+   equations.  The odd-site part is Dslash_oe times the even-site part,
+   as in construct_eigen_odd.
+
+   Coarse vectors are stored on the fine lattice, the coarse degrees
+   of freedom of one parity on the sites of that parity in the block.
+   The coarse Dslash then uses ordinary MILC gathers with a
+   displacement of one (or two) block sizes.
+
+   Solver
+
+   The outer solver is flexible GCR on M x = b, restarted every
+   mg_krylov iterations, with the true residual recomputed at each
+   restart.  The preconditioner is a coarse-grid correction followed by
+   mg_smoother_iters CGNR iterations on the fine level.  The coarse
+   system is solved on the even coarse degrees of freedom by CG on the
+   Schur complement 4m^2 - D_eo D_oe to a relative residual of
+   mg_coarse_resid (at most mg_coarse_max_iters iterations).  The
+   starting guess is dst.  The solve stops when the true residual meets
+   both qic->resid and, if nonzero, the Fermilab relative residual
+   qic->relresid.  The relative residual is tested at the restarts.
+   qic->final_iters is the number of outer iterations and
+   qic->final_restart the number of restarts.
+
+   Setup
+
+   The setup is kept in fn_links_t and is redone when the parameter
+   file changes.  When the links change, only the coarse operator is
+   rebuilt.  The near-null vectors are kept until the links are
+   destroyed.
+
+   Parameter file (qic->mgparamfile), for example
+
+   mg_block_size 4
+   mg_nvecs 24
+   mg_setup_iters 40
+   mg_smoother_iters 4
+   mg_coarse_resid 0.05
+   mg_coarse_max_iters 500
+   mg_krylov 16
+*/
+
+#include "generic_ks_includes.h"
+#include "../include/openmp_defs.h"
+#include <string.h>
+
+#ifdef KS_MG_MILC
+
+#define MG_MAX_NVECS 64
+#define MG_MAX_DIRS 17   /* self plus +-1 and +-2 blocks in four directions */
+#define MG_MAX_GEOMS 4   /* distinct block sizes in one run */
+#define MG_SEED 5347     /* seed for the random starting vectors */
+#define IF_OK if(status==0)
+
+typedef struct {
+  int block;            /* block extent in each direction */
+  int nvecs;            /* near-null vectors */
+  int setup_iters;      /* CG iterations of inverse iteration per vector */
+  int smoother_iters;   /* CGNR smoother iterations */
+  Real coarse_resid;    /* relative residual of the coarse solve */
+  int coarse_max_iters;
+  int krylov;           /* FGCR restart length */
+} ks_mg_param;
+
+struct ks_mg_struct {
+  ks_mg_param par;
+  char paramfile[MAXFILENAME];
+  int ncs;              /* complex numbers per site in a coarse vector */
+  int *cidx[2];         /* [parity][b*nvecs + k] -> index in a coarse vector */
+  su3_vector **nn;      /* near-null vectors, block orthonormalized */
+  complex *cop[2];      /* coarse hopping matrices onto [0] even, [1] odd dofs */
+  int coarse_valid;     /* 0 after the links have changed */
+};
+
+typedef struct ks_mg_struct ks_mg_t;
+
+/* Block geometry, shared by all setups with the same block size */
+static int geom_block = 0;       /* block size of the tables, 0 if none */
+static int nblocks;              /* blocks on this node */
+static int vb2;                  /* sites of one parity in a block */
+static int *blk_of = NULL;       /* block of each site */
+static int *blk_sites[2];        /* [parity][b*vb2 + j] sites of a block */
+static int ndir;                 /* coarse stencil size */
+static int nreach;               /* reach of the coarse stencil in blocks */
+static int gather_index[MG_MAX_DIRS];
+static char **mg_pt[MG_MAX_DIRS];
+
+/* Gathers cannot be freed, so those for each block size are made once
+   and reused when the block size comes back */
+static int ngeoms = 0;
+static int geom_blocks[MG_MAX_GEOMS];
+static int geom_gathers[MG_MAX_GEOMS][MG_MAX_DIRS];
+
+static int
+pidx(int parity){
+  return (parity == EVEN) ? 0 : 1;
+}
+
+static int
+site_coord(site *s, int dir){
+  switch(dir){
+  case XUP: return s->x;
+  case YUP: return s->y;
+  case ZUP: return s->z;
+  default:  return s->t;
+  }
+}
+
+/* Gather from the site "disp" steps away in direction "dir" */
+static void
+block_neighbor(int x, int y, int z, int t, int *arg, int forw_back,
+	       int *xp, int *yp, int *zp, int *tp)
+{
+  int disp = (forw_back == FORWARDS) ? arg[1] : -arg[1];
+
+  *xp = x; *yp = y; *zp = z; *tp = t;
+  switch(arg[0]){
+  case XUP: *xp = ((x + disp) % nx + nx) % nx; break;
+  case YUP: *yp = ((y + disp) % ny + ny) % ny; break;
+  case ZUP: *zp = ((z + disp) % nz + nz) % nz; break;
+  case TUP: *tp = ((t + disp) % nt + nt) % nt; break;
+  }
+}
+
+/* Coarse stencil index of a displacement by "off" blocks in direction dir */
+static int
+stencil_dir(int dir, int off){
+  if(off == 0)return 0;
+  if(off > 0)return 1 + 2*(dir*nreach + off - 1);
+  return 2 + 2*(dir*nreach - off - 1);
+}
+
+/* Block offset reached from in-block coordinate c by a hop of h sites */
+static int
+block_offset(int c, int h){
+  int y = c + h;
+  return (y >= 0) ? y/geom_block : -((geom_block - 1 - y)/geom_block);
+}
+
+/* Position of a site among the sites of its parity in its block, in
+   lexicographic order of the coordinates relative to the block corner.
+   The coarse Dslash relies on this order being the same in every block
+   on every node, since it finds the neighboring block's degrees of
+   freedom by a shift of whole blocks. */
+static int
+block_position(site *s, int block){
+  int x = s->x % block, y = s->y % block, z = s->z % block, t = s->t % block;
+  return (x + block*(y + block*(z + block*t)))/2;
+}
+
+static void
+make_block_geometry(int block){
+  char myname[] = "make_block_geometry";
+  int i, b, dir, r, g, n[2];
+  site *s;
+  int *fill;
+
+  if(geom_block == block)return;
+
+  if(block < 2 || block % 2 != 0){
+    node0_printf("%s: block size %d must be even\n", myname, block);
+    terminate(1);
+  }
+
+  /* Blocks must lie within a node */
+  FORALLSITES(i,s){
+    int x0 = s->x - s->x % block, y0 = s->y - s->y % block;
+    int z0 = s->z - s->z % block, t0 = s->t - s->t % block;
+    if(nx % block || ny % block || nz % block || nt % block ||
+       node_number(x0, y0, z0, t0) != this_node ||
+       node_number(x0+block-1, y0+block-1, z0+block-1, t0+block-1) != this_node){
+      printf("%s(%d): blocks of %d^4 do not tile the sublattice\n",
+	     myname, this_node, block);
+      terminate(1);
+    }
+  }
+
+  if(blk_of != NULL){
+    free(blk_of); free(blk_sites[0]); free(blk_sites[1]);
+    for(i = 1; i < ndir; i++)free(mg_pt[i]);
+  }
+
+  geom_block = block;
+  vb2 = block*block*block*block/2;
+  nblocks = sites_on_node/(2*vb2);
+#ifdef NO_LONG_LINKS
+  nreach = 1;
+#else
+  nreach = (block >= 3) ? 1 : 2;
+#endif
+  ndir = 1 + 8*nreach;
+
+  /* Number the blocks by their lowest corner */
+  blk_of = (int *)malloc(sites_on_node*sizeof(int));
+  blk_sites[0] = (int *)malloc(nblocks*vb2*sizeof(int));
+  blk_sites[1] = (int *)malloc(nblocks*vb2*sizeof(int));
+  fill = (int *)malloc(2*nblocks*sizeof(int));
+  if(blk_of == NULL || blk_sites[0] == NULL || blk_sites[1] == NULL || fill == NULL){
+    printf("%s(%d): no room\n", myname, this_node);
+    terminate(1);
+  }
+  b = 0;
+  FORALLSITES(i,s){
+    if(s->x % block == 0 && s->y % block == 0 &&
+       s->z % block == 0 && s->t % block == 0)
+      blk_of[i] = b++;
+  }
+  FORALLSITES(i,s){
+    blk_of[i] = blk_of[node_index(s->x - s->x % block, s->y - s->y % block,
+				  s->z - s->z % block, s->t - s->t % block)];
+  }
+  /* Sites of a block in the order of block_position.  With an even
+     block size, x is even or odd with the parity of y + z + t, so the
+     lexicographic index halved is a one-to-one map within a parity. */
+  for(b = 0; b < 2*nblocks; b++)fill[b] = 0;
+  FORALLSITES(i,s){
+    int p = pidx(s->parity);
+    b = blk_of[i];
+    blk_sites[p][b*vb2 + block_position(s, block)] = i;
+    fill[2*b+p]++;
+  }
+  for(b = 0; b < nblocks; b++)
+    if(fill[2*b] != vb2 || fill[2*b+1] != vb2){
+      printf("%s(%d): block %d has %d even and %d odd sites, not %d\n",
+	     myname, this_node, b, fill[2*b], fill[2*b+1], vb2);
+      terminate(1);
+    }
+  FORALLSITES(i,s){
+    int p = pidx(s->parity);
+    if(blk_sites[p][blk_of[i]*vb2 + block_position(s, block)] != i){
+      printf("%s(%d): two sites share a position in block %d\n",
+	     myname, this_node, blk_of[i]);
+      terminate(1);
+    }
+  }
+  free(fill);
+
+  /* Gathers from one and two blocks away */
+  for(g = 0; g < ngeoms; g++)
+    if(geom_blocks[g] == block)break;
+  if(g == ngeoms){
+    if(ngeoms == MG_MAX_GEOMS){
+      node0_printf("%s: more than %d block sizes in one run\n",
+		   myname, MG_MAX_GEOMS);
+      terminate(1);
+    }
+    for(dir = XUP; dir <= TUP; dir++)
+      for(r = 1; r <= nreach; r++){
+	int args[2];
+	args[0] = dir; args[1] = r*block;
+	n[0] = make_gather(block_neighbor, args, WANT_INVERSE,
+			   ALLOW_EVEN_ODD, SAME_PARITY);
+	geom_gathers[g][stencil_dir(dir, r)] = n[0];
+	geom_gathers[g][stencil_dir(dir, -r)] = n[0] + 1;
+      }
+    geom_blocks[g] = block;
+    ngeoms++;
+  }
+  for(i = 1; i < ndir; i++)
+    gather_index[i] = geom_gathers[g][i];
+  for(i = 1; i < ndir; i++){
+    mg_pt[i] = (char **)malloc(sites_on_node*sizeof(char *));
+    if(mg_pt[i] == NULL){
+      printf("%s(%d): no room\n", myname, this_node);
+      terminate(1);
+    }
+  }
+}
+
+/*--------------------------------------------------------------------*/
+/* Coarse vectors                                                     */
+/*--------------------------------------------------------------------*/
+
+static complex *
+create_cv(ks_mg_t *mg){
+  complex *v = (complex *)calloc(sites_on_node*mg->ncs, sizeof(complex));
+  if(v == NULL){
+    printf("create_cv(%d): no room\n", this_node);
+    terminate(1);
+  }
+  return v;
+}
+
+static double
+cv_norm2(ks_mg_t *mg, complex *a, int parity){
+  int nv = mg->par.nvecs, n = nblocks*nv, i, *ci = mg->cidx[pidx(parity)];
+  double sum = 0.;
+#ifdef OMP
+#pragma omp parallel for reduction(+:sum)
+#endif
+  for(i = 0; i < n; i++)
+    sum += cabs_sq(&a[ci[i]]);
+  g_doublesum(&sum);
+  return sum;
+}
+
+static double
+cv_redot(ks_mg_t *mg, complex *a, complex *b, int parity){
+  int nv = mg->par.nvecs, n = nblocks*nv, i, *ci = mg->cidx[pidx(parity)];
+  double sum = 0.;
+#ifdef OMP
+#pragma omp parallel for reduction(+:sum)
+#endif
+  for(i = 0; i < n; i++)
+    sum += a[ci[i]].real*b[ci[i]].real + a[ci[i]].imag*b[ci[i]].imag;
+  g_doublesum(&sum);
+  return sum;
+}
+
+/* c <- a + s*b on one parity */
+static void
+cv_axpy(ks_mg_t *mg, complex *a, Real s, complex *b, complex *c, int parity){
+  int nv = mg->par.nvecs, n = nblocks*nv, i, *ci = mg->cidx[pidx(parity)];
+#ifdef OMP
+#pragma omp parallel for
+#endif
+  for(i = 0; i < n; i++){
+    c[ci[i]].real = a[ci[i]].real + s*b[ci[i]].real;
+    c[ci[i]].imag = a[ci[i]].imag + s*b[ci[i]].imag;
+  }
+}
+
+/* dst <- D_c src on the given parity, from the other parity of src */
+static void
+coarse_dslash(ks_mg_t *mg, complex *src, complex *dst, int parity){
+  int nv = mg->par.nvecs, ncs = mg->ncs;
+  int pi = pidx(parity), qi = 1 - pi;
+  int otherparity = (parity == EVEN) ? ODD : EVEN;
+  int d, b;
+  msg_tag *tag[MG_MAX_DIRS];
+
+  for(d = 1; d < ndir; d++)
+    tag[d] = start_gather_field(src, ncs*sizeof(complex), gather_index[d],
+				otherparity, mg_pt[d]);
+  for(d = 1; d < ndir; d++)
+    wait_gather(tag[d]);
+
+#ifdef OMP
+#pragma omp parallel for private(d)
+#endif
+  for(b = 0; b < nblocks; b++){
+    complex x[MG_MAX_NVECS], acc[MG_MAX_NVECS];
+    int k, l;
+
+    for(k = 0; k < nv; k++){ acc[k].real = 0.; acc[k].imag = 0.; }
+    for(d = 0; d < ndir; d++){
+      complex *m = mg->cop[pi] + (size_t)(b*ndir + d)*nv*nv;
+      for(l = 0; l < nv; l++){
+	int j = blk_sites[qi][b*vb2 + l/ncs];
+	x[l] = (d == 0) ? src[j*ncs + l%ncs] : ((complex *)mg_pt[d][j])[l%ncs];
+      }
+      for(k = 0; k < nv; k++)
+	for(l = 0; l < nv; l++){
+	  acc[k].real += m[k*nv+l].real*x[l].real - m[k*nv+l].imag*x[l].imag;
+	  acc[k].imag += m[k*nv+l].real*x[l].imag + m[k*nv+l].imag*x[l].real;
+	}
+    }
+    for(k = 0; k < nv; k++)
+      dst[mg->cidx[pi][b*nv + k]] = acc[k];
+  }
+
+  for(d = 1; d < ndir; d++)
+    cleanup_gather(tag[d]);
+}
+
+/* x <- (2m + D_c)^-1 b, approximately.  CG on the even Schur complement
+   (4m^2 - D_eo D_oe) x_e = 2m b_e - D_eo b_o, then
+   x_o = (b_o - D_oe x_e)/2m.  Returns the number of CG iterations. */
+static int
+coarse_solve(ks_mg_t *mg, complex *b, complex *x, Real mass){
+  int nv = mg->par.nvecs, iters = 0, i;
+  Real msq_x4 = 4.0*mass*mass;
+  complex *r = create_cv(mg), *p = create_cv(mg);
+  complex *ap = create_cv(mg), *t = create_cv(mg);
+  double rsq, oldrsq, pap, rsqstop, a;
+  int *ce = mg->cidx[0], *co = mg->cidx[1];
+
+  /* r <- 2m b_e - D_eo b_o */
+  coarse_dslash(mg, b, t, EVEN);
+  for(i = 0; i < nblocks*nv; i++){
+    r[ce[i]].real = 2.0*mass*b[ce[i]].real - t[ce[i]].real;
+    r[ce[i]].imag = 2.0*mass*b[ce[i]].imag - t[ce[i]].imag;
+    p[ce[i]] = r[ce[i]];
+    x[ce[i]].real = 0.; x[ce[i]].imag = 0.;
+  }
+  rsq = cv_norm2(mg, r, EVEN);
+  rsqstop = mg->par.coarse_resid*mg->par.coarse_resid*rsq;
+
+  while(rsq > rsqstop && iters < mg->par.coarse_max_iters){
+    coarse_dslash(mg, p, t, ODD);
+    coarse_dslash(mg, t, ap, EVEN);
+    cv_axpy(mg, ap, -msq_x4, p, ap, EVEN);   /* ap <- -(4m^2 - D_eo D_oe) p */
+    pap = -cv_redot(mg, p, ap, EVEN);
+    a = rsq/pap;
+    cv_axpy(mg, x, a, p, x, EVEN);
+    cv_axpy(mg, r, a, ap, r, EVEN);
+    oldrsq = rsq;
+    rsq = cv_norm2(mg, r, EVEN);
+    cv_axpy(mg, r, rsq/oldrsq, p, p, EVEN);
+    iters++;
+  }
+
+  /* x_o <- (b_o - D_oe x_e)/2m */
+  coarse_dslash(mg, x, t, ODD);
+  for(i = 0; i < nblocks*nv; i++){
+    x[co[i]].real = (b[co[i]].real - t[co[i]].real)/(2.0*mass);
+    x[co[i]].imag = (b[co[i]].imag - t[co[i]].imag)/(2.0*mass);
+  }
+
+  free(r); free(p); free(ap); free(t);
+  return iters;
+}
+
+/*--------------------------------------------------------------------*/
+/* Transfer between the levels                                        */
+/*--------------------------------------------------------------------*/
+
+/* rc <- P^dagger r */
+static void
+restrict_to_coarse(ks_mg_t *mg, su3_vector *r, complex *rc){
+  int nv = mg->par.nvecs, b;
+
+#ifdef OMP
+#pragma omp parallel for
+#endif
+  for(b = 0; b < nblocks; b++){
+    int p, j, k;
+    for(p = 0; p < 2; p++)
+      for(k = 0; k < nv; k++){
+	double re = 0., im = 0.;
+	for(j = 0; j < vb2; j++){
+	  int s = blk_sites[p][b*vb2 + j];
+	  complex cc = su3_dot(mg->nn[k] + s, r + s);
+	  re += cc.real; im += cc.imag;
+	}
+	rc[mg->cidx[p][b*nv + k]] = cmplx(re, im);
+      }
+  }
+}
+
+/* e <- e + P ec */
+static void
+prolong_add(ks_mg_t *mg, complex *ec, su3_vector *e){
+  int nv = mg->par.nvecs, b;
+
+#ifdef OMP
+#pragma omp parallel for
+#endif
+  for(b = 0; b < nblocks; b++){
+    int p, j, k;
+    for(p = 0; p < 2; p++)
+      for(j = 0; j < vb2; j++){
+	int s = blk_sites[p][b*vb2 + j];
+	for(k = 0; k < nv; k++)
+	  c_scalar_mult_add_su3vec(e + s, &ec[mg->cidx[p][b*nv + k]], mg->nn[k] + s);
+      }
+  }
+}
+
+/*--------------------------------------------------------------------*/
+/* Setup                                                              */
+/*--------------------------------------------------------------------*/
+
+static void
+read_mg_param(char *paramfile, ks_mg_param *par){
+  int status = 0;
+  FILE *fp;
+
+  if(this_node == 0){
+    fp = fopen(paramfile, "r");
+    if(fp == NULL){
+      printf("read_mg_param: can't open %s\n", paramfile);
+      status = 1;
+    } else {
+      printf("Multigrid parameters from %s\n", paramfile);
+      IF_OK status += get_i(fp, 0, "mg_block_size", &par->block);
+      IF_OK status += get_i(fp, 0, "mg_nvecs", &par->nvecs);
+      IF_OK status += get_i(fp, 0, "mg_setup_iters", &par->setup_iters);
+      IF_OK status += get_i(fp, 0, "mg_smoother_iters", &par->smoother_iters);
+      IF_OK status += get_f(fp, 0, "mg_coarse_resid", &par->coarse_resid);
+      IF_OK status += get_i(fp, 0, "mg_coarse_max_iters", &par->coarse_max_iters);
+      IF_OK status += get_i(fp, 0, "mg_krylov", &par->krylov);
+      fclose(fp);
+      IF_OK if(par->nvecs < 1 || par->nvecs > MG_MAX_NVECS ||
+	       par->krylov < 1){
+	printf("read_mg_param: need 1 <= mg_nvecs <= %d and mg_krylov >= 1\n",
+	       MG_MAX_NVECS);
+	status = 1;
+      }
+    }
+  }
+  broadcast_bytes((char *)&status, sizeof(int));
+  if(status != 0)terminate(1);
+  broadcast_bytes((char *)par, sizeof(ks_mg_param));
+}
+
+/* y <- (4m^2 - D_eo D_oe) x on even sites */
+static void
+normal_op_even(su3_vector *x, su3_vector *y, su3_vector *t, Real mass,
+	       fn_links_t *fn){
+  int i;
+  Real msq_x4 = 4.0*mass*mass;
+
+  dslash_fn_field(x, t, ODD, fn);
+  dslash_fn_field(t, y, EVEN, fn);
+  FOREVENFIELDSITES_OMP(i,){
+    scalar_mult_sum_su3_vector(y+i, x+i, -msq_x4);
+    scalar_mult_su3_vector(y+i, -1.0, y+i);
+  } END_LOOP_OMP;
+}
+
+/* x <- x - A^-1 A x with "iters" CG iterations, A the even-site normal
+   operator.  Damps all but the lowest modes of x */
+static void
+inverse_iterate(su3_vector *x, Real mass, int iters, fn_links_t *fn){
+  su3_vector *r = create_v_field(), *p = create_v_field();
+  su3_vector *ap = create_v_field(), *t = create_v_field();
+  su3_vector *y = create_v_field();
+  double rsq, oldrsq, pap, a;
+  int i, n;
+
+  normal_op_even(x, r, t, mass, fn);
+  rsq = 0.;
+  FOREVENFIELDSITES_OMP(i,reduction(+:rsq)){
+    p[i] = r[i];
+    rsq += magsq_su3vec(r+i);
+  } END_LOOP_OMP;
+  g_doublesum(&rsq);
+
+  for(n = 0; n < iters && rsq > 0.; n++){
+    normal_op_even(p, ap, t, mass, fn);
+    pap = 0.;
+    FOREVENFIELDSITES_OMP(i,reduction(+:pap)){
+      pap += su3_rdot(p+i, ap+i);
+    } END_LOOP_OMP;
+    g_doublesum(&pap);
+    a = rsq/pap;
+    oldrsq = rsq;
+    rsq = 0.;
+    FOREVENFIELDSITES_OMP(i,reduction(+:rsq)){
+      scalar_mult_sum_su3_vector(y+i, p+i, a);
+      scalar_mult_sum_su3_vector(r+i, ap+i, -a);
+      rsq += magsq_su3vec(r+i);
+    } END_LOOP_OMP;
+    g_doublesum(&rsq);
+    FOREVENFIELDSITES_OMP(i,){
+      scalar_mult_add_su3_vector(r+i, p+i, rsq/oldrsq, p+i);
+    } END_LOOP_OMP;
+  }
+
+  FOREVENFIELDSITES_OMP(i,){
+    sub_su3_vector(x+i, y+i, x+i);
+  } END_LOOP_OMP;
+
+  destroy_v_field(r); destroy_v_field(p); destroy_v_field(ap);
+  destroy_v_field(t); destroy_v_field(y);
+}
+
+static void
+make_near_null(ks_mg_t *mg, Real mass, fn_links_t *fn){
+  int nv = mg->par.nvecs, i, j, k;
+  site *s;
+  su3_vector *t = create_v_field();
+
+#if EIGMODE != EIGCG
+  if(param.eigen_param.Nvecs >= nv){
+    node0_printf("Multigrid near-null space from %d eigenvectors\n", nv);
+    for(k = 0; k < nv; k++)
+      copy_v_field(mg->nn[k], eigVec[k]);
+    destroy_v_field(t);
+    return;
+  }
+#endif
+
+  node0_printf("Multigrid near-null space from %d random vectors, %d iterations each\n",
+	       nv, mg->par.setup_iters);
+  for(k = 0; k < nv; k++){
+    su3_vector *v = mg->nn[k];
+
+    /* Reproducible on any layout and independent of the site generators */
+    clear_v_field(v);
+    FOREVENSITES(i,s){
+      double_prn prn;
+      int c;
+      initialize_prn(&prn, MG_SEED + k,
+		     s->x + nx*(s->y + ny*(s->z + nz*s->t)));
+      for(c = 0; c < 3; c++){
+	v[i].c[c].real = gaussian_rand_no(&prn);
+	v[i].c[c].imag = gaussian_rand_no(&prn);
+      }
+    }
+
+    inverse_iterate(v, mass, mg->par.setup_iters, fn);
+
+    /* Orthonormalize against the previous vectors */
+    for(j = 0; j < k; j++){
+      double re = 0., im = 0.;
+      complex cc;
+      FOREVENFIELDSITES_OMP(i,reduction(+:re,im)){
+	complex d = su3_dot(mg->nn[j]+i, v+i);
+	re += d.real; im += d.imag;
+      } END_LOOP_OMP;
+      g_doublesum(&re); g_doublesum(&im);
+      cc = cmplx(-re, -im);
+      FOREVENFIELDSITES_OMP(i,){
+	c_scalar_mult_add_su3vec(v+i, &cc, mg->nn[j]+i);
+      } END_LOOP_OMP;
+    }
+    {
+      double nrm = 0.;
+      FOREVENFIELDSITES_OMP(i,reduction(+:nrm)){
+	nrm += magsq_su3vec(v+i);
+      } END_LOOP_OMP;
+      g_doublesum(&nrm);
+      nrm = 1.0/sqrt(nrm);
+      FOREVENFIELDSITES_OMP(i,){
+	scalar_mult_su3_vector(v+i, nrm, v+i);
+      } END_LOOP_OMP;
+    }
+
+    /* Odd part, as in construct_eigen_odd */
+    dslash_fn_field(v, t, ODD, fn);
+    FORODDFIELDSITES_OMP(i,){
+      v[i] = t[i];
+    } END_LOOP_OMP;
+  }
+
+  destroy_v_field(t);
+}
+
+/* Gram-Schmidt on each block and parity */
+static void
+block_orthonormalize(ks_mg_t *mg){
+  int nv = mg->par.nvecs, b;
+
+#ifdef OMP
+#pragma omp parallel for
+#endif
+  for(b = 0; b < nblocks; b++){
+    int p, j, k, l, pass;
+    for(pass = 0; pass < 2; pass++)
+      for(p = 0; p < 2; p++)
+	for(k = 0; k < nv; k++){
+	  double nrm = 0.;
+	  for(l = 0; l < k; l++){
+	    double re = 0., im = 0.;
+	    complex cc;
+	    for(j = 0; j < vb2; j++){
+	      int s = blk_sites[p][b*vb2 + j];
+	      complex d = su3_dot(mg->nn[l]+s, mg->nn[k]+s);
+	      re += d.real; im += d.imag;
+	    }
+	    cc = cmplx(-re, -im);
+	    for(j = 0; j < vb2; j++){
+	      int s = blk_sites[p][b*vb2 + j];
+	      c_scalar_mult_add_su3vec(mg->nn[k]+s, &cc, mg->nn[l]+s);
+	    }
+	  }
+	  for(j = 0; j < vb2; j++)
+	    nrm += magsq_su3vec(mg->nn[k] + blk_sites[p][b*vb2 + j]);
+	  nrm = (nrm > 0.) ? 1.0/sqrt(nrm) : 0.;
+	  for(j = 0; j < vb2; j++){
+	    int s = blk_sites[p][b*vb2 + j];
+	    scalar_mult_su3_vector(mg->nn[k]+s, nrm, mg->nn[k]+s);
+	  }
+	}
+  }
+}
+
+/* Accumulate the coarse matrix elements of one hop, t(x) = U_hop(x) nn[l](x+hop) */
+static void
+add_hop(ks_mg_t *mg, su3_vector *t, int l, int dir, int h){
+  int nv = mg->par.nvecs, b;
+
+#ifdef OMP
+#pragma omp parallel for
+#endif
+  for(b = 0; b < nblocks; b++){
+    int p, j, k;
+    for(p = 0; p < 2; p++)
+      for(j = 0; j < vb2; j++){
+	int s = blk_sites[p][b*vb2 + j];
+	int c = site_coord(&lattice[s], dir) % geom_block;
+	int d = stencil_dir(dir, block_offset(c, h));
+	complex *m = mg->cop[p] + (size_t)(b*ndir + d)*nv*nv;
+	for(k = 0; k < nv; k++){
+	  complex cc = su3_dot(mg->nn[k]+s, t+s);
+	  m[k*nv+l].real += cc.real;
+	  m[k*nv+l].imag += cc.imag;
+	}
+      }
+  }
+}
+
+/* cop <- P^dagger Dslash P, hop by hop */
+static void
+build_coarse_op(ks_mg_t *mg, fn_links_t *fn){
+  int nv = mg->par.nvecs, l, dir, i;
+  size_t n = (size_t)nblocks*ndir*nv*nv;
+  su3_matrix *fat = get_fatlinks(fn);
+#ifndef NO_LONG_LINKS
+  su3_matrix *lng = get_lnglinks(fn);
+#endif
+  su3_vector *t = create_v_field(), *u = create_v_field();
+  msg_tag *tag;
+
+  memset(mg->cop[0], 0, n*sizeof(complex));
+  memset(mg->cop[1], 0, n*sizeof(complex));
+
+  for(l = 0; l < nv; l++){
+    su3_vector *v = mg->nn[l];
+    for(dir = XUP; dir <= TUP; dir++){
+      /* Forward one link */
+      tag = start_gather_field(v, sizeof(su3_vector), dir, EVENANDODD, gen_pt[0]);
+      wait_gather(tag);
+      FORALLFIELDSITES_OMP(i,){
+	mult_su3_mat_vec(fat + 4*i + dir, (su3_vector *)gen_pt[0][i], t+i);
+      } END_LOOP_OMP;
+      cleanup_gather(tag);
+      add_hop(mg, t, l, dir, 1);
+
+      /* Backward one link */
+      FORALLFIELDSITES_OMP(i,){
+	mult_adj_su3_mat_vec(fat + 4*i + dir, v+i, u+i);
+      } END_LOOP_OMP;
+      tag = start_gather_field(u, sizeof(su3_vector), OPP_DIR(dir), EVENANDODD, gen_pt[0]);
+      wait_gather(tag);
+      FORALLFIELDSITES_OMP(i,){
+	scalar_mult_su3_vector((su3_vector *)gen_pt[0][i], -1.0, t+i);
+      } END_LOOP_OMP;
+      cleanup_gather(tag);
+      add_hop(mg, t, l, dir, -1);
+
+#ifndef NO_LONG_LINKS
+      /* Forward three links */
+      tag = start_gather_field(v, sizeof(su3_vector), DIR3(dir), EVENANDODD, gen_pt[0]);
+      wait_gather(tag);
+      FORALLFIELDSITES_OMP(i,){
+	mult_su3_mat_vec(lng + 4*i + dir, (su3_vector *)gen_pt[0][i], t+i);
+      } END_LOOP_OMP;
+      cleanup_gather(tag);
+      add_hop(mg, t, l, dir, 3);
+
+      /* Backward three links */
+      FORALLFIELDSITES_OMP(i,){
+	mult_adj_su3_mat_vec(lng + 4*i + dir, v+i, u+i);
+      } END_LOOP_OMP;
+      tag = start_gather_field(u, sizeof(su3_vector), OPP_3_DIR(DIR3(dir)), EVENANDODD, gen_pt[0]);
+      wait_gather(tag);
+      FORALLFIELDSITES_OMP(i,){
+	scalar_mult_su3_vector((su3_vector *)gen_pt[0][i], -1.0, t+i);
+      } END_LOOP_OMP;
+      cleanup_gather(tag);
+      add_hop(mg, t, l, dir, -3);
+#endif
+    }
+  }
+
+  destroy_v_field(t);
+  destroy_v_field(u);
+  mg->coarse_valid = 1;
+}
+
+static ks_mg_t *
+create_ks_mg(char *paramfile, Real mass, fn_links_t *fn){
+  char myname[] = "create_ks_mg";
+  ks_mg_t *mg;
+  int nv, k, p, b;
+  size_t n;
+
+  mg = (ks_mg_t *)malloc(sizeof(ks_mg_t));
+  if(mg == NULL){
+    printf("%s(%d): no room\n", myname, this_node);
+    terminate(1);
+  }
+  strncpy(mg->paramfile, paramfile, MAXFILENAME-1);
+  mg->paramfile[MAXFILENAME-1] = '\0';
+  read_mg_param(paramfile, &mg->par);
+  make_block_geometry(mg->par.block);
+
+  nv = mg->par.nvecs;
+  if(nv > 3*vb2){
+    node0_printf("%s: mg_nvecs %d exceeds the %d colors times sites of a block parity\n",
+		 myname, nv, 3*vb2);
+    terminate(1);
+  }
+  mg->ncs = (nv + vb2 - 1)/vb2;
+  n = (size_t)nblocks*ndir*nv*nv;
+  mg->cop[0] = (complex *)malloc(n*sizeof(complex));
+  mg->cop[1] = (complex *)malloc(n*sizeof(complex));
+  mg->cidx[0] = (int *)malloc(nblocks*nv*sizeof(int));
+  mg->cidx[1] = (int *)malloc(nblocks*nv*sizeof(int));
+  mg->nn = (su3_vector **)malloc(nv*sizeof(su3_vector *));
+  if(mg->cop[0] == NULL || mg->cop[1] == NULL || mg->cidx[0] == NULL ||
+     mg->cidx[1] == NULL || mg->nn == NULL){
+    printf("%s(%d): no room\n", myname, this_node);
+    terminate(1);
+  }
+  for(p = 0; p < 2; p++)
+    for(b = 0; b < nblocks; b++)
+      for(k = 0; k < nv; k++)
+	mg->cidx[p][b*nv + k] = blk_sites[p][b*vb2 + k/mg->ncs]*mg->ncs + k%mg->ncs;
+  for(k = 0; k < nv; k++)
+    mg->nn[k] = create_v_field();
+
+  make_near_null(mg, mass, fn);
+  block_orthonormalize(mg);
+  mg->coarse_valid = 0;
+
+  return mg;
+}
+
+static void
+free_ks_mg(ks_mg_t *mg){
+  int k;
+
+  if(mg == NULL)return;
+  for(k = 0; k < mg->par.nvecs; k++)
+    destroy_v_field(mg->nn[k]);
+  free(mg->nn);
+  free(mg->cop[0]); free(mg->cop[1]);
+  free(mg->cidx[0]); free(mg->cidx[1]);
+  free(mg);
+}
+
+/* The links have changed.  Rebuild the coarse operator on next use */
+void
+invalidate_fn_mg(fn_links_t *fn){
+  if(fn != NULL && fn->mg != NULL)
+    fn->mg->coarse_valid = 0;
+}
+
+void
+destroy_fn_mg(fn_links_t *fn){
+  if(fn == NULL)return;
+  free_ks_mg(fn->mg);
+  fn->mg = NULL;
+}
+
+static ks_mg_t *
+ks_mg_prepare(char *paramfile, Real mass, fn_links_t *fn){
+  double dtime = -dclock();
+  int fresh = 0;
+
+  if(fn->mg != NULL && strcmp(fn->mg->paramfile, paramfile) != 0)
+    destroy_fn_mg(fn);
+  if(fn->mg == NULL){
+    fn->mg = create_ks_mg(paramfile, mass, fn);
+    fresh = 1;
+  }
+  if(! fn->mg->coarse_valid){
+    build_coarse_op(fn->mg, fn);
+    dtime += dclock();
+    node0_printf("Multigrid %s: %d blocks of %d^4, %d coarse dofs per block, time %g sec\n",
+		 fresh ? "setup" : "coarse operator rebuilt", nblocks*numnodes(),
+		 geom_block, 2*fn->mg->par.nvecs, dtime);
+  }
+  return fn->mg;
+}
+
+/*--------------------------------------------------------------------*/
+/* Solver                                                             */
+/*--------------------------------------------------------------------*/
+
+static double
+v_field_norm2(su3_vector *v){
+  int i;
+  double sum = 0.;
+  FORALLFIELDSITES_OMP(i,reduction(+:sum)){
+    sum += magsq_su3vec(v+i);
+  } END_LOOP_OMP;
+  g_doublesum(&sum);
+  return sum;
+}
+
+static double_complex
+v_field_dot(su3_vector *a, su3_vector *b){
+  int i;
+  double re = 0., im = 0.;
+  double_complex d;
+  FORALLFIELDSITES_OMP(i,reduction(+:re,im)){
+    complex cc = su3_dot(a+i, b+i);
+    re += cc.real; im += cc.imag;
+  } END_LOOP_OMP;
+  d = dcmplx(re, im);
+  g_dcomplexsum(&d);
+  return d;
+}
+
+/* z <- z + S(b - M z): CGNR iterations on M z = b */
+static void
+smooth_cgnr(su3_vector *b, su3_vector *z, Real mass, int iters, fn_links_t *fn){
+  su3_vector *r = create_v_field(), *s = create_v_field();
+  su3_vector *p = create_v_field(), *q = create_v_field();
+  double gamma, oldgamma, qq, a;
+  int i, n;
+
+  ks_dirac_op(z, q, mass, EVENANDODD, fn);
+  FORALLFIELDSITES_OMP(i,){
+    sub_su3_vector(b+i, q+i, r+i);
+  } END_LOOP_OMP;
+  ks_dirac_adj_op(r, s, mass, EVENANDODD, fn);
+  copy_v_field(p, s);
+  gamma = v_field_norm2(s);
+
+  for(n = 0; n < iters && gamma > 0.; n++){
+    ks_dirac_op(p, q, mass, EVENANDODD, fn);
+    qq = v_field_norm2(q);
+    a = gamma/qq;
+    FORALLFIELDSITES_OMP(i,){
+      scalar_mult_sum_su3_vector(z+i, p+i, a);
+      scalar_mult_sum_su3_vector(r+i, q+i, -a);
+    } END_LOOP_OMP;
+    if(n == iters - 1)break;
+    ks_dirac_adj_op(r, s, mass, EVENANDODD, fn);
+    oldgamma = gamma;
+    gamma = v_field_norm2(s);
+    FORALLFIELDSITES_OMP(i,){
+      scalar_mult_add_su3_vector(s+i, p+i, gamma/oldgamma, p+i);
+    } END_LOOP_OMP;
+  }
+
+  destroy_v_field(r); destroy_v_field(s);
+  destroy_v_field(p); destroy_v_field(q);
+}
+
+/* z <- K r: coarse-grid correction followed by fine smoothing */
+static int
+mg_precondition(ks_mg_t *mg, su3_vector *r, su3_vector *z, Real mass,
+		fn_links_t *fn){
+  complex *rc = create_cv(mg), *ec = create_cv(mg);
+  int iters;
+
+  restrict_to_coarse(mg, r, rc);
+  iters = coarse_solve(mg, rc, ec, mass);
+  clear_v_field(z);
+  prolong_add(mg, ec, z);
+  smooth_cgnr(r, z, mass, mg->par.smoother_iters, fn);
+
+  free(rc); free(ec);
+  return iters;
+}
+
+int
+mat_invert_mg_field(su3_vector *src, su3_vector *dst,
+		    quark_invert_control *qic, Real mass, imp_ferm_links_t *fn){
+  char myname[] = "mat_invert_mg_field";
+  ks_mg_t *mg;
+  su3_vector *r, **z, **w;
+  double bsq, rsq, rsqstop, relrsq = 0.;
+  Real relrsqmin = qic->relresid*qic->relresid;
+  int nk, k, j, i, iters = 0, restarts = 0, coarse_iters = 0, converged;
+  int max_iters = qic->max*qic->nrestart;
+  double dtime;
+
+  if(fn == NULL){
+    printf("%s(%d): Called with NULL fn\n", myname, this_node);
+    terminate(1);
+  }
+  if(mass <= 0.){
+    node0_printf("%s: requires a positive mass\n", myname);
+    terminate(1);
+  }
+
+  mg = ks_mg_prepare(qic->mgparamfile, mass, fn);
+  dtime = -dclock();
+
+  qic->final_rsq = 0.;
+  qic->final_relrsq = 0.;
+  qic->size_r = 0.;
+  qic->size_relr = 0.;
+  qic->final_iters = 0;
+  qic->final_restart = 0;
+  qic->converged = 1;
+
+  bsq = v_field_norm2(src);
+  if(bsq == 0.){
+    clear_v_field(dst);
+    return 0;
+  }
+  rsqstop = qic->resid*qic->resid*bsq;
+
+  nk = mg->par.krylov;
+  r = create_v_field();
+  z = (su3_vector **)malloc(nk*sizeof(su3_vector *));
+  w = (su3_vector **)malloc(nk*sizeof(su3_vector *));
+  if(z == NULL || w == NULL){
+    printf("%s(%d): no room\n", myname, this_node);
+    terminate(1);
+  }
+  for(k = 0; k < nk; k++){
+    z[k] = create_v_field();
+    w[k] = create_v_field();
+  }
+
+  /* r <- src - M dst */
+  ks_dirac_op(dst, r, mass, EVENANDODD, fn);
+  FORALLFIELDSITES_OMP(i,){
+    sub_su3_vector(src+i, r+i, r+i);
+  } END_LOOP_OMP;
+  rsq = v_field_norm2(r);
+  if(relrsqmin > 0)
+    relrsq = ks_relative_residue(r, dst, EVENANDODD);
+  converged = (qic->resid <= 0 || rsq <= rsqstop) &&
+    (relrsqmin <= 0 || relrsq <= relrsqmin);
+
+  while(!converged && iters < max_iters){
+    for(k = 0; k < nk && (rsq > rsqstop || relrsqmin > 0) &&
+	  iters < max_iters; k++){
+      double_complex a;
+      complex cc;
+      double wn;
+
+      coarse_iters += mg_precondition(mg, r, z[k], mass, fn);
+      ks_dirac_op(z[k], w[k], mass, EVENANDODD, fn);
+
+      /* Orthogonalize M z against the previous directions */
+      for(j = 0; j < k; j++){
+	double_complex beta = v_field_dot(w[j], w[k]);
+	cc = cmplx(-beta.real, -beta.imag);
+	FORALLFIELDSITES_OMP(i,){
+	  c_scalar_mult_add_su3vec(w[k]+i, &cc, w[j]+i);
+	  c_scalar_mult_add_su3vec(z[k]+i, &cc, z[j]+i);
+	} END_LOOP_OMP;
+      }
+      wn = 1.0/sqrt(v_field_norm2(w[k]));
+      FORALLFIELDSITES_OMP(i,){
+	scalar_mult_su3_vector(w[k]+i, wn, w[k]+i);
+	scalar_mult_su3_vector(z[k]+i, wn, z[k]+i);
+      } END_LOOP_OMP;
+
+      /* Minimize the residual along the new direction */
+      a = v_field_dot(w[k], r);
+      FORALLFIELDSITES_OMP(i,){
+	complex ca = cmplx(a.real, a.imag), cm = cmplx(-a.real, -a.imag);
+	c_scalar_mult_add_su3vec(dst+i, &ca, z[k]+i);
+	c_scalar_mult_add_su3vec(r+i, &cm, w[k]+i);
+      } END_LOOP_OMP;
+      rsq = v_field_norm2(r);
+      iters++;
+#ifdef CG_DEBUG
+      node0_printf("%s: iter %d rsq %e\n", myname, iters, rsq/bsq);
+#endif
+    }
+
+    /* Restart with the true residual */
+    ks_dirac_op(dst, r, mass, EVENANDODD, fn);
+    FORALLFIELDSITES_OMP(i,){
+      sub_su3_vector(src+i, r+i, r+i);
+    } END_LOOP_OMP;
+    rsq = v_field_norm2(r);
+    if(relrsqmin > 0)
+      relrsq = ks_relative_residue(r, dst, EVENANDODD);
+    converged = (qic->resid <= 0 || rsq <= rsqstop) &&
+      (relrsqmin <= 0 || relrsq <= relrsqmin);
+    restarts++;
+  }
+
+  qic->final_rsq = rsq/bsq;
+  qic->final_relrsq = relrsq;
+  qic->size_r = qic->final_rsq;
+  qic->size_relr = relrsq;
+  qic->final_iters = iters;
+  qic->final_restart = restarts;
+  qic->converged = converged;
+
+  dtime += dclock();
+#ifdef CGTIME
+  node0_printf("KS_MG: time = %e iters = %d coarse iters = %d final rsq = %e\n",
+	       dtime, iters, coarse_iters, qic->final_rsq);
+#endif
+
+  for(k = 0; k < nk; k++){
+    destroy_v_field(z[k]);
+    destroy_v_field(w[k]);
+  }
+  free(z); free(w);
+  destroy_v_field(r);
+
+  return iters;
+}
+
+#endif /* KS_MG_MILC */
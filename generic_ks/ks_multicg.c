@@ -10,6 +10,7 @@
 
 #include "generic_ks_includes.h"	/* definitions files and prototypes */
 #include "../include/loopend.h"
+#include "../include/openmp_defs.h"
 #include <string.h>
 
 /* Set the KS multicg inverter flavor depending on the macro KS_MULTICG */
@@ -19,6 +20,15 @@
 #define KS_MULTICG HYBRID
 #endif
 
+#ifdef KS_MULTICG_HALF
+#ifdef USE_CG_GPU
+#error KS_MULTICG_HALF is for the CPU multimass solver.  Use MAX_MIXED with QUDA
+#endif
+#ifdef NO_REFINE
+#error KS_MULTICG_HALF needs the single-mass refinements.  Drop NO_REFINE
+#endif
+#endif
+
 /* Forward declarations */
 static int ks_multicg_fake_field(	/* Return value is number of iterations taken */
     su3_vector *src,	/* source vector (type su3_vector) */
@@ -165,6 +175,60 @@ static Real *create_offsets_from_ksp(ks_param *ksp, int num_offsets){
 }
 #endif
 
+/**********************************************************************/
+/*   Low-mode deflation for the multimass inverter                    */
+/**********************************************************************/
+
+/* Uses the eigenpairs eigVal, eigVec of -Dslash^2 on both parities,
+   as made by ks_eigensolve and construct_eigen_odd, as in
+   mat_invert.c.  The eigenvectors are orthonormal on each parity. */
+
+/* c[k] <- eigVec[k]^dagger src and src <- src - sum_k c[k] eigVec[k]
+   on one parity */
+
+static void
+deflate_project_out(su3_vector *src, double_complex *c, int parity){
+  int i, k;
+
+  for(k = 0; k < param.eigen_param.Nvecs; k++){
+    double re = 0., im = 0.;
+    su3_vector *v = eigVec[k];
+    FORSOMEFIELDPARITY_OMP(i,parity,reduction(+:re,im)){
+      complex cc = su3_dot( v+i, src+i );
+      re += cc.real;
+      im += cc.imag;
+    } END_LOOP_OMP;
+    c[k] = dcmplx(re, im);
+  }
+  g_vecdcomplexsum( c, param.eigen_param.Nvecs );
+
+  for(k = 0; k < param.eigen_param.Nvecs; k++){
+    complex cc = cmplx(-c[k].real, -c[k].imag);
+    su3_vector *v = eigVec[k];
+    FORSOMEFIELDPARITY_OMP(i,parity,default(shared)){
+      c_scalar_mult_add_su3vec( src+i, &cc, v+i );
+    } END_LOOP_OMP;
+  }
+}
+
+/* dst <- dst + sum_k c[k]/(eigVal[k] + offset) eigVec[k] on one parity,
+   the exact low-mode part of the solution */
+
+static void
+deflate_add_low_modes(su3_vector *dst, double_complex *c, Real offset,
+		      int parity){
+  int i, k;
+
+  for(k = 0; k < param.eigen_param.Nvecs; k++){
+    double d = eigVal[k] + offset;
+    complex cc = cmplx(c[k].real/d, c[k].imag/d);
+    su3_vector *v = eigVec[k];
+    FORSOMEFIELDPARITY_OMP(i,parity,default(shared)){
+      c_scalar_mult_add_su3vec( dst+i, &cc, v+i );
+    } END_LOOP_OMP;
+  }
+}
+
 // Do a multimass CG followed by calls to individual CG's
 // to finish off.
 static int ks_multicg_hybrid_field(	/* Return value is number of iterations taken */
@@ -177,34 +241,101 @@ static int ks_multicg_hybrid_field(	/* Return value is number of iterations take
     )
 {
   int i,multi_iters=0,iters=0;
+  su3_vector *src_multi = src;
+  double_complex *c_even = NULL, *c_odd = NULL;
+  int parity = qic[0].parity;
+
+  /* With deflation, the multimass solve sees only the part of the
+     source orthogonal to the low modes.  Their contribution is added
+     exactly afterwards.  The refinement below uses the full source, so
+     it also corrects for any inaccuracy in the eigenpairs. */
+  int deflate = qic[0].deflate && param.eigen_param.Nvecs > 0;
+  if(deflate){
+    double dtime = -dclock();
+    src_multi = create_v_field();
+    copy_v_field(src_multi, src);
+    c_even = (double_complex *)malloc(param.eigen_param.Nvecs*sizeof(double_complex));
+    c_odd = (double_complex *)malloc(param.eigen_param.Nvecs*sizeof(double_complex));
+    if(parity == EVEN || parity == EVENANDODD)
+      deflate_project_out(src_multi, c_even, EVEN);
+    if(parity == ODD || parity == EVENANDODD)
+      deflate_project_out(src_multi, c_odd, ODD);
+    dtime += dclock();
+#ifdef CGTIME
+    node0_printf("Time to project out %d modes %g sec\n", param.eigen_param.Nvecs, dtime);
+#endif
+  }
 
+#if ( defined(HALF_MIXED) && !defined(USE_CG_GPU) ) || defined(KS_MULTICG_HALF)
+  /* Each offset stops at its own residual in the multicg, so all of
+     them are limited to what the reduced precision can reach */
+  Real *resid_save = (Real *)malloc(2*num_offsets*sizeof(Real));
+  Real *relresid_save = resid_save + num_offsets;
+  if(resid_save == NULL){
+    printf("ks_multicg_hybrid_field(%d): No room\n", this_node);
+    terminate(1);
+  }
+#endif
 #if defined(HALF_MIXED) && !defined(USE_CG_GPU)
   /* Do multicg in single precision.  (The GPU routine does this automatically for HALF_MIXED) */
   int prec_save = qic[0].prec;
   qic[0].prec = 1;
-  Real resid_save = qic[0].resid;
-  Real relresid_save =  qic[0].relresid;
 
   Real single_prec_resid = 1e-6;
   Real single_prec_relresid = 1e-4;
 
-  if ( resid_save !=0 && resid_save < single_prec_resid)
-                    qic[0].resid = single_prec_resid;
+  for(i = 0; i < num_offsets; i++){
+    resid_save[i] = qic[i].resid;
+    relresid_save[i] = qic[i].relresid;
+    if ( resid_save[i] !=0 && resid_save[i] < single_prec_resid)
+                    qic[i].resid = single_prec_resid;
 
-  if ( relresid_save != 0 && relresid_save < single_prec_relresid)
-                      qic[0].relresid = single_prec_relresid;
+    if ( relresid_save[i] != 0 && relresid_save[i] < single_prec_relresid)
+                      qic[i].relresid = single_prec_relresid;
+  }
   //  node0_printf("Using HALF-MIXED CG; resid = %e\n", qic[0].resid);
+#elif defined(KS_MULTICG_HALF)
+  /* The multicg runs with 16-bit links and vectors.  Stop it where the
+     storage precision limits it and leave the rest to the refinement */
+  Real half_prec_resid = 1e-4;
+  Real half_prec_relresid = 1e-3;
+
+  for(i = 0; i < num_offsets; i++){
+    resid_save[i] = qic[i].resid;
+    relresid_save[i] = qic[i].relresid;
+    if ( resid_save[i] !=0 && resid_save[i] < half_prec_resid)
+                    qic[i].resid = half_prec_resid;
+
+    if ( relresid_save[i] != 0 && relresid_save[i] < half_prec_relresid)
+                      qic[i].relresid = half_prec_relresid;
+  }
 #endif
 
   /* First we invert as though all masses took the same Naik epsilon */
   multi_iters = iters =
-    ks_multicg_offset_field( src, psim, ksp, num_offsets, qic, fn_multi[0]);
+    ks_multicg_offset_field( src_multi, psim, ksp, num_offsets, qic, fn_multi[0]);
   report_status(qic+0);
 
+  if(deflate){
+    for(i = 0; i < num_offsets; i++){
+      if(parity == EVEN || parity == EVENANDODD)
+	deflate_add_low_modes(psim[i], c_even, ksp[i].offset, EVEN);
+      if(parity == ODD || parity == EVENANDODD)
+	deflate_add_low_modes(psim[i], c_odd, ksp[i].offset, ODD);
+    }
+    destroy_v_field(src_multi);
+    free(c_even); free(c_odd);
+  }
+
 #if defined(HALF_MIXED) && !defined(USE_CG_GPU)
   qic[0].prec = prec_save;
-  qic[0].resid = resid_save;
-  qic[0].relresid = relresid_save;
+#endif
+#if ( defined(HALF_MIXED) && !defined(USE_CG_GPU) ) || defined(KS_MULTICG_HALF)
+  for(i = 0; i < num_offsets; i++){
+    qic[i].resid = resid_save[i];
+    qic[i].relresid = relresid_save[i];
+  }
+  free(resid_save);
 #endif
 
   /* Then we refine using the correct Naik epsilon */
@@ -765,16 +896,18 @@ int mat_invert_multi(
   int i, tot_iters = 0;
 
   /* Use preconditioned single-mass inverter if there are 2 or fewer masses 
-     or for any number of masses if we are doing deflation */
+     or for any number of masses if we are doing deflation, unless the
+     multimass inverter deflates itself.  The hybrid inverter (also the
+     fallback for REVERSE and REVHYB) does; FAKE does not. */
   /* EO preconditioning doesn't work with multimass solvers as the residual depends on m.
      With multimass the cost will be (even+odd) * cost of lightest mass, but two individual precond
      inversions will be mass1-precond + mass2-precond which should be faster than
      twice the slowest of them.
   */
 
-  /* If we are deflating or doing eigCG, we can't do multimass */
-  /* Fewer than three masses are not worth doing with multimass */
-  if(param.eigen_param.Nvecs > 0 || num_masses <= 2){
+  int multi_deflates = KS_MULTICG != FAKE && qic[0].deflate;
+
+  if(num_masses <= 2 || (param.eigen_param.Nvecs > 0 && !multi_deflates)){
     
     for(i = 0; i < num_masses; i++)
       tot_iters += mat_invert_uml_field(src, dst[i], &qic[i], ksp[i].mass, fn_multi[i] );
@@ -22,6 +22,14 @@
             offsets.
             For the moment, keep cg_p as a clone of pm[j_low], since I anticipate
             trying different layouts for pm[], and cg_p is an argument to dslash()
+
+   Each offset j stops at its own qic[j].resid (or qic[j].relresid).
+   Its residual is zeta[j] times that of the lowest offset, so it is
+   known without extra work.  The offsets other than the lowest that
+   are still being worked on are kept in a compact list, active[], and
+   a converged offset is swapped out of it, so the site loops only
+   touch the vectors still being updated.  The lowest offset keeps
+   driving the iteration until all have converged.
 */
 
 
@@ -58,6 +66,112 @@ my_relative_residue(su3_vector *p, su3_vector *q, int parity)
     return sqrt(2*residue/volume);
 }
 
+#ifdef KS_MULTICG_HALF
+
+/* Dslash with 16-bit links and source, for the 16-bit multimass
+   solve (KS_MULTICG_HALF).  The gathered source and the links are expanded in
+   registers.  Computes "parity" sites from the other parity of src
+   and stores the result either in the 16-bit hdest or, if hdest is
+   NULL, in the working precision dest.  As with
+   dslash_fn_field_special, the gathers are started when start = 1 and
+   restarted otherwise. */
+
+static void
+dslash_fn_field_half( hsu3_vector *src, hsu3_vector *hdest, su3_vector *dest,
+		      int parity, msg_tag **tag, int start, fn_links_t *fn ){
+  int i, dir;
+  hsu3_matrix *t_fatlink      = get_H_fatlinks(fn);
+  hsu3_matrix *t_fatbacklink  = get_H_fatbacklinks(fn);
+  hsu3_matrix *t_longlink     = get_H_lnglinks(fn);
+  hsu3_matrix *t_longbacklink = get_H_lngbacklinks(fn);
+#ifndef NO_LONG_LINKS
+  int do_long = 1;
+#else
+  int do_long = 0;
+#endif
+
+  /* Start all 16 gathers (8 without long links) */
+  for(dir = XUP; dir <= TUP; dir++){
+    if(start == 1){
+      tag[dir] = start_gather_field( src, sizeof(hsu3_vector), dir,
+				     parity, gen_pt[dir] );
+      tag[OPP_DIR(dir)] = start_gather_field( src, sizeof(hsu3_vector),
+				     OPP_DIR(dir), parity, gen_pt[OPP_DIR(dir)] );
+      if(do_long){
+	tag[DIR3(dir)] = start_gather_field( src, sizeof(hsu3_vector),
+				     DIR3(dir), parity, gen_pt[DIR3(dir)] );
+	tag[OPP_3_DIR(DIR3(dir))] = start_gather_field( src,
+				     sizeof(hsu3_vector), OPP_3_DIR(DIR3(dir)),
+				     parity, gen_pt[OPP_3_DIR(DIR3(dir))] );
+      }
+    } else {
+      restart_gather_field( src, sizeof(hsu3_vector), dir, parity,
+			    gen_pt[dir], tag[dir] );
+      restart_gather_field( src, sizeof(hsu3_vector), OPP_DIR(dir), parity,
+			    gen_pt[OPP_DIR(dir)], tag[OPP_DIR(dir)] );
+      if(do_long){
+	restart_gather_field( src, sizeof(hsu3_vector), DIR3(dir), parity,
+			      gen_pt[DIR3(dir)], tag[DIR3(dir)] );
+	restart_gather_field( src, sizeof(hsu3_vector), OPP_3_DIR(DIR3(dir)),
+			      parity, gen_pt[OPP_3_DIR(DIR3(dir))],
+			      tag[OPP_3_DIR(DIR3(dir))] );
+      }
+    }
+  }
+
+  for(dir = XUP; dir <= TUP; dir++){
+    wait_gather(tag[dir]);
+    wait_gather(tag[OPP_DIR(dir)]);
+    if(do_long){
+      wait_gather(tag[DIR3(dir)]);
+      wait_gather(tag[OPP_3_DIR(DIR3(dir))]);
+    }
+  }
+
+  FORSOMEFIELDPARITY_OMP(i,parity,private(dir)){
+    su3_vector fwd, back;
+    clearvec(&fwd);
+    clearvec(&back);
+    for(dir = XUP; dir <= TUP; dir++){
+      mult_su3_mat_vec_sum_half( t_fatlink + 4*i + dir,
+			 (hsu3_vector *)gen_pt[dir][i], &fwd );
+      mult_su3_mat_vec_sum_half( t_fatbacklink + 4*i + dir,
+			 (hsu3_vector *)gen_pt[OPP_DIR(dir)][i], &back );
+      if(do_long){
+	mult_su3_mat_vec_sum_half( t_longlink + 4*i + dir,
+			 (hsu3_vector *)gen_pt[DIR3(dir)][i], &fwd );
+	mult_su3_mat_vec_sum_half( t_longbacklink + 4*i + dir,
+			 (hsu3_vector *)gen_pt[OPP_3_DIR(DIR3(dir))][i], &back );
+      }
+    }
+    if(hdest == NULL){
+      sub_su3_vector( &fwd, &back, dest + i );
+    } else {
+      sub_su3_vector( &fwd, &back, &fwd );
+      su3vec_to_half( &fwd, hdest + i );
+    }
+  } END_LOOP_OMP;
+}
+
+static void
+cleanup_gathers_half( msg_tag *tags1[], msg_tag *tags2[] ){
+  int i;
+  for(i = XUP; i <= TUP; i++){
+    cleanup_gather(tags1[i]);
+    cleanup_gather(tags1[OPP_DIR(i)]);
+    cleanup_gather(tags2[i]);
+    cleanup_gather(tags2[OPP_DIR(i)]);
+#ifndef NO_LONG_LINKS
+    cleanup_gather(tags1[DIR3(i)]);
+    cleanup_gather(tags1[OPP_3_DIR(DIR3(i))]);
+    cleanup_gather(tags2[DIR3(i)]);
+    cleanup_gather(tags2[OPP_3_DIR(DIR3(i))]);
+#endif
+  }
+}
+
+#endif /* KS_MULTICG_HALF */
+
 /* Interface for call with offsets = 4 * mass * mass */
 
 int ks_multicg_offset_field_cpu( /* Return value is number of iterations taken */
@@ -73,36 +187,48 @@ int ks_multicg_offset_field_cpu( /* Return value is number of iterations taken *
   /* Site su3_vector's resid, cg_p and ttt are used as temporaies */
   register int i;
   int iteration;	/* counter for iterations */
-  int num_offsets_now; /* number of offsets still being worked on */
+  int num_active;	/* number of offsets in active[] */
+  int num_finished;	/* number converged */
   double c1, c2, rsq, oldrsq, pkp;		/* pkp = cg_p.K.cg_p */
-  double relrsq = 0.;
   double source_norm;	/* squared magnitude of source vector */
-  double rsqstop;	/* stopping residual normalized by source norm */
+  double * restrict rsqstop;	/* stopping residuals times source norm */
   int l_parity=0;	/* parity we are currently doing */
   int l_otherparity=0; /* the other parity */
 #ifdef FN
   msg_tag *tags1[16], *tags2[16];	/* tags for gathers to parity and opposite */
 #endif
   int special_started;	/* 1 if dslash_special has been called */
-  int j, j_low;
+  int a, j, j_low;
   Real * restrict shifts, offset_low, shift0;
   double * restrict zeta_i, * restrict zeta_im1, * restrict zeta_ip1;
   double * restrict beta_i, * restrict beta_im1, * restrict alpha;
   su3_vector ** restrict pm;	/* vectors not involved in gathers */
   int * restrict finished;      /* if converged */
+  int * restrict active;        /* offsets other than j_low still being updated */
+#ifdef KS_MULTICG_HALF
+  /* 16-bit storage for the shifted search directions other than
+     pm[j_low] and for the Dslash source and intermediate result */
+  hsu3_vector ** restrict pmh;
+  hsu3_vector *h_p, *h_t;
+#endif
 
-  /* Unpack qic structure.  The first qic sets the convergence criterion */
+  /* Unpack qic structure.  The first qic sets the iteration limit and
+     the parity.  Each offset stops at its own qic[j].resid and
+     qic[j].relresid; rsqmin is the first, for the messages. */
   /* We don't restart this algorithm, so we adopt the convention of
      taking the product here */
   int niter        = qic[0].max*qic[0].nrestart;
   Real rsqmin      = qic[0].resid * qic[0].resid;    /* desired squared residual - 
 							normalized as sqrt(r*r)/sqrt(src_e*src_e) */
-  Real relrsqmin   = qic->relresid * qic->relresid; /* desired relative residual (FNAL)*/
   int parity       = qic[0].parity;   /* EVEN, ODD */
   
 #ifdef CGTIME
+#ifdef KS_MULTICG_HALF
+  static const char *milc_prec[2] = {"H", "H"};
+#else
   static const char *milc_prec[2] = {"F", "D"};
 #endif
+#endif
   
   
   /* Timing */
@@ -130,6 +256,7 @@ int ks_multicg_offset_field_cpu( /* Return value is number of iterations taken *
   }
   
   if( num_offsets==0 )return(0);
+  PERF_BEGIN("ks_multicg");
   
   if(fn == NULL){
     printf("%s(%d): Called with NULL fn\n", myname, this_node);
@@ -145,14 +272,13 @@ int ks_multicg_offset_field_cpu( /* Return value is number of iterations taken *
   }
   
   finished = (int *)malloc(sizeof(int)*num_offsets);
-  if(finished == NULL){
+  active = (int *)malloc(sizeof(int)*num_offsets);
+  rsqstop = (double * restrict )malloc(num_offsets*sizeof(double));
+  if(finished == NULL || active == NULL || rsqstop == NULL){
     printf("%s: No room for 'finished'\n",myname);
     terminate(1);
   }
   
-  for(j = 0; j < num_offsets; j++)
-    finished[j] = 0;
-  
   nflop = 1205 + 15*num_offsets;
   
   if(parity==EVENANDODD)nflop *=2;
@@ -187,10 +313,25 @@ int ks_multicg_offset_field_cpu( /* Return value is number of iterations taken *
       j_low = j;
     }
   }
+#ifdef KS_MULTICG_HALF
+  pmh = (hsu3_vector ** restrict )malloc(num_offsets*sizeof(hsu3_vector *));
+  h_p = (hsu3_vector *)malloc(sites_on_node*sizeof(hsu3_vector));
+  h_t = (hsu3_vector *)malloc(sites_on_node*sizeof(hsu3_vector));
+  for(j=0;j<num_offsets;j++){
+    pm[j] = NULL;
+    pmh[j] = NULL;
+    if( j == j_low )
+      pm[j] = (su3_vector * restrict )malloc(sites_on_node*sizeof(su3_vector));
+    else
+      pmh[j] = (hsu3_vector * restrict )malloc(sites_on_node*sizeof(hsu3_vector));
+    if( j!=j_low )shifts[j] -= shifts[j_low];
+  }
+#else
   for(j=0;j<num_offsets;j++){ 
       pm[j] = (su3_vector * restrict )malloc(sites_on_node*sizeof(su3_vector));
       if( j!=j_low )shifts[j] -= shifts[j_low];
     }
+#endif
   shift0 = -shifts[j_low];
   
   
@@ -216,20 +357,41 @@ int ks_multicg_offset_field_cpu( /* Return value is number of iterations taken *
  start:
 #ifdef FN
   if(special_started==1) {        /* clean up gathers */
+#ifdef KS_MULTICG_HALF
+    cleanup_gathers_half(tags1, tags2);
+#else
     cleanup_gathers(tags1, tags2);
+#endif
     special_started = 0;
   }
 #endif
-  num_offsets_now = num_offsets;
+  num_finished = 0;
+  num_active = 0;
+  for(j = 0; j < num_offsets; j++){
+    finished[j] = 0;
+    if(j != j_low)active[num_active++] = j;
+  }
   source_norm = 0.0;
   FORSOMEFIELDPARITY_OMP(i,l_parity,private(j) reduction(+:source_norm) ){
     source_norm += (double) magsq_su3vec( src+i );
     su3vec_copy( src+i, resid+i);
     su3vec_copy(resid+i, cg_p+i);
+#ifdef KS_MULTICG_HALF
+    su3vec_to_half(cg_p+i, h_p+i);
+    for(j=0;j<num_offsets;j++) {
+	clearvec(psim[j]+i);
+	if(j == j_low){
+	  su3vec_copy(resid+i, pm[j]+i);
+	} else {
+	  su3vec_to_half(resid+i, pmh[j]+i);
+	}
+      }
+#else
     for(j=0;j<num_offsets;j++) {
 	clearvec(psim[j]+i);
 	su3vec_copy(resid+i, pm[j]+i);
       }
+#endif
   } END_LOOP_OMP;
   g_doublesum( &source_norm );
   rsq = source_norm;
@@ -245,13 +407,21 @@ int ks_multicg_offset_field_cpu( /* Return value is number of iterations taken *
     
 #ifdef FN
     if(special_started==1) {
+#ifdef KS_MULTICG_HALF
+      cleanup_gathers_half(tags1,tags2);
+#else
       cleanup_gathers(tags1,tags2);
+#endif
       special_started = 0;
     }
 #endif
     /* Free stuff */
     for(j=0;j<num_offsets;j++) free(pm[j]); 
     free(pm);
+#ifdef KS_MULTICG_HALF
+    for(j=0;j<num_offsets;j++) free(pmh[j]);
+    free(pmh); free(h_p); free(h_t);
+#endif
     
     free(zeta_i);
     free(zeta_ip1);
@@ -261,6 +431,8 @@ int ks_multicg_offset_field_cpu( /* Return value is number of iterations taken *
     free(alpha);
     free(shifts);
     free(finished);
+    free(active);
+    free(rsqstop);
 #ifdef CGTIME
     dtimec += dclock();
     if(this_node==0){
@@ -271,13 +443,15 @@ int ks_multicg_offset_field_cpu( /* Return value is number of iterations taken *
       fflush(stdout);
     }
 #endif
+    PERF_END("ks_multicg", nflop*sites_on_node*iteration, 0);
     return (iteration);
   }
     
   iteration++ ;  /* iteration counts number of multiplications
 		    by M_adjoint*M */
   total_iters++;
-  rsqstop = rsqmin * source_norm;
+  for(j=0;j<num_offsets;j++)
+    rsqstop[j] = qic[j].resid * qic[j].resid * source_norm;
 #ifdef CG_DEBUG
   node0_printf("%s: source_norm = %e\n", myname, (double)source_norm);
 #endif
@@ -292,7 +466,13 @@ int ks_multicg_offset_field_cpu( /* Return value is number of iterations taken *
     oldrsq = rsq;
     /* sum of neighbors */
     
-#ifdef FN
+#if defined(FN) && defined(KS_MULTICG_HALF)
+    dslash_fn_field_half( h_p, h_t, NULL, l_otherparity, tags2,
+			  1-special_started, fn );
+    dslash_fn_field_half( h_t, NULL, ttt, l_parity, tags1,
+			  1-special_started, fn );
+    special_started = 1;
+#elif defined(FN)
     if(special_started==0){
       dslash_fn_field_special( cg_p, ttt, l_otherparity, tags2, 
 			       1, fn );
@@ -324,7 +504,8 @@ int ks_multicg_offset_field_cpu( /* Return value is number of iterations taken *
     beta_i[j_low] = -rsq / pkp;
     
     zeta_ip1[j_low] = 1.0; // this doesn't change (j_low vector is ordinary one mass CG)
-    for(j=0;j<num_offsets_now;j++) if(j!=j_low){
+    for(a=0;a<num_active;a++){
+	j = active[a];
 	zeta_ip1[j] = zeta_i[j] * zeta_im1[j] * beta_im1[j_low];
 	c1 = beta_i[j_low] * alpha[j_low] * (zeta_im1[j]-zeta_i[j]);
 	c2 = zeta_im1[j] * beta_im1[j_low] * (1.0+shifts[j]*beta_i[j_low]);
@@ -345,21 +526,36 @@ int ks_multicg_offset_field_cpu( /* Return value is number of iterations taken *
 	  zeta_ip1[j] = 0.0;
 	  beta_i[j] = 0.0;
 	  finished[j] = 1;
-	  //node0_printf("SETTING A ZERO, j=%d, num_offsets_now=%d\n",j,num_offsets_now);
-	  //if(j==num_offsets_now-1)node0_printf("REDUCING OFFSETS\n");
-	  if(j==num_offsets_now-1 && j>j_low) num_offsets_now--;
-	  // don't work any more on finished solutions
-	  // this only works if largest offsets are last, otherwise
-	  // just wastes time multiplying by zero
+	}
+	// don't work any more on finished solutions
+	if(finished[j]){
+	  num_finished++;
+	  active[a--] = active[--num_active];
 	}
       }
     
     /* dest <- dest + beta*cg_p ( cg_p = pm[j_low], dest = psim[j_low] ) */
     rsq = 0.0;
-    FORSOMEFIELDPARITY_OMP(i,l_parity,private(j) reduction(+:rsq) ){
-      for(j=0;j<num_offsets_now;j++) {
+    FORSOMEFIELDPARITY_OMP(i,l_parity,private(a,j) reduction(+:rsq) ){
+#ifdef KS_MULTICG_HALF
+      su3_vector tvec;
+      if(!finished[j_low])
+	scalar_mult_add_su3_vector( psim[j_low]+i, pm[j_low]+i, (Real)beta_i[j_low],
+				    psim[j_low]+i);
+      for(a=0;a<num_active;a++){
+	j = active[a];
+	half_to_su3vec( pmh[j]+i, &tvec );
+	scalar_mult_add_su3_vector( psim[j]+i, &tvec, (Real)beta_i[j], psim[j]+i);
+      }
+#else
+      if(!finished[j_low])
+	scalar_mult_add_su3_vector( psim[j_low]+i, pm[j_low]+i, (Real)beta_i[j_low],
+				    psim[j_low]+i);
+      for(a=0;a<num_active;a++){
+	j = active[a];
 	scalar_mult_add_su3_vector( psim[j]+i, pm[j]+i, (Real)beta_i[j], psim[j]+i);
       }
+#endif
 
       /* resid <- resid + beta*ttt */
       scalar_mult_add_su3_vector( resid+i, ttt+i, (Real)beta_i[j_low], resid+i);
@@ -367,18 +563,34 @@ int ks_multicg_offset_field_cpu( /* Return value is number of iterations taken *
     } END_LOOP_OMP;
     g_doublesum(&rsq);
     
-    if(relrsqmin > 0){
-      relrsq = 0.;
-      for(j=0;j<num_offsets_now;j++) {
-	double r = qic[j].final_relrsq = my_relative_residue(resid, psim[j], parity);
-	if(r > relrsq)relrsq = r;  /* relrsq is the max of the relative residuals */
+    /* The residual for offset j is zeta[j] times resid.  a = -1 is
+       j_low, which stays out of active[]. */
+    for(a=-1;a<num_active;a++){
+      j = a < 0 ? j_low : active[a];
+      if(!finished[j]){
+	double rsqj = zeta_ip1[j]*zeta_ip1[j]*rsq;
+	Real relrsqmin = qic[j].relresid * qic[j].relresid;
+	if(relrsqmin > 0)
+	  qic[j].final_relrsq = my_relative_residue(resid, psim[j], parity);
+	if( (rsqstop[j] > 0 && rsqj <= rsqstop[j]) ||
+	    (relrsqmin > 0 && qic[j].final_relrsq <= relrsqmin) ){
+	  /* Converged: no further updates of psim[j] and pm[j] */
+	  finished[j] = 1;
+	  num_finished++;
+	  qic[j].final_rsq     = (Real)rsqj/source_norm;
+	  qic[j].size_r        = qic[j].final_rsq;
+	  qic[j].size_relr     = qic[j].final_relrsq;
+	  qic[j].final_iters   = iteration;
+	  if(a >= 0)active[a--] = active[--num_active];
+	}
       }
     }
 
 #if CG_DEBUG
-    node0_printf("%s: iter %d rsq = %g, relrsq = %g\n", myname, iteration, rsq, relrsq);
+    node0_printf("%s: iter %d rsq = %g, %d of %d offsets converged\n", myname,
+		 iteration, rsq, num_finished, num_offsets);
 #endif
-    if( (rsqstop > 0 && rsq <= rsqstop) || (relrsqmin > 0 && relrsq <= relrsqmin) ){
+    if( num_finished == num_offsets ){
       /* if parity==EVENANDODD, set up to do odd sites and go back */
       if(parity == EVENANDODD) {
 	l_parity=ODD; l_otherparity=EVEN;
@@ -386,17 +598,15 @@ int ks_multicg_offset_field_cpu( /* Return value is number of iterations taken *
 	iteration = 0;
 	goto start;
       }
-      for(j = 0; j < num_offsets; j++){
-	qic[j].final_rsq     = (Real)rsq/source_norm;
-	qic[j].size_r        = qic[j].final_rsq;
-	qic[j].size_relr     = qic[j].final_relrsq;
-	qic[j].final_iters   = iteration;
-      }
       
       
 #ifdef FN
       if(special_started==1) {
+#ifdef KS_MULTICG_HALF
+	cleanup_gathers_half(tags1,tags2);
+#else
 	cleanup_gathers(tags1,tags2);
+#endif
 	special_started = 0;
       }
 #endif
@@ -404,6 +614,10 @@ int ks_multicg_offset_field_cpu( /* Return value is number of iterations taken *
       /* Free stuff */
       for(j=0;j<num_offsets;j++) free(pm[j]); 
       free(pm);
+#ifdef KS_MULTICG_HALF
+      for(j=0;j<num_offsets;j++) free(pmh[j]);
+      free(pmh); free(h_p); free(h_t);
+#endif
       
       free(zeta_i);
       free(zeta_ip1);
@@ -413,6 +627,8 @@ int ks_multicg_offset_field_cpu( /* Return value is number of iterations taken *
       free(alpha);
       free(shifts);
       free(finished);
+      free(active);
+      free(rsqstop);
       
 #ifdef CGTIME
       dtimec += dclock();
@@ -423,12 +639,14 @@ int ks_multicg_offset_field_cpu( /* Return value is number of iterations taken *
 	       iteration/(1.0e6*dtimec*numnodes()));
 	fflush(stdout);}
 #endif
+      PERF_END("ks_multicg", nflop*sites_on_node*iteration, 0);
       return (iteration);
     }
     
     alpha[j_low] = rsq / oldrsq;
     
-    for(j=0;j<num_offsets_now;j++) if(j!=j_low){
+    for(a=0;a<num_active;a++){
+	j = active[a];
 	/*THISBLOWSUP
 	  alpha[j] = alpha[j_low] * zeta_ip1[j] * beta_i[j] /
 	  (zeta_i[j] * beta_i[j_low]);
@@ -440,20 +658,39 @@ int ks_multicg_offset_field_cpu( /* Return value is number of iterations taken *
 	else {
 	  alpha[j] = 0.0;
 	  finished[j] = 1;
+	  num_finished++;
+	  active[a--] = active[--num_active];
 	}
       }
     
-    /* cg_p  <- resid + alpha*cg_p */
-    FORSOMEFIELDPARITY_OMP(i,l_parity,private(j) ){
-      for(j=0;j<num_offsets_now;j++) {
+    /* cg_p  <- resid + alpha*cg_p  (zeta_ip1[j_low] = 1) */
+    FORSOMEFIELDPARITY_OMP(i,l_parity,private(a,j) ){
+#ifdef KS_MULTICG_HALF
+      su3_vector tvec;
+      scalar_mult_add_su3_vector( resid+i, pm[j_low]+i, (Real)alpha[j_low], pm[j_low]+i);
+      for(a=0;a<num_active;a++){
+	j = active[a];
+	scalar_mult_su3_vector( resid+i, (Real)zeta_ip1[j], ttt+i);
+	half_to_su3vec( pmh[j]+i, &tvec );
+	scalar_mult_add_su3_vector( ttt+i, &tvec, (Real)alpha[j], &tvec);
+	su3vec_to_half( &tvec, pmh[j]+i );
+      }
+      su3vec_copy(pm[j_low]+i,cg_p+i);
+      su3vec_to_half(cg_p+i, h_p+i);
+#else
+      scalar_mult_add_su3_vector( resid+i, pm[j_low]+i, (Real)alpha[j_low], pm[j_low]+i);
+      for(a=0;a<num_active;a++){
+	j = active[a];
 	scalar_mult_su3_vector( resid+i, (Real)zeta_ip1[j], ttt+i);
 	scalar_mult_add_su3_vector( ttt+i, pm[j]+i, (Real)alpha[j], pm[j]+i);
       }
       su3vec_copy(pm[j_low]+i,cg_p+i);
+#endif
     } END_LOOP_OMP;
     
     /* scroll the scalars */
-    for(j=0;j<num_offsets_now;j++){
+    for(a=-1;a<num_active;a++){
+      j = a < 0 ? j_low : active[a];
       beta_im1[j] = beta_i[j];
       zeta_im1[j] = zeta_i[j];
       zeta_i[j] = zeta_ip1[j];
@@ -461,8 +698,8 @@ int ks_multicg_offset_field_cpu( /* Return value is number of iterations taken *
     
   } while( iteration < niter );
   
-  for(j = 0; j < num_offsets; j++){
-    qic[j].final_rsq     = (Real)rsq/source_norm;
+  for(j = 0; j < num_offsets; j++) if(!finished[j]){
+    qic[j].final_rsq     = (Real)(zeta_i[j]*zeta_i[j]*rsq/source_norm);
     qic[j].size_r        = qic[j].final_rsq;
     qic[j].final_iters   = iteration;
     qic[j].converged     = 0;
@@ -483,7 +720,11 @@ int ks_multicg_offset_field_cpu( /* Return value is number of iterations taken *
   
 #ifdef FN
   if(special_started==1){	/* clean up gathers */
+#ifdef KS_MULTICG_HALF
+    cleanup_gathers_half(tags1, tags2);
+#else
     cleanup_gathers(tags1, tags2);
+#endif
     special_started = 0;
   }
 #endif
@@ -491,6 +732,10 @@ int ks_multicg_offset_field_cpu( /* Return value is number of iterations taken *
   /* Free stuff */
   for(j=0;j<num_offsets;j++){ free(pm[j]); }
   free(pm);
+#ifdef KS_MULTICG_HALF
+  for(j=0;j<num_offsets;j++) free(pmh[j]);
+  free(pmh); free(h_p); free(h_t);
+#endif
 
   free(zeta_i);
   free(zeta_ip1);
@@ -500,6 +745,9 @@ int ks_multicg_offset_field_cpu( /* Return value is number of iterations taken *
   free(alpha);
   free(shifts);
   free(finished);
+  free(active);
+  free(rsqstop);
   
+  PERF_END("ks_multicg", nflop*sites_on_node*iteration, 0);
   return(iteration);
 }
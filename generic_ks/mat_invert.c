@@ -190,6 +190,14 @@ int mat_invert_cg_field(su3_vector *src, su3_vector *dst,
     su3_vector *tmp;
     double dtime;
 
+#ifdef KS_MG_MILC
+    if(qic->inv_type == MGTYPE){
+      cgn = mat_invert_mg_field( src, dst, qic, mass, fn );
+      report_status(qic);
+      return cgn;
+    }
+#endif
+
     tmp = (su3_vector *)malloc(sites_on_node * sizeof(su3_vector));
     if(tmp==NULL){
       printf("mat_invert_cg_field(%d): no room for tmp\n",this_node);
@@ -265,6 +273,7 @@ int mat_invert_cg( field_offset src, field_offset dest, field_offset temp,
     qic.min        = 0;
     qic.max        = niter;
     qic.nrestart   = nrestart;
+    qic.inv_type   = CGTYPE;
     qic.parity     = EVENANDODD;
     qic.nsrc = 1;
     qic.resid      = sqrt(rsqprop);
@@ -331,11 +340,21 @@ int mat_invert_uml_field(su3_vector *src, su3_vector *dst,
     int cgn;
     register int i;
     register site *s;
-    su3_vector *tmp = create_v_field();
-    su3_vector *ttt = create_v_field();
+    su3_vector *tmp, *ttt;
     int even_iters;
     double dtime;
 
+#ifdef KS_MG_MILC
+    if(qic->inv_type == MGTYPE){
+      cgn = mat_invert_mg_field( src, dst, qic, mass, fn );
+      report_status(qic);
+      return cgn;
+    }
+#endif
+
+    tmp = create_v_field();
+    ttt = create_v_field();
+
     /* "Precondition" both even and odd sites */
     /* temp <- M_adj * src */
 
@@ -504,6 +523,7 @@ int mat_invert_uml(field_offset src, field_offset dest, field_offset temp,
     qic.min        = 0;
     qic.max        = niter;
     qic.nrestart   = nrestart;
+    qic.inv_type   = CGTYPE;
     qic.nsrc       = 1;
     qic.resid      = sqrt(rsqprop);
     qic.relresid   = 0;
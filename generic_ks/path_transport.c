@@ -69,7 +69,7 @@ void path_transport_field( su3_vector *src, su3_vector *dest, int parity,
 	        dir[j], tmp_parity, gen_pt[0] );
 	    wait_gather(mtag0);
 	    FORSOMEPARITY_OMP(i,s,tmp_parity,){
-		mult_su3_mat_vec( &(s->link[dir[j]]),
+		mult_su3_mat_vec( &(SITE_LINK(i)[dir[j]]),
 		    (su3_vector *)(gen_pt[0][i]),
 		    &(tmp_dest[i]) );
 	    } END_LOOP_OMP;
@@ -78,7 +78,7 @@ void path_transport_field( su3_vector *src, su3_vector *dest, int parity,
 
 	else{ /* GOES_BACKWARDS(dir[j]) */
 	  FORSOMEPARITY_OMP(i,s,tmp_otherparity,){
-		mult_adj_su3_mat_vec( &(s->link[OPP_DIR(dir[j])]),
+		mult_adj_su3_mat_vec( &(SITE_LINK(i)[OPP_DIR(dir[j])]),
 		    &(tmp_src[i]), &(tmp_work[i]) );
 	    } END_LOOP_OMP;
 	    mtag0 = start_gather_field( tmp_work, sizeof(su3_vector),
@@ -165,7 +165,7 @@ void path_transport_connection( su3_matrix *src, su3_matrix *dest, int parity,
 	        dir[j], tmp_parity, gen_pt[0] );
 	    wait_gather(mtag0);
 	    FORSOMEPARITY_OMP(i,s,tmp_parity,){
-		mult_su3_nn( &(s->link[dir[j]]),
+		mult_su3_nn( &(SITE_LINK(i)[dir[j]]),
 		    (su3_matrix *)(gen_pt[0][i]),
 		    &(tmp_dest[i]) );
 	    } END_LOOP_OMP;
@@ -174,7 +174,7 @@ void path_transport_connection( su3_matrix *src, su3_matrix *dest, int parity,
 
 	else{ /* GOES_BACKWARDS(dir[j]) */
 	  FORSOMEPARITY_OMP(i,s,tmp_otherparity,){
-		mult_su3_an( &(s->link[OPP_DIR(dir[j])]),
+		mult_su3_an( &(SITE_LINK(i)[OPP_DIR(dir[j])]),
 		    &(tmp_src[i]), &(tmp_work[i]) );
 	    } END_LOOP_OMP;
 	    mtag0 = start_gather_field( tmp_work, sizeof(su3_matrix),
@@ -297,7 +297,7 @@ void link_transport_connection( su3_matrix *src, su3_matrix *dest,
 	    dir, EVENANDODD, gen_pt[0] );
 	wait_gather(mtag0);
 	FORALLSITES_OMP(i,s,){
-	    mult_su3_nn( &(s->link[dir]), (su3_matrix *)(gen_pt[0][i]),
+	    mult_su3_nn( &(SITE_LINK(i)[dir]), (su3_matrix *)(gen_pt[0][i]),
 		&(dest[i]) );
 	} END_LOOP_OMP;
 	cleanup_gather(mtag0);
@@ -305,7 +305,7 @@ void link_transport_connection( su3_matrix *src, su3_matrix *dest,
 
     else{ /* GOES_BACKWARDS(dir) */
       FORALLSITES_OMP(i,s,){
-	    mult_su3_an( &(s->link[OPP_DIR(dir)]),
+	    mult_su3_an( &(SITE_LINK(i)[OPP_DIR(dir)]),
 		&(src[i]), &(work[i]) );
       } END_LOOP_OMP;
       mtag0 = start_gather_field( work, sizeof(su3_matrix),
@@ -421,7 +421,7 @@ void path_transport_hwv_field( half_wilson_vector *src, half_wilson_vector * des
 		sizeof(half_wilson_vector), dir[j], tmp_parity, gen_pt[0] );
 	    wait_gather(mtag0);
 	    FORSOMEPARITY_OMP(i,s,tmp_parity,){
-		mult_su3_mat_hwvec( &(s->link[dir[j]]),
+		mult_su3_mat_hwvec( &(SITE_LINK(i)[dir[j]]),
 		    (half_wilson_vector *)(gen_pt[0][i]),
 		    &(tmp_dest[i]) );
 	    } END_LOOP_OMP;
@@ -430,7 +430,7 @@ void path_transport_hwv_field( half_wilson_vector *src, half_wilson_vector * des
 
 	else{ /* GOES_BACKWARDS(dir[j]) */
 	  FORSOMEPARITY_OMP(i,s,tmp_otherparity,){
-		mult_adj_su3_mat_hwvec( &(s->link[OPP_DIR(dir[j])]),
+		mult_adj_su3_mat_hwvec( &(SITE_LINK(i)[OPP_DIR(dir[j])]),
 		    &(tmp_src[i]), &(tmp_work[i]) );
 	    } END_LOOP_OMP;
 	    mtag0 = start_gather_field( tmp_work,
@@ -512,7 +512,7 @@ void path_transport( field_offset src, field_offset dest, int parity,
 	        dir[j], tmp_parity, gen_pt[0] );
 	    wait_gather(mtag0);
 	    FORSOMEPARITY_OMP(i,s,tmp_parity,){
-		mult_su3_mat_vec( &(s->link[dir[j]]),
+		mult_su3_mat_vec( &(SITE_LINK(i)[dir[j]]),
 		    (su3_vector *)(gen_pt[0][i]),
 		    &(tmp_dest[i]) );
 	    } END_LOOP_OMP;
@@ -521,7 +521,7 @@ void path_transport( field_offset src, field_offset dest, int parity,
 
 	else{ /* GOES_BACKWARDS(dir[j]) */
 	  FORSOMEPARITY_OMP(i,s,tmp_otherparity,){
-		mult_adj_su3_mat_vec( &(s->link[OPP_DIR(dir[j])]),
+		mult_adj_su3_mat_vec( &(SITE_LINK(i)[OPP_DIR(dir[j])]),
 		    &(tmp_src[i]), &(tmp_work[i]) );
 	    } END_LOOP_OMP;
 	    mtag0 = start_gather_field( tmp_work, sizeof(su3_vector),
@@ -600,7 +600,7 @@ void path_transport_hwv( field_offset src, field_offset dest, int parity,
 		sizeof(half_wilson_vector), dir[j], tmp_parity, gen_pt[0] );
 	    wait_gather(mtag0);
 	    FORSOMEPARITY_OMP(i,s,tmp_parity,){
-		mult_su3_mat_hwvec( &(s->link[dir[j]]),
+		mult_su3_mat_hwvec( &(SITE_LINK(i)[dir[j]]),
 		    (half_wilson_vector *)(gen_pt[0][i]),
 		    &(tmp_dest[i]) );
 	    } END_LOOP_OMP;
@@ -609,7 +609,7 @@ void path_transport_hwv( field_offset src, field_offset dest, int parity,
 
 	else{ /* GOES_BACKWARDS(dir[j]) */
 	  FORSOMEPARITY_OMP(i,s,tmp_otherparity,){
-		mult_adj_su3_mat_hwvec( &(s->link[OPP_DIR(dir[j])]),
+		mult_adj_su3_mat_hwvec( &(SITE_LINK(i)[OPP_DIR(dir[j])]),
 		    &(tmp_src[i]), &(tmp_work[i]) );
 	    } END_LOOP_OMP;
 	    mtag0 = start_gather_field( tmp_work,
@@ -692,7 +692,7 @@ void path_transport_site( field_offset src, field_offset dest, int parity,
 	        dir[j], tmp_parity, gen_pt[0] );
 	    wait_gather(mtag0);
 	    FORSOMEPARITY_OMP(i,s,tmp_parity,){
-		mult_su3_mat_vec( &(s->link[dir[j]]),
+		mult_su3_mat_vec( &(SITE_LINK(i)[dir[j]]),
 		    (su3_vector *)(gen_pt[0][i]),
 		    &(tmp_dest[i]) );
 	    } END_LOOP_OMP;
@@ -701,7 +701,7 @@ void path_transport_site( field_offset src, field_offset dest, int parity,
 
 	else{ /* GOES_BACKWARDS(dir[j]) */
 	  FORSOMEPARITY_OMP(i,s,tmp_otherparity,){
-		mult_adj_su3_mat_vec( &(s->link[OPP_DIR(dir[j])]),
+		mult_adj_su3_mat_vec( &(SITE_LINK(i)[OPP_DIR(dir[j])]),
 		    &(tmp_src[i]), &(tmp_work[i]) );
 	    } END_LOOP_OMP;
 	    mtag0 = start_gather_field( tmp_work, sizeof(su3_vector),
@@ -780,7 +780,7 @@ void path_transport_hwv_site( field_offset src, field_offset dest, int parity,
 		sizeof(half_wilson_vector), dir[j], tmp_parity, gen_pt[0] );
 	    wait_gather(mtag0);
 	    FORSOMEPARITY_OMP(i,s,tmp_parity,){
-		mult_su3_mat_hwvec( &(s->link[dir[j]]),
+		mult_su3_mat_hwvec( &(SITE_LINK(i)[dir[j]]),
 		    (half_wilson_vector *)(gen_pt[0][i]),
 		    &(tmp_dest[i]) );
 	    } END_LOOP_OMP;
@@ -789,7 +789,7 @@ void path_transport_hwv_site( field_offset src, field_offset dest, int parity,
 
 	else{ /* GOES_BACKWARDS(dir[j]) */
 	  FORSOMEPARITY_OMP(i,s,tmp_otherparity,){
-		mult_adj_su3_mat_hwvec( &(s->link[OPP_DIR(dir[j])]),
+		mult_adj_su3_mat_hwvec( &(SITE_LINK(i)[OPP_DIR(dir[j])]),
 		    &(tmp_src[i]), &(tmp_work[i]) );
 	    } END_LOOP_OMP;
 	    mtag0 = start_gather_field( tmp_work,
@@ -131,8 +131,8 @@ void rephase( int flag ){
     for(dir=XUP;dir<=TUP;dir++){
       for(j=0;j<3;j++)
 	for(k=0;k<3;k++){
-	  lattice[i].link[dir].e[j][k].real *= lattice[i].phase[dir];
-	  lattice[i].link[dir].e[j][k].imag *= lattice[i].phase[dir];
+	  SITE_LINK(i)[dir].e[j][k].real *= lattice[i].phase[dir];
+	  SITE_LINK(i)[dir].e[j][k].imag *= lattice[i].phase[dir];
 	}
     }
   } END_LOOP_OMP;
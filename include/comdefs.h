@@ -42,6 +42,10 @@
 /* actual structure defined in individual com_*.c files */
 typedef struct msg_tag msg_tag;
 
+/* sum_tag structure used for nonblocking global sums */
+/* actual structure defined in individual com_*.c files */
+typedef struct sum_tag sum_tag;
+
 /**********************************************************************/
 /* Declarations for all exported routines in the com_*.c files */
 
@@ -53,6 +57,7 @@ char *machine_type(void);
 void *mycomm(void);
 int mynode(void);
 int numnodes(void);
+int pes_per_node(void);
 int myjobid(void);
 int numjobs(void);
 int const *nodegeom(void);
@@ -65,6 +70,8 @@ void g_floatsum(Real *fpt);
 void g_vecfloatsum(Real *fpt, int nReals);
 void g_doublesum(double *dpt);
 void g_vecdoublesum(double *dpt, int ndoubles);
+sum_tag *start_g_vecdoublesum(double *dpt, int ndoubles);
+void wait_g_vecdoublesum(sum_tag *stag);
 void g_longdoublesum(long double *dpt);
 void g_veclongdoublesum(long double *dpt, int count);
 void g_complexsum(complex *cpt);
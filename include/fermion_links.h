@@ -190,6 +190,7 @@ const char *ks_multiff_opt_chr( void );
 
 void eo_fermion_force_multi( Real eps, Real *residues, su3_vector **xxx, 
 			     int nterms, int prec, fermion_links_t *fn);
+double eo_fermion_force_multi_flops( void ); /* HISQ only */
 void fermion_force_fn_multi( Real eps, Real *residues, su3_vector **multi_x, 
 			     int nterms, int prec, fermion_links_t *fn);
 void fermion_force_fn_multi_reverse( Real eps, Real *residues, 
@@ -43,6 +43,7 @@
 	 su3_matrix *W_unitlink; 
        fn_links_t *fn[MAX_NAIK]
        fn_links_t *fn_deps
+       int stale, gauge_version, V_version, W_version, X_version
 
        (Here fn_links_t is the only option.)
 
@@ -74,6 +75,11 @@ typedef struct {
   hisq_auxiliary_t *aux;          // Intermediate links needed for fermion force
   imp_ferm_links_t *fn[MAX_NAIK]; // Table of links depending on epsilon
   imp_ferm_links_t *fn_deps;      // Derivative of links wrto epsilon.
+  int stale;                      // Gauge links may have changed since the build
+  int gauge_version;              // Advances when the gauge links differ from U_link
+  int V_version;                  // gauge_version V_link was built from
+  int W_version;                  // V_version Y and W were built from
+  int X_version;                  // W_version fn and fn_deps were built from
 } hisq_links_t;
 
 typedef struct {
@@ -134,6 +140,9 @@ void create_hisq_links_milc(info_t *info, fn_links_t **fn, fn_links_t **fn_deps,
 void destroy_hisq_links_milc(ks_action_paths_hisq *ap, hisq_auxiliary_t *aux, 
 			     fn_links_t **fn, fn_links_t *fn_deps);
 
+void refresh_hisq_links_milc(info_t *info, hisq_links_t *hl, su3_matrix *links,
+			     int want_deps, int want_back);
+
 
 //hisq_auxiliary_t *create_hisq_auxiliary_t(ks_action_paths_hisq *ap,
 //					  su3_matrix *links);
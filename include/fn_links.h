@@ -6,6 +6,18 @@
 #include "../include/precision.h"
 #include "../include/su3.h"
 #include "../include/link_phase_info.h"
+#ifdef D_FN_SOA
+#ifndef DBLSTORE_FN
+#error D_FN_SOA requires DBLSTORE_FN
+#endif
+#include "../include/su3_soa.h"
+#endif
+#include "../include/su3_half.h"
+
+#if defined(MULTIGRID) && ! defined(HAVE_QOP)
+#define KS_MG_MILC
+struct ks_mg_struct;
+#endif
 
 /* The fn_links_t "class" */
 
@@ -15,6 +27,27 @@ typedef struct {
   su3_matrix *lng;
   su3_matrix *fatback;  // NULL if unused
   su3_matrix *lngback;  // NULL if unused
+#ifdef D_FN_SOA
+  su3_matrix_soa *fat_soa;      // SIMD copies, built on first use and
+  su3_matrix_soa *lng_soa;      // kept until the links change
+  su3_matrix_soa *fatback_soa;
+  su3_matrix_soa *lngback_soa;
+#endif
+#ifdef KS_CG_MIXED
+  fsu3_matrix *fat_F;           // single precision copies, built on demand
+  fsu3_matrix *lng_F;           // NULL if not built or invalidated
+  fsu3_matrix *fatback_F;
+  fsu3_matrix *lngback_F;
+#endif
+#ifdef KS_MULTICG_HALF
+  hsu3_matrix *fat_H;           // 16-bit copies, built on demand
+  hsu3_matrix *lng_H;           // NULL if not built or invalidated
+  hsu3_matrix *fatback_H;
+  hsu3_matrix *lngback_H;
+#endif
+#ifdef KS_MG_MILC
+  struct ks_mg_struct *mg;      // multigrid setup, NULL if not built
+#endif
   double eps_naik;
   int notify_quda_new_links;
 } fn_links_t;
@@ -25,6 +58,35 @@ su3_matrix *create_fatlinks(void);
 void destroy_fatlinks(su3_matrix *fat);
 void load_fn_backlinks(fn_links_t *fn);
 void destroy_fn_backlinks(fn_links_t *fn);
+void invalidate_fn_link_copies(fn_links_t *fn);
+#ifdef D_FN_SOA
+int soa_first_block(int parity);
+int soa_end_block(int parity);
+void soa_block_sites(int b, int *i0, int *n);
+void load_fn_soa_links(fn_links_t *fn);
+su3_matrix_soa *get_fatlinks_soa(fn_links_t *fn);
+su3_matrix_soa *get_lnglinks_soa(fn_links_t *fn);
+su3_matrix_soa *get_fatbacklinks_soa(fn_links_t *fn);
+su3_matrix_soa *get_lngbacklinks_soa(fn_links_t *fn);
+#endif
+#ifdef KS_CG_MIXED
+void load_fn_F_links(fn_links_t *fn);
+fsu3_matrix *get_F_fatlinks(fn_links_t *fn);
+fsu3_matrix *get_F_lnglinks(fn_links_t *fn);
+fsu3_matrix *get_F_fatbacklinks(fn_links_t *fn);
+fsu3_matrix *get_F_lngbacklinks(fn_links_t *fn);
+#endif
+#ifdef KS_MULTICG_HALF
+void load_fn_H_links(fn_links_t *fn);
+hsu3_matrix *get_H_fatlinks(fn_links_t *fn);
+hsu3_matrix *get_H_lnglinks(fn_links_t *fn);
+hsu3_matrix *get_H_fatbacklinks(fn_links_t *fn);
+hsu3_matrix *get_H_lngbacklinks(fn_links_t *fn);
+#endif
+#ifdef KS_MG_MILC
+void invalidate_fn_mg(fn_links_t *fn);
+void destroy_fn_mg(fn_links_t *fn);
+#endif
 
 fn_links_t *create_fn_links(void);
 void destroy_fn_links(fn_links_t *fn);
@@ -20,6 +20,7 @@
 #include "../include/complex.h"
 #include "../include/su3.h"
 #include "../include/macros.h"
+#include "../include/comdefs.h"
 #include "../include/random.h"
 #include "../include/file_types.h"
 #include "../include/io_lat.h"
@@ -153,6 +154,23 @@ void shift_wilson_vector(wilson_vector *src, int rshift[]);
 double start_timing(void);
 void print_timing(double dtime, char *str);
 
+/* Subsystems charged for memory under -DMEM_ACCOUNT */
+enum mem_tag_type { MEM_FIELDS = 0, MEM_LATTICE, MEM_LINKS, MEM_EIGEN,
+		    MEM_PROPS, MEM_GATHERS, MEM_NTAGS };
+
+void *field_alloc(size_t bytes);
+void *field_alloc_tag(size_t bytes, int tag);
+void field_free(void *p);
+void report_field_pool(void);
+void free_field_pool(void);
+int set_mem_tag(int tag);
+#ifdef MEM_ACCOUNT
+void mem_account(int tag, double bytes);
+void report_mem_account(void);
+#else
+#define mem_account(tag, bytes)
+#endif
+
 Real* create_r_field(void);
 void clear_r_field(Real *r);
 void copy_r_field(Real *dest, Real *src);
@@ -202,6 +220,11 @@ void clear_c_array_field(complex *c, int n);
 void copy_c_array_field(complex *dest, complex *src, int n);
 void destroy_c_array_field(complex *c, int n);
 
+anti_hermitmat *create_ah_array_field(int n);
+void clear_ah_array_field(anti_hermitmat *ah, int n);
+void copy_ah_array_field(anti_hermitmat *dest, anti_hermitmat *src, int n);
+void destroy_ah_array_field(anti_hermitmat *ah, int n);
+
 su3_matrix *create_m_array_field(int n);
 void clear_m_array_field(su3_matrix *m, int n);
 void copy_m_array_field(su3_matrix *dest, su3_matrix *src, int n);
@@ -217,6 +240,13 @@ void clear_wv_array_field(wilson_vector *wv, int n);
 void copy_wv_array_field(wilson_vector *dst, wilson_vector *src, int n);
 void destroy_wv_array_field(wilson_vector *wv, int n);
 
+void *create_site_field(char *name, size_t bytes, int tag);
+void destroy_site_field(void *field);
+void *find_site_field(char *name);
+void report_site_fields(void);
+msg_tag *start_gather_strided(void *field, size_t stride, size_t size,
+			      int index, int parity, char **dest);
+
 su3_vector *create_v_array_field(int n);
 void clear_v_array_field(su3_vector *v, int n);
 void copy_v_array_field(su3_vector *dst, su3_vector *src, int n);
@@ -297,6 +327,7 @@ void gaugefix_combo(int gauge_dir,Real relax_boost,int max_gauge_iter,
 
 /* gauge_force_imp_*.c */
 void imp_gauge_force_cpu( Real eps, field_offset mom_off );
+void imp_gauge_force_cpu_field( Real eps, anti_hermitmat *mom );
 void imp_gauge_force_gpu( Real eps, field_offset mom_off );
 void imp_gauge_force( Real eps, field_offset mom_off );
 
@@ -323,6 +354,8 @@ Real **get_loop_coeff(void);
 /* gauge_utilities.c */
 su3_matrix * create_G(void);
 su3_matrix * create_G_from_site(void);
+void copy_site_to_G(su3_matrix *t_links);
+void copy_G_to_site(su3_matrix *t_links);
 void copy_G(su3_matrix *dst, su3_matrix *src);
 void destroy_G(su3_matrix *t_links);
 su3_matrix * create_G2(void);
@@ -416,6 +449,18 @@ void path_product_fields( su3_matrix *Src, const int *dir,
 void path_prod_subl(const int *dir, const int length, const int subl,
 		    su3_matrix *tempmat1);
 
+/* perf_regions.c */
+#ifdef PERF_REGIONS
+void perf_begin(const char *name);
+void perf_end(const char *name, double flops, double bytes);
+void report_perf_regions(void);
+#define PERF_BEGIN(name) perf_begin(name)
+#define PERF_END(name, flops, bytes) perf_end(name, flops, bytes)
+#else
+#define PERF_BEGIN(name)
+#define PERF_END(name, flops, bytes)
+#endif
+
 /* phases.c */
 int decode_phase(char *label);
 void mult_c_by_phase(complex *a, complex *b, int ph);
@@ -32,6 +32,11 @@ int fill_charge(double charge_table[], int *n, double next_charge);
 int index_charge(double charge_table[], int n, double find_charge);
 void start_charge(double charge_table[], int *n);
 
+/* d_congrad5_fn_milc.c */
+double ks_relative_residue_sum(su3_vector *p, su3_vector *q, int parity);
+Real ks_relative_residue_norm(double residue, int parity);
+Real ks_relative_residue(su3_vector *p, su3_vector *q, int parity);
+
 /* d_congrad_opt.c */
 
 void clear_latvec(field_offset v,int parity);
@@ -64,7 +69,7 @@ void scalar_mult_add_latveclist( veclist *dest,
             veclist *src, Real *s, int listlength );
 
 /* gauge_force_imp_ks.c */
-void imp_gauge_force_ks( Real eps, field_offset mom_off );
+void imp_gauge_force_ks( Real eps );
 
 /* gauss_smear_ks.c */
 void gauss_smear_v_field(su3_vector *src, su3_matrix *t_links,
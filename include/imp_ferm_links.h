@@ -69,6 +69,16 @@ int ks_congrad_parity_cpu( su3_vector *t_src, su3_vector *t_dest,
 			   quark_invert_control *qic, Real mass,
 			   imp_ferm_links_t *fn);
 
+/* d_congrad5_fn_mixed_milc.c */
+int ks_congrad_parity_mixed_cpu( su3_vector *t_src, su3_vector *t_dest,
+				 quark_invert_control *qic, Real mass,
+				 imp_ferm_links_t *fn);
+
+/* d_congrad5_fn_pipe_milc.c */
+int ks_congrad_parity_pipe_cpu( su3_vector *t_src, su3_vector *t_dest,
+				quark_invert_control *qic, Real mass,
+				imp_ferm_links_t *fn);
+
 
 #ifdef USE_CG_GPU
 
@@ -132,6 +142,8 @@ void dslash_fn_field( su3_vector *src, su3_vector *dest, int parity,
 void dslash_fn_field_special(su3_vector *src, su3_vector *dest,
 			     int parity, msg_tag **tag, int start,
 			     imp_ferm_links_t *fn);
+void dslash_fn_field_multi(su3_vector **src, su3_vector **dest, int nrhs,
+			   int parity, imp_ferm_links_t *fn);
 void ddslash_fn_du0_field( su3_vector *src, su3_vector *dest, int parity,
 			   imp_ferm_links_t *fn, imp_ferm_links_t *fn_dmdu0);
 
@@ -481,6 +493,13 @@ void check_invert_field( su3_vector *src, su3_vector *dest, Real mass,
 void check_invert_field2( su3_vector *src, su3_vector *dest, Real mass,
 			  Real tol, imp_ferm_links_t *fn, int parity);
 
+/* ks_mg_milc.c */
+#ifdef KS_MG_MILC
+int mat_invert_mg_field(su3_vector *src, su3_vector *dst,
+			quark_invert_control *qic, Real mass,
+			imp_ferm_links_t *fn);
+#endif
+
 /* multimass_inverter.c */
 #define MAX_MMINV_NMASSES 32
 #define MAX_MMINV_SOURCES 16
@@ -46,6 +46,43 @@ typedef int field_offset;
   ((field_offset)(((char *)&(lattice[0]. a ))-((char *)&(lattice[0])) ))
 #define F_PT( site , fo )  ((char *)( site ) + (fo)) 
 
+/* ---------------------------------------------------------- */
+/* Site fields: members kept outside the site structure */
+
+/* An application may keep a member of its site structure in a site
+   field instead, made by create_site_field() (field_utilities.c): the
+   same elements per site, in site order.  Loops that stream through
+   the member then touch only its bytes.  Generic code reaches member
+   m of site i through SITE_M(i), which points to the site field or to
+   the site member according to the application's M_FIELD define, and
+   gathers it through the stride SITE_STRIDE(SITE_M) instead of an
+   F_OFFSET.  Defined so far:
+     LINK_FIELD  link_field, four su3_matrix per site, replaces link[4]
+     MOM_FIELD   mom_field, four anti_hermitmat per site, replaces mom[4] */
+
+#define SITE_FIELD(f,n,i) ((f) + (n)*(i))
+#define SITE_STRIDE(acc) ((size_t)((char *)acc(1) - (char *)acc(0)))
+
+/* start_gather_link(dir, ...) starts a gather of the links in
+   direction dir */
+#ifdef LINK_FIELD
+#define SITE_LINK(i) SITE_FIELD(link_field,4,i)
+#define start_gather_link(dir,index,parity,dest) \
+  start_gather_strided(link_field+(dir), SITE_STRIDE(SITE_LINK), \
+		       sizeof(su3_matrix), index, parity, dest)
+#else
+#define SITE_LINK(i) (lattice[i].link)
+#define start_gather_link(dir,index,parity,dest) \
+  start_gather_site(F_OFFSET(link[dir]), sizeof(su3_matrix), \
+		    index, parity, dest)
+#endif
+
+#ifdef MOM_FIELD
+#define SITE_MOM(i) SITE_FIELD(mom_field,4,i)
+#else
+#define SITE_MOM(i) (lattice[i].mom)
+#endif
+
 /* ---------------------------------------------------------- */
 /* Macros for looping over directions */
 
@@ -0,0 +1,113 @@
+#ifndef _SU3_HALF_H
+#define _SU3_HALF_H
+/* MILC version 7 */
+
+/* Compressed 16-bit ("half") storage for color vectors and matrices,
+   used by the multimass CG when compiled with -DKS_MULTICG_HALF.
+
+   Each object keeps its components as 16-bit fixed-point numbers
+   scaled by a single float norm, the largest magnitude among its
+   components.  A component is recovered as c*norm/HALF_SCALE.  The
+   relative precision is about 3e-5 of the largest component, which is
+   adequate for the inner multimass solve when the solutions are
+   polished afterwards in working precision.
+
+   Storage is 16 bytes per su3_vector and 40 bytes per su3_matrix. */
+
+#include <math.h>
+#include "../include/precision.h"
+#include "../include/su3.h"
+
+#define HALF_SCALE 32767.0f
+
+typedef struct {
+  short c[6];      /* re, im of the three colors */
+  float norm;
+} hsu3_vector;
+
+typedef struct {
+  short e[18];     /* re, im, row major */
+  float norm;
+} hsu3_matrix;
+
+/* Round x*scale to the nearest short.  |x*scale| <= HALF_SCALE */
+static inline short
+half_pack( float x, float scale ){
+  return (short)(x*scale + (x >= 0 ? 0.5f : -0.5f));
+}
+
+static inline void
+su3vec_to_half( const su3_vector *a, hsu3_vector *h ){
+  float m = 0., s, t;
+  int j;
+  for(j = 0; j < 3; j++){
+    t = fabs(a->c[j].real); if(t > m)m = t;
+    t = fabs(a->c[j].imag); if(t > m)m = t;
+  }
+  h->norm = m;
+  s = (m > 0.) ? HALF_SCALE/m : 0.;
+  for(j = 0; j < 3; j++){
+    h->c[2*j]   = half_pack(a->c[j].real, s);
+    h->c[2*j+1] = half_pack(a->c[j].imag, s);
+  }
+}
+
+static inline void
+half_to_su3vec( const hsu3_vector *h, su3_vector *a ){
+  Real s = h->norm/HALF_SCALE;
+  int j;
+  for(j = 0; j < 3; j++){
+    a->c[j].real = s*h->c[2*j];
+    a->c[j].imag = s*h->c[2*j+1];
+  }
+}
+
+static inline void
+su3mat_to_half( const su3_matrix *a, hsu3_matrix *h ){
+  float m = 0., s, t;
+  int i, j;
+  for(i = 0; i < 3; i++)for(j = 0; j < 3; j++){
+    t = fabs(a->e[i][j].real); if(t > m)m = t;
+    t = fabs(a->e[i][j].imag); if(t > m)m = t;
+  }
+  h->norm = m;
+  s = (m > 0.) ? HALF_SCALE/m : 0.;
+  for(i = 0; i < 3; i++)for(j = 0; j < 3; j++){
+    h->e[6*i+2*j]   = half_pack(a->e[i][j].real, s);
+    h->e[6*i+2*j+1] = half_pack(a->e[i][j].imag, s);
+  }
+}
+
+static inline void
+half_to_su3mat( const hsu3_matrix *h, su3_matrix *a ){
+  Real s = h->norm/HALF_SCALE;
+  int i, j;
+  for(i = 0; i < 3; i++)for(j = 0; j < 3; j++){
+    a->e[i][j].real = s*h->e[6*i+2*j];
+    a->e[i][j].imag = s*h->e[6*i+2*j+1];
+  }
+}
+
+/* c <- c + a*b with a and b in half storage, expanded in registers */
+static inline void
+mult_su3_mat_vec_sum_half( const hsu3_matrix *a, const hsu3_vector *b,
+			   su3_vector *c ){
+  Real s = (a->norm/HALF_SCALE)*(b->norm/HALF_SCALE);
+  Real br[3], bi[3], cr, ci;
+  int i, j;
+  for(j = 0; j < 3; j++){
+    br[j] = b->c[2*j];
+    bi[j] = b->c[2*j+1];
+  }
+  for(i = 0; i < 3; i++){
+    cr = 0.; ci = 0.;
+    for(j = 0; j < 3; j++){
+      cr += a->e[6*i+2*j]*br[j] - a->e[6*i+2*j+1]*bi[j];
+      ci += a->e[6*i+2*j]*bi[j] + a->e[6*i+2*j+1]*br[j];
+    }
+    c->c[i].real += s*cr;
+    c->c[i].imag += s*ci;
+  }
+}
+
+#endif /* _SU3_HALF_H */
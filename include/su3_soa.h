@@ -0,0 +1,74 @@
+#ifndef _SU3_SOA_H
+#define _SU3_SOA_H
+/* MILC version 7 */
+
+/* Structure-of-arrays (SIMD) layout for the staggered Dslash, selected
+   with -DD_FN_SOA.
+
+   Sites of one parity are grouped in blocks of SOA_VLEN consecutive
+   sites.  Within a block, each real and each imaginary component is a
+   contiguous vector of SOA_VLEN numbers, one per site, so that a loop
+   over the lanes maps onto one SIMD register.  SOA_VLEN follows the
+   vector width the compiler targets (AVX-512, AVX/AVX2, or SSE), so
+   compile with a suitable ARCH_FLAG.  Padding lanes at the end of a
+   parity are kept zero. */
+
+#include "../include/precision.h"
+#include "../include/su3.h"
+
+#if defined(__AVX512F__) || defined(__MIC__)
+#define SOA_VBYTES 64
+#elif defined(__AVX__)
+#define SOA_VBYTES 32
+#else
+#define SOA_VBYTES 16
+#endif
+
+#define SOA_VLEN ((int)(SOA_VBYTES/sizeof(Real)))
+
+/* Number of blocks needed for n sites */
+#define SOA_NBLOCKS(n) (((n) + SOA_VLEN - 1)/SOA_VLEN)
+
+#ifdef __GNUC__
+#define SOA_ALIGN __attribute__((aligned(SOA_VBYTES)))
+#else
+#define SOA_ALIGN
+#endif
+
+typedef struct {
+  Real re[3][SOA_VLEN];
+  Real im[3][SOA_VLEN];
+} SOA_ALIGN su3_vector_soa;
+
+typedef struct {
+  Real re[3][3][SOA_VLEN];
+  Real im[3][3][SOA_VLEN];
+} SOA_ALIGN su3_matrix_soa;
+
+/* c <- a[0]*b[0] + a[1]*b[1] + a[2]*b[2] + a[3]*b[3], lane by lane.
+   Same order of operations as the C mult_su3_mat_vec_sum_4dir */
+
+static inline void
+mult_su3_mat_vec_sum_4dir_soa( const su3_matrix_soa *a,
+			       const su3_vector_soa *b, su3_vector_soa *c )
+{
+  int n, i, j, l;
+
+  for(i = 0; i < 3; i++)
+    for(l = 0; l < SOA_VLEN; l++){
+      c->re[i][l] = 0.;
+      c->im[i][l] = 0.;
+    }
+
+  for(n = 0; n < 4; n++)
+    for(j = 0; j < 3; j++)
+      for(i = 0; i < 3; i++)
+	for(l = 0; l < SOA_VLEN; l++){
+	  c->re[i][l] += a[n].re[i][j][l]*b[n].re[j][l];
+	  c->im[i][l] += a[n].re[i][j][l]*b[n].im[j][l];
+	  c->re[i][l] -= a[n].im[i][j][l]*b[n].im[j][l];
+	  c->im[i][l] += a[n].im[i][j][l]*b[n].re[j][l];
+	}
+}
+
+#endif /* _SU3_SOA_H */
@@ -180,7 +180,7 @@ int main( int argc, char **argv ){
   
   /* Clean up eigen storage */
   if(eigVec != NULL){
-    for(i = 0; i < param.eigen_param.Nvecs; i++) free(eigVec[i]);
+    for(i = 0; i < param.eigen_param.Nvecs; i++) field_free(eigVec[i]);
     free(eigVal); free(eigVec); free(resid);
   }
   invalidate_fermion_links(fn_links);
@@ -329,7 +329,7 @@ int readin(int prompt) {
   eigVal = (double *)malloc(param.eigen_param.Nvecs*sizeof(double));
   eigVec = (su3_vector **)malloc(param.eigen_param.Nvecs*sizeof(su3_vector*));
   for(int i=0;i<param.eigen_param.Nvecs;i++)
-    eigVec[i]= (su3_vector*)malloc(sites_on_node*sizeof(su3_vector));
+    eigVec[i] = (su3_vector *)field_alloc_tag(sites_on_node*sizeof(su3_vector), MEM_EIGEN);
   
   /* Do whatever is needed to get eigenpairs */
   imp_ferm_links_t **fn = get_fm_links(fn_links);
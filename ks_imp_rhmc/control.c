@@ -48,7 +48,9 @@ main( int argc, char **argv )
 
   /* set up */
   STARTTIME;
+  PERF_BEGIN("setup");
   prompt = setup();
+  PERF_END("setup", 0, 0);
   ENDTIME("setup");
   
   /* loop over input sets */
@@ -60,7 +62,9 @@ main( int argc, char **argv )
 #endif /* MILC_GLOBAL_DEBUG */
     
     for( traj_done=0; traj_done < warms; traj_done++ ){
+      PERF_BEGIN("trajectory");
       update();
+      PERF_END("trajectory", 0, 0);
     }
     node0_printf("WARMUPS COMPLETED\n"); fflush(stdout);
     
@@ -86,7 +90,9 @@ main( int argc, char **argv )
 #endif /* MILC_GLOBAL_DEBUG */
       /* do the trajectories */
       STARTTIME;
+      PERF_BEGIN("trajectory");
       s_iters=update();
+      PERF_END("trajectory", 0, 0);
       ENDTIME("do one trajectory");
       
       /* measure every "propinterval" trajectories */
@@ -96,7 +102,9 @@ main( int argc, char **argv )
 	/* results are printed in output file */
 	rephase(OFF);
 	STARTTIME;
+	PERF_BEGIN("gauge_measure");
 	g_measure( );
+	PERF_END("gauge_measure", 0, 0);
 	ENDTIME("do gauge measurement");
 	rephase(ON);
 #ifdef MILC_GLOBAL_DEBUG
@@ -115,6 +123,7 @@ main( int argc, char **argv )
 	/* Make fermion links if not already done */
 	
 	STARTTIME;
+	PERF_BEGIN("pbp_measure");
 	restore_fermion_links_from_site(fn_links, param.prec_pbp);
 	for(i = 0; i < param.num_pbp_masses; i++){
 #if ( FERM_ACTION == HISQ || FERM_ACTION == HYPISQ )
@@ -130,6 +139,7 @@ main( int argc, char **argv )
 			  param.ksp_pbp[i].mass, naik_index, fn_links);
 #endif
 	}
+	PERF_END("pbp_measure", 0, 0);
 	ENDTIME("do pbp measurements");
 	avs_iters += s_iters;
 	++meascount;
@@ -92,7 +92,7 @@ double hmom_action(void) {
   sum=0.0;
   FORALLSITES_OMP(i,s,private(dir) reduction(+:sum)) {
     for(dir=XUP;dir<=TUP;dir++){
-      sum += (double)ahmat_mag_sq( &(s->mom[dir]) ) - 4.0;
+      sum += (double)ahmat_mag_sq( &(SITE_MOM(i)[dir]) ) - 4.0;
       /* subtract 1/2 per d.o.f. to help numerical acc. in sum */
     }
   } END_LOOP_OMP
@@ -10,5 +10,14 @@
 #define MAX_FPI_NMASSES 32
 #define MAX_SPECTRUM_REQUEST 512
 #define MAX_N_PSEUDO 10
+#define MAX_INT_LEVELS 4	/* Levels of the INT_NESTED integrator */
+
+/* Keep the links and momenta in site fields, not in the site
+   structure (see include/macros.h), unless QUDA, QOP or QPhiX read
+   them from the sites */
+#if !defined(HAVE_QUDA) && !defined(HAVE_QOP) && !defined(HAVE_QPHIX)
+#define LINK_FIELD
+#define MOM_FIELD
+#endif
 
 #endif /* _DEFINES_H */
@@ -137,26 +137,26 @@ node0_printf("STARTING fn_fermion_force_rhmc() nterms = %d\n",nterms);
 	      /* Put antihermitian traceless part into momentum */
 	      if( ilink<length && GOES_FORWARDS(dir) ){
 	        FORALLSITES(i,s){
-	          uncompress_anti_hermitian( &(s->mom[dir]), &tmat2 );
+	          uncompress_anti_hermitian( &(SITE_MOM(i)[dir]), &tmat2 );
 		  if( s->parity==EVEN ){
 		    scalar_mult_add_su3_matrix(&tmat2, &(mat_tmp0[i]),  coeff, &tmat2 );
 		  }
 		  else{
 		    scalar_mult_add_su3_matrix(&tmat2, &(mat_tmp0[i]), -coeff, &tmat2 );
 		  }
-	          make_anti_hermitian( &tmat2, &(s->mom[dir]) );
+	          make_anti_hermitian( &tmat2, &(SITE_MOM(i)[dir]) );
 	        }
 	      }
 	      if( ilink>0 && GOES_BACKWARDS(lastdir) ){
 	        FORALLSITES(i,s){
-	          uncompress_anti_hermitian( &(s->mom[OPP_DIR(lastdir)]), &tmat2 );
+	          uncompress_anti_hermitian( &(SITE_MOM(i)[OPP_DIR(lastdir)]), &tmat2 );
 		  if( s->parity==EVEN ){
 		    scalar_mult_add_su3_matrix(&tmat2, &(mat_tmp0[i]), -coeff, &tmat2 );
 		  }
 		  else{
 		    scalar_mult_add_su3_matrix(&tmat2, &(mat_tmp0[i]),  coeff, &tmat2 );
 		  }
-	          make_anti_hermitian( &tmat2, &(s->mom[OPP_DIR(lastdir)]) );
+	          make_anti_hermitian( &tmat2, &(SITE_MOM(i)[OPP_DIR(lastdir)]) );
 	        }
 	      }
 
@@ -321,26 +321,26 @@ node0_printf("STARTING fn_fermion_force_rhmc_reverse() nterms = %d\n",nterms);
 	      /* Put antihermitian traceless part into momentum */
 	      if( ilink<length && GOES_FORWARDS(dir) ){
 	        FORALLSITES(i,s){
-	          uncompress_anti_hermitian( &(s->mom[dir]), &tmat2 );
+	          uncompress_anti_hermitian( &(SITE_MOM(i)[dir]), &tmat2 );
 		  if( s->parity==EVEN ){
 		    scalar_mult_add_su3_matrix(&tmat2, &(mat_tmp0[i]),  coeff, &tmat2 );
 		  }
 		  else{
 		    scalar_mult_add_su3_matrix(&tmat2, &(mat_tmp0[i]), -coeff, &tmat2 );
 		  }
-	          make_anti_hermitian( &tmat2, &(s->mom[dir]) );
+	          make_anti_hermitian( &tmat2, &(SITE_MOM(i)[dir]) );
 	        }
 	      }
 	      if( ilink>0 && GOES_BACKWARDS(lastdir) ){
 	        FORALLSITES(i,s){
-	          uncompress_anti_hermitian( &(s->mom[OPP_DIR(lastdir)]), &tmat2 );
+	          uncompress_anti_hermitian( &(SITE_MOM(i)[OPP_DIR(lastdir)]), &tmat2 );
 		  if( s->parity==EVEN ){
 		    scalar_mult_add_su3_matrix(&tmat2, &(mat_tmp0[i]), -coeff, &tmat2 );
 		  }
 		  else{
 		    scalar_mult_add_su3_matrix(&tmat2, &(mat_tmp0[i]),  coeff, &tmat2 );
 		  }
-	          make_anti_hermitian( &tmat2, &(s->mom[OPP_DIR(lastdir)]) );
+	          make_anti_hermitian( &tmat2, &(SITE_MOM(i)[OPP_DIR(lastdir)]) );
 	        }
 	      }
 
@@ -484,26 +484,26 @@ node0_printf("STARTING fn_fermion_force_rhmc() nterms = %d\n",nterms);
 	      /* Put antihermitian traceless part into momentum */
 	      if( ilink<length && GOES_FORWARDS(dir) ){
 	        FORALLSITES(i,s){
-	          uncompress_anti_hermitian( &(s->mom[dir]), &tmat2 );
+	          uncompress_anti_hermitian( &(SITE_MOM(i)[dir]), &tmat2 );
 		  if( s->parity==EVEN ){
 		    scalar_mult_add_su3_matrix(&tmat2, &(mat_tmp0[i]),  coeff, &tmat2 );
 		  }
 		  else{
 		    scalar_mult_add_su3_matrix(&tmat2, &(mat_tmp0[i]), -coeff, &tmat2 );
 		  }
-	          make_anti_hermitian( &tmat2, &(s->mom[dir]) );
+	          make_anti_hermitian( &tmat2, &(SITE_MOM(i)[dir]) );
 	        }
 	      }
 	      if( ilink>0 && GOES_BACKWARDS(lastdir) ){
 	        FORALLSITES(i,s){
-	          uncompress_anti_hermitian( &(s->mom[OPP_DIR(lastdir)]), &tmat2 );
+	          uncompress_anti_hermitian( &(SITE_MOM(i)[OPP_DIR(lastdir)]), &tmat2 );
 		  if( s->parity==EVEN ){
 		    scalar_mult_add_su3_matrix(&tmat2, &(mat_tmp0[i]), -coeff, &tmat2 );
 		  }
 		  else{
 		    scalar_mult_add_su3_matrix(&tmat2, &(mat_tmp0[i]),  coeff, &tmat2 );
 		  }
-	          make_anti_hermitian( &tmat2, &(s->mom[OPP_DIR(lastdir)]) );
+	          make_anti_hermitian( &tmat2, &(SITE_MOM(i)[OPP_DIR(lastdir)]) );
 	        }
 	      }
 
@@ -57,7 +57,7 @@ int readin(int prompt);
 
 enum int_alg_t { INT_LEAPFROG, INT_OMELYAN, INT_2EPS_3TO1, INT_2EPS_2TO1, 
                  INT_2G1F, INT_3G1F, INT_5G1F, INT_6G1F, INT_4MN4FP, INT_4MN5FV, INT_FOURSTEP, 
-		 INT_PLAY };
+		 INT_PLAY, INT_NESTED, INT_FORCE_GRADIENT };
 
 /* Set default integration algorithm */
 #ifndef INT_ALG
@@ -72,6 +72,7 @@ const char *ks_int_alg_opt_chr( void );
 int update_h_rhmc( Real eps, su3_vector **multi_x );
 void update_h_gauge( Real eps );
 int update_h_fermion( Real eps, su3_vector **multi_x );
+int update_h_fermion_level( Real eps, su3_vector **multi_x, int level );
 void update_u( Real eps );
 
 /* grsource_rhmc.c */
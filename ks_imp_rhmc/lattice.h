@@ -28,7 +28,9 @@
 #include "../include/random.h"   /* For double_prn */
 
 /* The lattice is an array of sites.  */
+#ifndef MOM_FIELD
 #define MOM_SITE   /* If there is a mom member of the site struct */
+#endif
 typedef struct {
     /* The first part is standard to all programs */
 	/* coordinates of this site */
@@ -48,15 +50,14 @@ typedef struct {
 /*   Now come the physical fields, program dependent            */
 /* ------------------------------------------------------------ */
 
+#ifndef LINK_FIELD
         /* gauge field */
         su3_matrix link[4] ALIGNMENT;	/* the fundamental field */
+#endif
 
+#ifdef MOM_SITE
 	/* antihermitian momentum matrices in each direction */
         anti_hermitmat mom[4] ALIGNMENT;
-
-#ifdef HMC
- 	su3_matrix old_link[4];
-	/* For accept/reject */
 #endif
 
 	/* The Kogut-Susskind phases, which have been absorbed into 
@@ -131,6 +132,12 @@ EXTERN  int niter_md[MAX_N_PSEUDO], niter_fa[MAX_N_PSEUDO], niter_gr[MAX_N_PSEUD
 EXTERN  int prec_md[MAX_N_PSEUDO], prec_fa[MAX_N_PSEUDO], prec_gr[MAX_N_PSEUDO];
 EXTERN  int prec_ff;
 EXTERN	Real epsilon;
+EXTERN  int n_int_levels;
+EXTERN  int int_level_alg[MAX_INT_LEVELS];
+EXTERN  Real int_level_lambda[MAX_INT_LEVELS];
+EXTERN  int int_level_steps[MAX_INT_LEVELS];
+EXTERN  int gauge_force_level;
+EXTERN  int md_level[MAX_N_PSEUDO];
 EXTERN	Real rsqmin_md[MAX_N_PSEUDO], rsqmin_fa[MAX_N_PSEUDO], rsqmin_gr[MAX_N_PSEUDO];
 EXTERN  Real rsqprop;
 EXTERN	int startflag;	/* beginning lattice: CONTINUE, RELOAD, RELOAD_BINARY,
@@ -170,6 +177,20 @@ EXTERN double_prn node_prn ;
 EXTERN Real boundary_phase[4];
 EXTERN site *lattice;
 
+/* Site fields replacing members of the site structure */
+#ifdef LINK_FIELD
+/* gauge field, four directions per site */
+EXTERN su3_matrix *link_field;
+#endif
+#ifdef HMC
+/* links at the start of the trajectory, for accept/reject */
+EXTERN su3_matrix *old_link_field;
+#endif
+#ifdef MOM_FIELD
+/* antihermitian momentum matrices, four directions per site */
+EXTERN anti_hermitmat *mom_field;
+#endif
+
 /* Vectors for addressing */
 /* Generic pointers, for gather routines */
 #define N_POINTERS 16
@@ -45,6 +45,14 @@ typedef struct {
   Real rsqmin_md[MAX_N_PSEUDO], rsqmin_fa[MAX_N_PSEUDO], rsqmin_gr[MAX_N_PSEUDO];
   Real rsqprop;  /* for deciding on convergence */
   Real epsilon;	/* time step */
+  /* Nested integrator (INT_NESTED only) */
+  int n_int_levels;     /* number of levels, outermost first */
+  int int_level_alg[MAX_INT_LEVELS];   /* INT_LEAPFROG, INT_OMELYAN or
+					  INT_FORCE_GRADIENT */
+  Real int_level_lambda[MAX_INT_LEVELS]; /* Omelyan lambda */
+  int int_level_steps[MAX_INT_LEVELS]; /* steps per step of the level above */
+  int gauge_force_level; /* level of the gauge force */
+  int md_level[MAX_N_PSEUDO]; /* level of each pseudofermion force */
   int startflag;  /* what to do for beginning lattice */
   int saveflag;   /* what to do with lattice at end */
   int n_pseudo; /* Number of pseudofermion fields */
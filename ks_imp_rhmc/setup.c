@@ -140,6 +140,19 @@ setup(void)
   initialize_prn( &node_prn, iseed, volume+mynode() );
   /* allocate space for lattice, set up coordinate fields */
   make_lattice();
+  /* members kept in site fields instead of the site structure */
+#ifdef LINK_FIELD
+  link_field = (su3_matrix *)create_site_field("link",
+				4*sizeof(su3_matrix), MEM_LINKS);
+#endif
+#ifdef HMC
+  old_link_field = (su3_matrix *)create_site_field("old_link",
+				4*sizeof(su3_matrix), MEM_LINKS);
+#endif
+#ifdef MOM_FIELD
+  mom_field = (anti_hermitmat *)create_site_field("mom",
+				4*sizeof(anti_hermitmat), MEM_FIELDS);
+#endif
 
   /* set up neighbor pointers and comlink structures */
   make_nn_gathers();
@@ -375,6 +388,7 @@ readin(int prompt)
   
   int status;
   int i;
+  char intalg[MAXFILENAME];
   
   /* On node zero, read parameters and send to all other nodes */
   if(mynode()==0) {
@@ -397,6 +411,59 @@ readin(int prompt)
     /*microcanonical steps per trajectory */
     IF_OK status += get_i(stdin, prompt,"steps_per_trajectory", &param.steps );
     
+    /* Levels of the nested integrator, outermost first.  Level 0
+       takes steps_per_trajectory steps of microcanonical_time_step */
+    param.n_int_levels = 0;
+    param.gauge_force_level = 0;
+    if(INT_ALG == INT_NESTED){
+      IF_OK status += get_i(stdin, prompt,"integrator_levels", 
+			    &param.n_int_levels );
+      IF_OK if(param.n_int_levels < 1 || param.n_int_levels > MAX_INT_LEVELS){
+	printf("integrator_levels must be between 1 and %d\n", MAX_INT_LEVELS);
+	status++;
+      }
+      for(i = 0; i < param.n_int_levels; i++){
+	IF_OK status += get_s(stdin, prompt,"level_integrator", intalg );
+	IF_OK {
+	  if(strcmp(intalg, "leapfrog") == 0){
+	    param.int_level_alg[i] = INT_LEAPFROG;
+	    param.int_level_lambda[i] = 0.;
+	  }
+	  else if(strcmp(intalg, "omelyan") == 0){
+	    param.int_level_alg[i] = INT_OMELYAN;
+	    IF_OK status += get_f(stdin, prompt,"omelyan_lambda", 
+				  &param.int_level_lambda[i] );
+	  }
+	  else if(strcmp(intalg, "force_gradient") == 0){
+	    param.int_level_alg[i] = INT_FORCE_GRADIENT;
+	    param.int_level_lambda[i] = 0.;
+	  }
+	  else {
+	    printf("level_integrator must be leapfrog, omelyan or force_gradient, not %s\n", 
+		   intalg);
+	    status++;
+	  }
+	}
+	param.int_level_steps[i] = 1;
+	if(i > 0){
+	  IF_OK status += get_i(stdin, prompt,"level_steps", 
+				&param.int_level_steps[i] );
+	  IF_OK if(param.int_level_steps[i] < 1){
+	    printf("level_steps must be positive\n");
+	    status++;
+	  }
+	}
+      }
+      IF_OK status += get_i(stdin, prompt,"gauge_force_level", 
+			    &param.gauge_force_level );
+      IF_OK if(param.gauge_force_level < 0 || 
+	       param.gauge_force_level >= param.n_int_levels){
+	printf("gauge_force_level must be between 0 and %d\n", 
+	       param.n_int_levels-1);
+	status++;
+      }
+    }
+
     /* Data for each pseudofermion */
 
     for(i = 0; i < param.n_pseudo; i++){
@@ -426,6 +493,17 @@ readin(int prompt)
 	param.prec_fa[i] = itmp[1];
 	param.prec_gr[i] = itmp[2];
       }
+
+      /* Level of the nested integrator for the force */
+      param.md_level[i] = 0;
+      if(INT_ALG == INT_NESTED){
+	IF_OK status += get_i(stdin, prompt, "md_level", &param.md_level[i]);
+	IF_OK if(param.md_level[i] < 0 || 
+		 param.md_level[i] >= param.n_int_levels){
+	  printf("md_level must be between 0 and %d\n", param.n_int_levels-1);
+	  status++;
+	}
+      }
     }
 
     /* Max restarts for cleanup solves */
@@ -507,7 +585,16 @@ readin(int prompt)
     prec_md[i] = param.prec_md[i];
     prec_fa[i] = param.prec_fa[i];
     prec_gr[i] = param.prec_gr[i];
+
+    md_level[i] = param.md_level[i];
+  }
+  n_int_levels = param.n_int_levels;
+  for(i = 0; i < n_int_levels; i++){
+    int_level_alg[i] = param.int_level_alg[i];
+    int_level_lambda[i] = param.int_level_lambda[i];
+    int_level_steps[i] = param.int_level_steps[i];
   }
+  gauge_force_level = param.gauge_force_level;
   prec_ff = param.prec_ff;
   rsqprop = param.rsqprop;
   epsilon = param.epsilon;
@@ -19,7 +19,7 @@ int update_h_rhmc( Real eps, su3_vector **multi_x ){
 #endif
   /*  node0_printf("update_h_rhmc:\n"); */
   /* gauge field force */
-  imp_gauge_force_ks(eps,F_OFFSET(mom));
+  imp_gauge_force_ks(eps);
   /* fermionic force */
   
   iters = update_h_fermion( eps,  multi_x );
@@ -31,11 +31,20 @@ int update_h_rhmc( Real eps, su3_vector **multi_x ){
 void update_h_gauge( Real eps ){
   /* node0_printf("update_h_gauge:\n");*/
   /* gauge field force */
-  imp_gauge_force_ks(eps,F_OFFSET(mom));
+  imp_gauge_force_ks(eps);
 } /* update_h_gauge */
 
 // fermion force update grouping pseudofermions with the same path coeffs
 int update_h_fermion( Real eps, su3_vector **multi_x ){
+  return update_h_fermion_level( eps, multi_x, -1 );
+} /* update_h_fermion */
+
+// fermion force from the pseudofermions assigned to one level of the
+// nested integrator (md_level[iphi] == level), or from all of them if
+// level < 0.  The HISQ force takes the number of terms in each Naik
+// set from n_orders_naik and n_order_naik_total, so these are set to
+// the counts for the chosen pseudofermions for the duration of the call.
+int update_h_fermion_level( Real eps, su3_vector **multi_x, int level ){
   int iphi,jphi;
   Real final_rsq;
   int i,j,n;
@@ -44,24 +53,49 @@ int update_h_fermion( Real eps, su3_vector **multi_x ){
   Real *roots;
   int iters = 0;
   imp_ferm_links_t **fn;
+  int save_orders_naik[MAX_N_PSEUDO], save_order_naik_total;
 
   /* Algorithm sketch: assemble multi_x with all |X> fields,
      then call force routine for each part (so far we have to parts:
      zero correction to Naik and non-zero correction to Naik */
 
+#if ( FERM_ACTION == HISQ || FERM_ACTION == HYPISQ )
+  n = fermion_links_get_n_naiks(fn_links);
+#else
+  n = 1;
+#endif
+
+  save_order_naik_total = n_order_naik_total;
+  n_order_naik_total = 0;
+  iphi = 0;
+  for( i=0; i<n; i++ ) {
+    save_orders_naik[i] = n_orders_naik[i];
+    n_orders_naik[i] = 0;
+    for( jphi=0; jphi<n_pseudo_naik[i]; jphi++ ) {
+      if( level < 0 || md_level[iphi] == level )
+	n_orders_naik[i] += rparam[iphi].MD.order;
+      iphi++;
+    }
+    n_order_naik_total += n_orders_naik[i];
+  }
+  if( n_order_naik_total == 0 ) {
+    n_order_naik_total = save_order_naik_total;
+    for( i=0; i<n; i++ ) n_orders_naik[i] = save_orders_naik[i];
+    return 0;
+  }
+
   allresidues = (Real *)malloc(n_order_naik_total*sizeof(Real));
 
   // Group the fermion force calculation according to sets of like
   // path coefficients.
   tmporder = 0;
   iphi = 0;
-#if ( FERM_ACTION == HISQ || FERM_ACTION == HYPISQ )
-  n = fermion_links_get_n_naiks(fn_links);
-#else
-  n = 1;
-#endif
   for( i=0; i<n; i++ ) {
     for( jphi=0; jphi<n_pseudo_naik[i]; jphi++ ) {
+      if( level >= 0 && md_level[iphi] != level ) {
+	iphi++;
+	continue;
+      }
       restore_fermion_links_from_site(fn_links, prec_md[iphi]);
       fn = get_fm_links(fn_links);
 
@@ -107,6 +141,8 @@ int update_h_fermion( Real eps, su3_vector **multi_x ){
 			  n_order_naik_total, prec_ff, fn_links );
 
   free(allresidues);
+  n_order_naik_total = save_order_naik_total;
+  for( i=0; i<n; i++ ) n_orders_naik[i] = save_orders_naik[i];
   return iters;
-} /* update_h_fermion */
+} /* update_h_fermion_level */
 
@@ -5,6 +5,8 @@
  *  D.T. 03/07 Added 2G1F and generalized to gang together multiple psfermions
 
  *  A.W-L. 12/18 Added 5G1F and 6G1F
+ *  Added NESTED, with the levels read from the input
+ *  Added the force-gradient step for NESTED levels
 
  Update lattice by a molecular dynamics trajectory.
  Contains a selection of integration algorithms
@@ -141,8 +143,34 @@
         eg 3*eps for light/strange ratio, eps for strange^(3/4)
         Three Omelyan steps for gauge and factor_two force, one leapfrog step for factor 
         one force (should upgrade to Omelyan for each)
+   NESTED
+        Multiple time scales, set in the input file.  Level 0 is the
+        outermost; each level has a leapfrog or Omelyan step, the
+        gauge force may be put on any level and each pseudofermion
+        force on any level (md_level).  A step of length h at level l is
+        momentum first,
+          leapfrog: P(h/2) inner(h) P(h/2)
+          Omelyan:  P(lambda*h) inner(h/2) P((1-2*lambda)*h) inner(h/2) P(lambda*h)
+        where P(t) updates H by t times the forces on level l, and
+        inner(t) is level_steps[l+1] steps of level l+1, each of length
+        t/level_steps[l+1], or update U by t below the last level.
+        Here lambda is that of Takaishi and de Forcrand (optimum
+        0.1932), 1/4 of the lambda of OMELYAN above.  Level 0 takes
+        "steps" steps of length epsilon, so a level 0 step is a full
+        step of its scheme, not a force evaluation.  The momentum
+        updates of a level are collected until U next moves, so the last
+        one of a step and the first one of the next cost one force.
+        A level may also take a force-gradient step (Omelyan, Mryglod
+        and Folk; Clark, Joo, Kennedy and Silva, arXiv:1108.1828),
+          P(h/6) inner(h/2) P'(2h/3) inner(h/2) P(h/6)
+        a fourth order scheme.  P'(t) is the momentum update with the
+        force gradient term, done as in Yin and Mawhinney
+        (arXiv:1111.5059) by evaluating the forces of the level at the
+        displaced links exp((h^2/24)*F) U, F the forces at U, so it
+        costs two force evaluations and needs no second derivatives.
 */
 #include "ks_imp_includes.h"	/* definitions files and prototypes */
+#include "../include/openmp_defs.h"
 #ifdef MILC_GLOBAL_DEBUG
 #include "../include/su3_mat_op.h"
 #endif
@@ -156,6 +184,113 @@
 #define special_free free
 #endif
 
+/* Momentum updates of the NESTED integrator not yet applied */
+static Real nested_pending[MAX_INT_LEVELS];
+
+/* Update H by eps times the forces of one level */
+static int nested_force( int level, Real eps, su3_vector **multi_x ){
+  int iters = 0;
+
+  if(gauge_force_level == level)update_h_gauge( eps );
+  iters += update_h_fermion_level( eps, multi_x, level );
+  return iters;
+}
+
+/* Apply the pending momentum updates at the present links */
+static int nested_flush( su3_vector **multi_x ){
+  int l, iters = 0;
+
+  for(l = 0; l < n_int_levels; l++){
+    if(nested_pending[l] == 0.)continue;
+    iters += nested_force( l, nested_pending[l], multi_x );
+    nested_pending[l] = 0.;
+  }
+  return iters;
+}
+
+/* Force-gradient momentum update: H += t*F(U') with U' = exp(c*F(U)) U
+   and F the forces of this level.  The links are restored after. */
+static int nested_fg_force( int level, Real t, Real c, su3_vector **multi_x ){
+  anti_hermitmat *mom_save;
+  su3_matrix *link_save;
+  int i, dir, iters = 0;
+
+  mom_save = create_ah_array_field(4);
+  link_save = create_G_from_site();
+
+  /* c*F(U) alone in the momenta */
+  FORALLFIELDSITES_OMP(i,private(dir)){
+    for(dir=XUP; dir<=TUP; dir++){
+      mom_save[4*i+dir] = SITE_MOM(i)[dir];
+      memset(&(SITE_MOM(i)[dir]), 0, sizeof(anti_hermitmat));
+    }
+  } END_LOOP_OMP;
+  iters += nested_force( level, c, multi_x );
+
+  /* Displace the links and evaluate the forces there */
+  update_u( 1.0 );
+  FORALLFIELDSITES_OMP(i,private(dir)){
+    for(dir=XUP; dir<=TUP; dir++)
+      SITE_MOM(i)[dir] = mom_save[4*i+dir];
+  } END_LOOP_OMP;
+  iters += nested_force( level, t, multi_x );
+
+  copy_G_to_site(link_save);
+#ifdef FN
+  invalidate_fermion_links(fn_links);
+#endif
+
+  destroy_G(link_save);
+  destroy_ah_array_field(mom_save, 4);
+  return iters;
+}
+
+static int nested_step( int level, Real h, su3_vector **multi_x );
+
+/* Move the links by time t with the levels below this one */
+static int nested_inner( int level, Real t, su3_vector **multi_x ){
+  int k, n, iters = 0;
+
+  if(level == n_int_levels-1){
+    iters += nested_flush( multi_x );
+    update_u( t );
+  }
+  else {
+    n = int_level_steps[level+1];
+    for(k = 0; k < n; k++)
+      iters += nested_step( level+1, t/n, multi_x );
+  }
+  return iters;
+}
+
+/* One step of length h at this level */
+static int nested_step( int level, Real h, su3_vector **multi_x ){
+  Real lambda = int_level_lambda[level];
+  int iters = 0;
+
+  if(int_level_alg[level] == INT_LEAPFROG){
+    nested_pending[level] += 0.5*h;
+    iters += nested_inner( level, h, multi_x );
+    nested_pending[level] += 0.5*h;
+  }
+  else if(int_level_alg[level] == INT_FORCE_GRADIENT){
+    /* The inner step moved the links, so nothing is pending here */
+    nested_pending[level] += h/6.0;
+    iters += nested_inner( level, 0.5*h, multi_x );
+    iters += nested_fg_force( level, 2.0*h/3.0, h*h/24.0, multi_x );
+    iters += nested_inner( level, 0.5*h, multi_x );
+    nested_pending[level] += h/6.0;
+  }
+  else {
+    nested_pending[level] += lambda*h;
+    iters += nested_inner( level, 0.5*h, multi_x );
+    nested_pending[level] += (1.0-2.0*lambda)*h;
+    iters += nested_inner( level, 0.5*h, multi_x );
+    nested_pending[level] += lambda*h;
+  }
+  return iters;
+}
+
 int update() {
   int step, iters=0;
   double startaction,endaction;
@@ -248,6 +383,29 @@ int update() {
       }
       n_multi_x = max_rat_order;
     break;
+    case INT_NESTED:
+      node0_printf("Nested integration, steps= %d eps= %e levels= %d\n",
+		   steps,epsilon,n_int_levels);
+      for(j=0; j<n_int_levels; j++){
+	if(int_level_alg[j] == INT_LEAPFROG){
+	  node0_printf("level %d: leapfrog, %d steps per outer step, forces:",
+		       j,int_level_steps[j]);
+	} else if(int_level_alg[j] == INT_FORCE_GRADIENT){
+	  node0_printf("level %d: force gradient, %d steps per outer step, forces:",
+		       j,int_level_steps[j]);
+	} else {
+	  node0_printf("level %d: omelyan lambda= %e, %d steps per outer step, forces:",
+		       j,int_level_lambda[j],int_level_steps[j]);
+	}
+	if(gauge_force_level == j)node0_printf(" gauge");
+	for(i=0; i<n_pseudo; i++)
+	  if(md_level[i] == j)node0_printf(" pseudofermion %d",i);
+	node0_printf("\n");
+      }
+      n_multi_x = max_rat_order;
+      for(j=0,i=0; i<n_pseudo; i++){j+=rparam[i].MD.order;}
+      if(j>n_multi_x)n_multi_x=j; // A level may have all the pseudofermions
+    break;
     default:
       node0_printf("No integration algorithm, or unknown one\n");
       terminate(1);
@@ -302,7 +460,7 @@ int update() {
   startaction=d_action_rhmc(multi_x,sumvec);
 #ifdef HMC
   /* copy link field to old_link */
-  gauge_field_copy( F_OFFSET(link[0]), F_OFFSET(old_link[0]));
+  copy_site_to_G(old_link_field);
 #endif
   
   switch(int_alg){
@@ -639,7 +797,7 @@ int update() {
         for(step=6; step <= steps; step+=6){
 	    /* update U's and H's - first Omelyan step */
      	    update_u(0.5*epsilon*lambda);
-	    imp_gauge_force_ks(epsilon,F_OFFSET(mom));
+	    imp_gauge_force_ks(epsilon);
             eo_fermion_force_rhmc( epsilon,  &rparam[1].MD,
 				   multi_x, F_OFFSET(phi[1]), rsqmin_md[1], 
 				   niter_md[1], prec_md[1], prec_ff,
@@ -652,7 +810,7 @@ int update() {
 
      	    update_u(epsilon*( 0.5*(1.0-lambda) ));
 
-	    imp_gauge_force_ks(epsilon,F_OFFSET(mom));
+	    imp_gauge_force_ks(epsilon);
             eo_fermion_force_rhmc( epsilon,  &rparam[1].MD,
 				   multi_x, F_OFFSET(phi[1]), rsqmin_md[1], 
 				   niter_md[1], prec_md[1], prec_ff,
@@ -663,7 +821,7 @@ int update() {
 	    /* update U's and H's - second Omelyan step */
      	    update_u(0.5*epsilon*lambda);
 
-	    imp_gauge_force_ks(epsilon,F_OFFSET(mom));
+	    imp_gauge_force_ks(epsilon);
             eo_fermion_force_rhmc( epsilon,  &rparam[1].MD,
 				   multi_x, F_OFFSET(phi[1]), rsqmin_md[1], 
 				   niter_md[1], prec_md[1], prec_ff,
@@ -671,7 +829,7 @@ int update() {
 
      	    update_u(epsilon*(2.0-lambda));
 
-	    imp_gauge_force_ks(epsilon,F_OFFSET(mom));
+	    imp_gauge_force_ks(epsilon);
             eo_fermion_force_rhmc( epsilon,  &rparam[1].MD,
 				   multi_x, F_OFFSET(phi[1]), rsqmin_md[1], 
 				   niter_md[1], prec_md[1], prec_ff,
@@ -682,7 +840,7 @@ int update() {
 	    /* update U's and H's - third Omelyan step */
      	    update_u(0.5*epsilon*lambda);
 
-	    imp_gauge_force_ks(epsilon,F_OFFSET(mom));
+	    imp_gauge_force_ks(epsilon);
             eo_fermion_force_rhmc( epsilon,  &rparam[1].MD,
 				   multi_x, F_OFFSET(phi[1]), rsqmin_md[1], 
 				   niter_md[1], prec_md[1], prec_ff,
@@ -697,7 +855,7 @@ int update() {
 
      	    update_u(epsilon*( 1.0 + 0.5*(1.0-lambda) ));
 
-	    imp_gauge_force_ks(epsilon,F_OFFSET(mom));
+	    imp_gauge_force_ks(epsilon);
             eo_fermion_force_rhmc( epsilon,  &rparam[1].MD,
 				   multi_x, F_OFFSET(phi[1]), rsqmin_md[1], 
 				   niter_md[1], prec_md[1], prec_ff,
@@ -711,6 +869,17 @@ int update() {
 
         }	/* end loop over microcanonical steps */
     break;
+    case INT_NESTED:
+      for(j=0; j<n_int_levels; j++)nested_pending[j] = 0.;
+      /* do "steps" steps of the outermost level */
+      for(step=1; step <= steps; step++){
+	iters += nested_step( 0, epsilon, multi_x );
+	/* reunitarize the gauge field */
+	reunitarize_ks();
+      }
+      /* the momentum updates at the end of the trajectory */
+      iters += nested_flush( multi_x );
+    break;
     default:
       node0_printf("No integration algorithm, or unknown one\n");
       terminate(1);
@@ -727,7 +896,7 @@ int update() {
   broadcast_float(&xrandom);
   if( exp( (double)(startaction-endaction) ) < xrandom ){
     if(steps > 0)
-      gauge_field_copy( F_OFFSET(old_link[0]), F_OFFSET(link[0]) );
+      copy_G_to_site(old_link_field);
 #ifdef FN
     invalidate_fermion_links(fn_links);
 #endif
@@ -787,6 +956,9 @@ const char *ks_int_alg_opt_chr( void )
   case INT_PLAY:
     return "INT_PLAY";
     break;
+  case INT_NESTED:
+    return "INT_NESTED";
+    break;
   default:
     return "UNKNOWN";
   }
@@ -63,7 +63,7 @@ int update()  {
   /* find action */
   startaction=d_action_rhmc(multi_x,sumvec);
   /* copy link field to old_link */
-  gauge_field_copy( F_OFFSET(link[0]), F_OFFSET(old_link[0]));
+  copy_site_to_G(old_link_field);
   
   /* do "steps" microcanonical steps"  */
   for(step=1; step <= steps; step++){
@@ -93,7 +93,7 @@ int update()  {
   broadcast_float(&xrandom);
   if( exp( (double)(startaction-endaction) ) < xrandom ){
     if(steps > 0)
-      gauge_field_copy( F_OFFSET(old_link[0]), F_OFFSET(link[0]) );
+      copy_G_to_site(old_link_field);
 #ifdef FN
     invalidate_fermion_links(fn_links);
     //    invalidate_all_ferm_links(&fn_links);
@@ -69,7 +69,7 @@ int update()  {
   /* find action */
   startaction=d_action_rhmc(multi_x,sumvec);
   /* copy link field to old_link */
-  gauge_field_copy( F_OFFSET(link[0]), F_OFFSET(old_link[0]));
+  copy_site_to_G(old_link_field);
   
   /* do "steps" microcanonical steps (one "step" = one force evaluation)"  */
   for(step=2; step <= steps; step+=2){
@@ -97,7 +97,7 @@ int update()  {
   broadcast_float(&xrandom);
   if( exp( (double)(startaction-endaction) ) < xrandom ){
     if(steps > 0)
-      gauge_field_copy( F_OFFSET(old_link[0]), F_OFFSET(link[0]) );
+      copy_G_to_site(old_link_field);
 #ifdef FN
     invalidate_fermion_links(fn_links);
     //    invalidate_all_ferm_links(&fn_links);
@@ -52,7 +52,6 @@ void update_u(Real eps){
 void update_u( Real eps ){
 
   register int i,dir;
-  register site *s;
   su3_matrix *link,temp1,temp2,htemp;
   register Real t2,t3,t4,t5,t6,t7,t8;
   /**TEMP**
@@ -81,10 +80,10 @@ void update_u( Real eps ){
   invalidate_fermion_links(fn_links);
 #endif
 
-  FORALLSITES_OMP(i,s,private(dir,link,temp1,temp2,htemp)) {
+  FORALLFIELDSITES_OMP(i,private(dir,link,temp1,temp2,htemp)) {
     for(dir=XUP; dir <=TUP; dir++){
-      uncompress_anti_hermitian( &(s->mom[dir]) , &htemp );
-      link = &(s->link[dir]);
+      uncompress_anti_hermitian( &(SITE_MOM(i)[dir]) , &htemp );
+      link = &(SITE_LINK(i)[dir]);
       mult_su3_nn(&htemp,link,&temp1);
       scalar_mult_add_su3_matrix(link,&temp1,t8,&temp2);
       mult_su3_nn(&htemp,&temp2,&temp1);
@@ -279,7 +279,7 @@ int main(int argc, char *argv[])
       }
       
       /* Clean up eigen storage */
-      for(int i = 0; i < Nvecs_tot; i++) free(eigVec[i]);
+      for(int i = 0; i < Nvecs_tot; i++) field_free(eigVec[i]);
       free(eigVal); free(eigVec); free(resid);
     }
     
@@ -595,7 +595,7 @@ int readin(int prompt) {
   eigVec = (su3_vector **)malloc(Nvecs_tot*sizeof(su3_vector *));
   node0_printf("Allocating space for %d eigenvectors\n", Nvecs_tot);
   for(int i = 0; i < Nvecs_tot; i++)
-    eigVec[i] = (su3_vector *)malloc(sites_on_node*sizeof(su3_vector));
+    eigVec[i] = (su3_vector *)field_alloc_tag(sites_on_node*sizeof(su3_vector), MEM_EIGEN);
 
   /* Do whatever is needed to get eigenpairs -- assumed charge 0 */
   imp_ferm_links_t **fn = get_fm_links(fn_links);
@@ -625,7 +625,7 @@ int readin(int prompt) {
     eigVal = (double *)malloc(param.eigen_param.Nvecs*sizeof(double));
     eigVec = (su3_vector **)malloc(param.eigen_param.Nvecs*sizeof(su3_vector *));
     for(i=0; i < param.eigen_param.Nvecs; i++){
-      eigVec[i] = (su3_vector *)malloc(sites_on_node*sizeof(su3_vector));
+      eigVec[i] = (su3_vector *)field_alloc_tag(sites_on_node*sizeof(su3_vector), MEM_EIGEN);
       if(eigVec[i] == NULL){
 	printf("No room for eigenvector\n");
 	terminate(1);
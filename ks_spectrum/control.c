@@ -91,7 +91,9 @@ int main(int argc, char *argv[])
     
   /* set up */
   STARTTIME;
+  PERF_BEGIN("setup");
   prompt = setup();
+  PERF_END("setup", 0, 0);
   ENDTIME("setup");
 
   /* loop over input sets */
@@ -262,6 +264,7 @@ int main(int argc, char *argv[])
     /* Create sources */
 
     STARTTIME;
+    PERF_BEGIN("sources");
 
     /* Base sources */
 
@@ -327,6 +330,7 @@ int main(int argc, char *argv[])
 
     } /* is */
 
+    PERF_END("sources", 0, 0);
     ENDTIME("create sources");
 
     /**************************************************************/
@@ -335,6 +339,7 @@ int main(int argc, char *argv[])
     /* Loop over sets of propagators */
 
     STARTTIME;
+    PERF_BEGIN("propagators");
 
     /* Temporary lists */
     ks_prop_field *tmp_source[MAX_PROP];
@@ -393,6 +398,7 @@ int main(int argc, char *argv[])
 				  param.check[i0]);
       
     } /* sets */
+    PERF_END("propagators", 0, 0);
     ENDTIME("compute propagators");
     
     
@@ -562,6 +568,7 @@ int main(int argc, char *argv[])
     /* Compute the meson propagators */
     
     STARTTIME;
+    PERF_BEGIN("meson_corr");
     for(i = 0; i < param.num_pair; i++){
       
       /* Index for the quarks making up this meson */
@@ -627,12 +634,14 @@ int main(int argc, char *argv[])
 	node0_printf("destroy quark[%d]\n",oldiq1);
       }
 #endif
+    PERF_END("meson_corr", 0, 0);
     ENDTIME("tie meson correlators");
     
     /****************************************************************/
     /* Compute the baryon propagators */
     
     STARTTIME;
+    PERF_BEGIN("baryon_corr");
     for(i = 0; i < param.num_triplet; i++){
       
       /* Index for the quarks making up this meson */
@@ -711,6 +720,7 @@ int main(int argc, char *argv[])
 	node0_printf("destroy quark[%d]\n",oldiq2);
       }
 #endif
+    PERF_END("baryon_corr", 0, 0);
     ENDTIME("tie baryon correlators");
     
 #if EIGMODE == EIGCG
@@ -745,7 +755,7 @@ int main(int argc, char *argv[])
       }
       
       /* Clean up eigen storage */
-      for(i = 0; i < Nvecs_tot; i++) free(eigVec[i]);
+      for(i = 0; i < Nvecs_tot; i++) field_free(eigVec[i]);
       free(eigVal); free(eigVec); free(resid);
       
       ENDTIME("save eigenvectors (if requested)");
@@ -575,10 +575,11 @@ int readin(int prompt) {
 
       IF_OK {
 	IF_OK status += get_i(stdin, prompt,"precision", &param.qic[0].prec );
-#if ! defined(HAVE_QOP) && ! defined(USE_CG_GPU) && !defined(HAVE_QPHIX)
+#if ! defined(HAVE_QOP) && ! defined(USE_CG_GPU) && !defined(HAVE_QPHIX) && \
+  ! ( defined(KS_CG_MIXED) && (MILC_PRECISION == 2) )
 	IF_OK if(param.qic[0].prec != MILC_PRECISION){
 	  node0_printf("WARNING: Compiled precision %d overrides request\n",MILC_PRECISION);
-	  node0_printf("QOP or CG_GPU or QPHIX compilation is required for mixed precision\n");
+	  node0_printf("QOP or CG_GPU or QPHIX or KS_CG_MIXED compilation is required for mixed precision\n");
 	  param.qic[0].prec = MILC_PRECISION;   /* Same for all members of a set*/
 	}
 #endif
@@ -687,6 +688,28 @@ int readin(int prompt) {
 	  }
 	}
 
+	/* Inverter type: CG or (sets with one propagator only) MG.
+	   Larger sets are solved by the multimass or block inverters */
+	param.qic[nprop].inv_type = CGTYPE;
+#ifdef KS_MG_MILC
+	IF_OK status += get_s(stdin, prompt,"inv_type", savebuf);
+	IF_OK {
+	  if(strcmp(savebuf,"MG") == 0){
+	    param.qic[nprop].inv_type = MGTYPE;
+	    if(param.num_prop[k] > 1){
+	      printf("inv_type MG needs a set with one propagator, not %d\n",
+		     param.num_prop[k]);
+	      status++;
+	    }
+	    IF_OK status += get_s(stdin, prompt,"mg_param_file",
+				  param.qic[nprop].mgparamfile);
+	  } else if(strcmp(savebuf,"CG") != 0){
+	    printf("inv_type must be CG or MG, not %s\n", savebuf);
+	    status++;
+	  }
+	}
+#endif
+
 	/* error for clover propagator conjugate gradient */
 	IF_OK status += get_f(stdin, prompt,"error_for_propagator", 
 			      &param.qic[nprop].resid );
@@ -1276,7 +1299,7 @@ int readin(int prompt) {
   eigVal = (double *)malloc(Nvecs_tot*sizeof(double));
   eigVec = (su3_vector **)malloc(Nvecs_tot*sizeof(su3_vector *));
   for(i = 0; i < Nvecs_tot; i++)
-    eigVec[i] = (su3_vector *)malloc(sites_on_node*sizeof(su3_vector));
+    eigVec[i] = (su3_vector *)field_alloc_tag(sites_on_node*sizeof(su3_vector), MEM_EIGEN);
 
   /* Do whatever is needed to get eigenpairs */
   imp_ferm_links_t **fn = get_fm_links(fn_links);
@@ -1307,7 +1330,7 @@ int readin(int prompt) {
     eigVal = (double *)malloc(param.eigen_param.Nvecs*sizeof(double));
     eigVec = (su3_vector **)malloc(param.eigen_param.Nvecs*sizeof(su3_vector *));
     for(i=0; i < param.eigen_param.Nvecs; i++){
-      eigVec[i] = (su3_vector *)malloc(sites_on_node*sizeof(su3_vector));
+      eigVec[i] = (su3_vector *)field_alloc_tag(sites_on_node*sizeof(su3_vector), MEM_EIGEN);
       if(eigVec[i] == NULL){
 	printf("No room for eigenvector\n");
 	terminate(1);
@@ -0,0 +1,191 @@
+#! /bin/bash
+
+# Multigrid inversions (inv_type MG), one random color wall source
+# per set, with the stopping condition varied between the sets.
+
+paramfile=$1
+
+if [ $# -lt 1 ]
+then
+    echo "Usage $0 <paramfile>"
+    exit 1
+fi
+
+source $paramfile
+
+nsets=${#rand_t0[@]}
+corrfilet=${corrfile}_t${rand_t0[0]}.test-out
+
+case $action in
+hisq)
+  naik_cmd="naik_term_epsilon ${naik_term_epsilon}"
+;;
+asqtad)
+  naik_cmd=""
+;;
+esac
+
+cat <<EOF
+prompt 0
+nx ${nx}
+ny ${ny}
+nz ${nz}
+nt ${nt}
+iseed ${iseed}
+job_id ${jobid}
+
+######################################################################
+# source time ${rand_t0[0]}
+######################################################################
+
+# Gauge field description
+
+reload_serial ${inlat}
+u0 ${u0}
+coulomb_gauge_fix
+forget
+staple_weight 0
+ape_iter 0
+coordinate_origin 0 0 0 0
+time_bc antiperiodic
+
+# Eigenpairs
+
+max_number_of_eigenpairs 0
+
+# Chiral condensate and related measurements
+
+number_of_pbp_masses 0
+
+# Description of base sources
+
+number_of_base_sources ${nsets}
+EOF
+
+for ((i=0; i<${nsets}; i++)); do
+
+cat <<EOF
+
+# base source ${i}
+
+random_color_wall
+field_type KS
+subset full
+t0 ${rand_t0[$i]}
+ncolor ${nrand_source}
+momentum 0 0 0
+source_label ${rand_label[$i]}
+forget_source
+EOF
+
+done
+
+cat <<EOF
+
+# Description of completed sources
+
+number_of_modified_sources 0
+
+
+# Description of propagators
+
+number_of_sets ${nsets}
+EOF
+
+# One set and one propagator per source
+
+for ((i=0; i<${nsets}; i++)); do
+
+cat <<EOF
+
+# Parameters for set ${i}
+# ${set_comment[$i]}
+
+set_type multimass
+max_cg_iterations ${max_cg_iterations}
+max_cg_restarts 5
+check yes
+momentum_twist 0 0 0
+precision ${precision}
+
+source ${i}
+
+number_of_propagators 1
+
+# propagator ${i}
+
+mass ${mass}
+${naik_cmd}
+inv_type MG
+mg_param_file ${mg_param_file}
+error_for_propagator ${error_for_propagator[$i]}
+rel_error_for_propagator ${rel_error_for_propagator[$i]}
+
+fresh_ksprop
+forget_ksprop
+EOF
+
+done
+
+######################################################################
+# Definition of quarks
+
+cat <<EOF
+
+number_of_quarks ${nsets}
+
+EOF
+
+for ((i=0; i<${nsets}; i++)); do
+
+cat <<EOF
+
+# source ${rand_label[$i]}
+
+propagator ${i}
+
+identity
+op_label d
+forget_ksprop
+
+EOF
+
+done
+
+######################################################################
+# Specification of Mesons
+
+cat <<EOF
+# Description of mesons
+
+number_of_mesons ${nsets}
+EOF
+
+for ((i=0; i<${nsets}; i++)); do
+
+cat <<EOF
+
+# pair ${i} (source ${rand_label[$i]} PP)
+
+pair ${i} ${i}
+spectrum_request meson
+
+save_corr_fnal ${corrfilet}
+r_offset 0 0 0 ${rand_t0[$i]}
+
+number_of_correlators 1
+
+# Normalization is 1/[3*(vol3)^2]
+
+correlator POINT_KAON_5 p000  1 * ${ppnorm} pion5  0 0 0 E E E
+EOF
+
+done
+
+cat <<EOF
+
+
+# Description of baryons
+
+number_of_baryons 0
+EOF
@@ -0,0 +1,225 @@
+#! /bin/bash
+
+# One mass and several sources, solved together with the block CG
+# (set_type multisource).  Random color wall sources at each rand_t0
+# plus one even-and-odd wall source at wall_t0.
+
+paramfile=$1
+
+if [ $# -lt 1 ]
+then
+    echo "Usage $0 <paramfile>"
+    exit 1
+fi
+
+source $paramfile
+
+nrand=${#rand_t0[@]}
+nsrc=$[${nrand}+1]
+corrfilet=${corrfile}_t${wall_t0}.test-out
+
+case $action in
+hisq)
+  naik_cmd="naik_term_epsilon ${naik_term_epsilon}"
+;;
+asqtad)
+  naik_cmd=""
+;;
+esac
+
+cat <<EOF
+prompt 0
+nx ${nx}
+ny ${ny}
+nz ${nz}
+nt ${nt}
+iseed ${iseed}
+job_id ${jobid}
+
+######################################################################
+# source time ${wall_t0}
+######################################################################
+
+# Gauge field description
+
+reload_serial ${inlat}
+u0 ${u0}
+coulomb_gauge_fix
+forget
+staple_weight 0
+ape_iter 0
+coordinate_origin 0 0 0 0
+time_bc antiperiodic
+
+# Eigenpairs
+
+max_number_of_eigenpairs 0
+
+# Chiral condensate and related measurements
+
+number_of_pbp_masses 0
+
+# Description of base sources
+
+number_of_base_sources ${nsrc}
+EOF
+
+for ((i=0; i<${nrand}; i++)); do
+
+cat <<EOF
+
+# base source ${i}
+
+random_color_wall
+field_type KS
+subset full
+t0 ${rand_t0[$i]}
+ncolor ${nrand_source}
+momentum 0 0 0
+source_label ${rand_label[$i]}
+forget_source
+EOF
+
+done
+
+cat <<EOF
+
+# base source ${nrand}
+
+evenandodd_wall
+field_type KS
+subset full
+t0 ${wall_t0}
+source_label ${wall_label}
+forget_source
+
+# Description of completed sources
+
+number_of_modified_sources 0
+
+
+# Description of propagators
+
+number_of_sets 1
+
+# Parameters for set 0
+# One mass, three sources, solved together with the block CG
+
+set_type multisource
+max_cg_iterations ${max_cg_iterations}
+max_cg_restarts 5
+check yes
+momentum_twist 0 0 0
+precision ${precision}
+
+mass ${mass}
+${naik_cmd}
+
+number_of_propagators ${nsrc}
+EOF
+
+# One propagator per source, all with the same mass
+
+for ((s=0; s<${nsrc}; s++)); do
+
+cat <<EOF
+
+# propagator ${s}
+
+source ${s}
+error_for_propagator ${error_for_propagator}
+rel_error_for_propagator 0
+
+fresh_ksprop
+forget_ksprop
+
+EOF
+
+done
+
+######################################################################
+# Definition of quarks
+
+cat <<EOF
+
+number_of_quarks ${nsrc}
+
+EOF
+
+for ((s=0; s<${nsrc}; s++)); do
+
+if [ ${s} -lt ${nrand} ]
+then
+  label=${rand_label[$s]}
+else
+  label=${wall_label}
+fi
+
+cat <<EOF
+
+# source ${label}
+
+propagator ${s}
+
+identity
+op_label d
+forget_ksprop
+
+EOF
+
+done
+
+######################################################################
+# Specification of Mesons
+
+cat <<EOF
+# Description of mesons
+
+number_of_mesons ${nsrc}
+
+EOF
+
+for ((s=0; s<${nsrc}; s++)); do
+
+if [ ${s} -lt ${nrand} ]
+then
+  label=${rand_label[$s]}
+  t0=${rand_t0[$s]}
+  snk="PP"
+  norm=${ppnorm}
+  normcmt="1/[3*(vol3)^2]"
+else
+  label=${wall_label}
+  t0=${wall_t0}
+  snk="WP"
+  norm=${wpnorm}
+  normcmt="4/[3*(vol3)^2]"
+fi
+
+cat <<EOF
+
+# pair ${s} (source ${label} ${snk})
+
+pair ${s} ${s}
+spectrum_request meson
+
+save_corr_fnal ${corrfilet}
+r_offset 0 0 0 ${t0}
+
+number_of_correlators 1
+
+# Normalization is ${normcmt}
+
+correlator POINT_KAON_5 p000  1 * ${norm} pion5  0 0 0 E E E
+EOF
+
+done
+
+cat <<EOF
+
+
+# Description of baryons
+
+number_of_baryons 0
+
+EOF